@@ -0,0 +1,81 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Startable.h"
+#include "Mona/TaskHandler.h"
+#include "Mona/HostEntry.h"
+#include <functional>
+#include <deque>
+#include <map>
+#include <vector>
+
+namespace Mona {
+
+/// \class Non-blocking host name resolution: getaddrinfo is called by a dedicated thread,
+/// results are cached (negative answers included) and hosts file entries are answered first.
+/// The callback is called immediately for IP addresses, hosts entries and cached results,
+/// otherwise later by the handler thread (or by the resolver thread without handler)
+class DNSResolver : private Startable, virtual Object {
+public:
+	typedef std::function<void(const Exception& ex, const HostEntry& host)> OnResolved;
+
+	DNSResolver();
+	DNSResolver(TaskHandler& handler);
+	virtual ~DNSResolver();
+
+	bool	start(Exception& ex);
+	/// \brief callbacks waiting a result are released without being called
+	void	stop();
+	bool	running() const { return Startable::running(); }
+	void	setAffinity(const std::vector<UInt16>& processors) { Startable::setAffinity(processors); }
+
+	/// \brief getaddrinfo doesn't return the TTL of records, so cached results expire after these delays in seconds (0 to not cache)
+	void	setTTL(UInt32 positive, UInt32 negative);
+	/// \brief loads a hosts file ("address name [aliases]" lines), its entries never expire
+	bool	loadHosts(Exception& ex, const std::string& path);
+	void	addHost(const std::string& name, const IPAddress& address);
+
+	/// \brief returns true if the callback has been called immediately
+	bool	resolve(const std::string& host, const OnResolved& onResolved);
+
+	UInt32	cached();
+	void	clearCache();
+
+private:
+	class Entry;
+	class Resolution;
+
+	void	run(Exception& ex);
+	void	purge(Int64 now);
+
+	TaskHandler*											_pHandler;
+	std::mutex												_mutex;
+	Int64													_positiveTTL;
+	Int64													_negativeTTL;
+	std::map<std::string, std::shared_ptr<HostEntry>>		_hosts;
+	std::map<std::string, std::shared_ptr<const Entry>>		_cache;
+	std::map<std::string, std::vector<OnResolved>>			_waitings;
+	std::deque<std::string>									_queries;
+};
+
+
+} // namespace Mona
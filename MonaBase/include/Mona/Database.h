@@ -45,6 +45,7 @@ public:
 
 	void flush() { stop(); }
 	bool writing() { return running(); }
+	void setAffinity(const std::vector<UInt16>& processors) { Startable::setAffinity(processors); }
 
 private:
 	class Entry : virtual Object {
@@ -22,6 +22,7 @@ This file is a part of Mona.
 #include "Mona/Mona.h"
 #include "Mona/String.h"
 #include <map>
+#include <stdexcept>
 #include "assert.h"
 
 namespace Mona {
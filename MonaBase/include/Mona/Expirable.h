@@ -22,61 +22,94 @@ This file is a part of Mona.
 
 #include "Mona/Mona.h"
 #include "Mona/Exceptions.h"
+#include "Mona/PoolObjects.h"
 #include <memory>
-#include <mutex>
 #include <atomic>
+#include <thread>
 
 
 namespace Mona {
 
+/// Shares an object with other threads which can check its expiration without mutex:
+/// a reader registers itself in the shared state (safeThis), and expire() waits the end of the current readers
 template<typename ObjectType>
 class Expirable : virtual Object {
+	struct State : virtual Object {
+		State() : users(0), expired(false) {}
+		std::atomic<Int32>	users; // readers between safeThis and the release of their Lock
+		std::atomic<bool>	expired;
+	};
 public:
+	/// Keeps the object alive while it is used by an other thread, released on destruction
+	class Lock : virtual Object {
+		friend class Expirable;
+	public:
+		Lock() : _pState(NULL) {}
+		virtual ~Lock() { release(); }
+
+		void release() {
+			if (!_pState)
+				return;
+			_pState->users.fetch_sub(1, std::memory_order_release);
+			_pState = NULL;
+		}
+	private:
+		State*	_pState;
+	};
+
 	Expirable() : _pOwner(NULL), _isOwner(false) {}
 
 	virtual ~Expirable() {
 		if (_isOwner)
-			FATAL_ASSERT(*_pExpired);
+			FATAL_ASSERT(_pState->expired);
 	}
 
 	bool isOwner() const { return _isOwner; }
 
-	ObjectType* safeThis(std::unique_lock<std::mutex>& guard) {
+	ObjectType* safeThis(Lock& lock) {
 		if (!_pOwner)
 			return NULL;
-		if (!_isOwner)
-			guard = std::unique_lock<std::mutex>(*_pMutex);
-		return *_pExpired ? NULL : _pOwner;
+		if (_isOwner)
+			return _pState->expired ? NULL : _pOwner;
+		lock.release();
+		// sequentially consistent with expire(): either the reader sees the expiration or expire() sees the reader
+		_pState->users.fetch_add(1);
+		if (_pState->expired) {
+			_pState->users.fetch_sub(1, std::memory_order_release);
+			return NULL;
+		}
+		lock._pState = _pState.get();
+		return _pOwner;
 	}
 
 	ObjectType* unsafeThis() {
 		if (!_pOwner)
 			return NULL;
-		return *_pExpired ? NULL : _pOwner;
+		return _pState->expired ? NULL : _pOwner;
 	}
 
 	void shareThis(Expirable& other) {
 		FATAL_ASSERT(other._isOwner == false)
 		other._pOwner = _pOwner;
-		other._pMutex = _pMutex;
-		other._pExpired = _pExpired;
+		other._pState = _pState;
 	}
 
 	void expire() {
-		if (!_isOwner || *_pExpired)
+		if (!_isOwner || _pState->expired)
 			return;
-		std::lock_guard<std::mutex> lock(*_pMutex);
-		*_pExpired = true;
+		_pState->expired = true;
+		// waits the readers which have got the object before its expiration
+		while (_pState->users.load(std::memory_order_acquire))
+			std::this_thread::yield();
 	}
 
 	
 protected:
-	Expirable(ObjectType* pThis) : _isOwner(true), _pMutex(new std::mutex()), _pOwner(pThis), _pExpired(new std::atomic<bool>(false)) {}
+	Expirable(ObjectType* pThis) : _isOwner(true), _pState(PoolObjects::New<State>()), _pOwner(pThis) {}
 
 	
 private:
-	std::shared_ptr<std::mutex>			_pMutex;
-	std::shared_ptr<std::atomic<bool>>	_pExpired;
+	std::shared_ptr<State>				_pState;
 	ObjectType*							_pOwner;
 	bool								_isOwner;
 };
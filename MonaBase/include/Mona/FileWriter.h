@@ -0,0 +1,106 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#pragma once
+
+#include "Mona/Startable.h"
+#include "Mona/Exceptions.h"
+#include "Mona/PoolBuffer.h"
+#include "Mona/Time.h"
+#include <deque>
+#include <memory>
+
+namespace Mona {
+
+/// Writes files on a dedicated thread: callers queue buffers and never wait for the disk,
+/// the queue is bounded in bytes and the writings beyond are refused.
+/// The thread starts on the first file opened, and stop() writes what is queued before to return
+class FileWriter : private Startable, virtual Object {
+public:
+	enum Sync {
+		SYNC_NEVER=0,	// the system writes back the data when it wants
+		SYNC_CLOSE,		// fsync on close
+		SYNC_PERIODIC,	// fsync every period of the files written since, and on close
+		SYNC_ALWAYS		// fsync after every writing
+	};
+
+	class File;
+
+	FileWriter(const PoolBuffers& poolBuffers, const char* name = "FileWriter");
+	virtual ~FileWriter() { stop(); }
+
+	/// maximum of bytes waiting to be written (0 for no limit)
+	void					setQueueing(UInt32 maximum) { _maximum = maximum; }
+	/// period in ms for SYNC_PERIODIC
+	void					setSync(Sync sync, UInt32 period = 1000) { _sync = sync; _period = period; }
+	void					setAffinity(const std::vector<UInt16>& processors) { Startable::setAffinity(processors); }
+
+	/// Open asynchronously the file (and its directories), at its end if append, otherwise truncated
+	std::shared_ptr<File>	open(Exception& ex, const std::string& path, bool append = false);
+	/// Queue the buffer (taken) to write it at the end of the file, false if the queue is full or the file has failed
+	bool					write(const std::shared_ptr<File>& pFile, PoolBuffer& pBuffer);
+	void					close(const std::shared_ptr<File>& pFile);
+
+	UInt32					queueing() const { return _queueing; }
+	// buffers refused because the queue was full
+	UInt32					dropped() const { return _dropped; }
+
+	void					stop();
+
+private:
+	void					run(Exception& ex);
+	bool					push(const std::shared_ptr<File>& pFile, PoolBuffer* pBuffer, bool close);
+
+	class Operation : virtual Object {
+	public:
+		Operation(const std::shared_ptr<File>& pFile, const PoolBuffers& poolBuffers, bool close) : pFile(pFile), pBuffer(poolBuffers), close(close) {}
+		std::shared_ptr<File>	pFile;
+		PoolBuffer				pBuffer;
+		bool					close;
+	};
+
+	const PoolBuffers&		_poolBuffers;
+	std::mutex				_mutex;
+	std::deque<Operation>	_operations;
+	volatile UInt32			_queueing;
+	volatile UInt32			_dropped;
+	UInt32					_maximum;
+	Sync					_sync;
+	UInt32					_period;
+};
+
+class FileWriter::File : virtual Object {
+	friend class FileWriter;
+public:
+	File(const std::string& path, bool append) : path(path), _append(append), _pFile(NULL), _failed(false), _written(false) {}
+	virtual ~File();
+
+	const std::string	path;
+	// true if a writing has failed (the error is logged), next buffers are ignored
+	bool				failed() const { return _failed; }
+
+private:
+	bool				_append;
+	FILE*				_pFile;
+	volatile bool		_failed;
+	bool				_written; // since the last fsync
+};
+
+
+} // namespace Mona
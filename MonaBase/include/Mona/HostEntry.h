@@ -36,6 +36,8 @@ public:
 	
 	// Creates an empty HostEntry.
 	HostEntry() {}
+	// Creates a HostEntry without address, to fill with addAlias and addAddress (entry of a hosts file for example)
+	HostEntry(const std::string& name) : _name(name) {}
 
 	// Creates the HostEntry from the data in a hostent structure.
 	void set(Exception& ex, const struct hostent* entry);
@@ -51,6 +53,9 @@ public:
 	// Returns a vector containing the IPAddresses for the host
 	const AddressList& addresses() const { return _addresses;}
 
+	void addAlias(const std::string& alias) { _aliases.emplace_back(alias); }
+	void addAddress(const IPAddress& address) { _addresses.emplace_back(address); }
+
 private:
 	std::string _name;
 	AliasList   _aliases;
@@ -0,0 +1,111 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include <atomic>
+
+namespace Mona {
+
+/// Bounded lock-free queue with multiple producers and multiple consumers (Vyukov algorithm)
+/// capacity is rounded up to a power of two, push returns false when the queue is full
+template<typename Type>
+class MPMCQueue : virtual Object {
+public:
+	MPMCQueue(UInt32 capacity) : capacity(RoundCapacity(capacity)), _pushPosition(0), _popPosition(0) {
+		_cells = new Cell[this->capacity];
+		for (UInt32 i = 0; i < this->capacity; ++i)
+			_cells[i].sequence.store(i, std::memory_order_relaxed);
+	}
+	virtual ~MPMCQueue() { delete [] _cells; }
+
+	const UInt32	capacity;
+
+	// approximative when producers or consumers are working meanwhile
+	UInt32			size() const { Int32 size(_pushPosition.load(std::memory_order_relaxed) - _popPosition.load(std::memory_order_relaxed)); return size > 0 ? size : 0; }
+	bool			empty() const { return size() == 0; }
+
+	// can be called by any thread, never blocks
+	bool push(const Type& value) {
+		Cell* pCell;
+		UInt32 position(_pushPosition.load(std::memory_order_relaxed));
+		for (;;) {
+			pCell = &_cells[position & (capacity - 1)];
+			Int32 delta(pCell->sequence.load(std::memory_order_acquire) - position);
+			if (delta == 0) {
+				if (_pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					break;
+			} else if (delta < 0)
+				return false; // full
+			else
+				position = _pushPosition.load(std::memory_order_relaxed);
+		}
+		pCell->value = value;
+		pCell->sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	// can be called by any thread, never blocks
+	bool pop(Type& value) {
+		Cell* pCell;
+		UInt32 position(_popPosition.load(std::memory_order_relaxed));
+		for (;;) {
+			pCell = &_cells[position & (capacity - 1)];
+			Int32 delta(pCell->sequence.load(std::memory_order_acquire) - (position + 1));
+			if (delta == 0) {
+				if (_popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+					break;
+			} else if (delta < 0)
+				return false; // empty
+			else
+				position = _popPosition.load(std::memory_order_relaxed);
+		}
+		value = std::move(pCell->value);
+		pCell->value = Type();
+		pCell->sequence.store(position + capacity, std::memory_order_release);
+		return true;
+	}
+
+	void clear() {
+		Type value;
+		while (pop(value))
+			value = Type();
+	}
+
+private:
+	static UInt32 RoundCapacity(UInt32 capacity) {
+		UInt32 result(2);
+		while (result < capacity)
+			result <<= 1;
+		return result;
+	}
+
+	struct Cell {
+		std::atomic<UInt32>	sequence;
+		Type				value;
+	};
+
+	Cell*					_cells;
+	std::atomic<UInt32>		_pushPosition;
+	std::atomic<UInt32>		_popPosition;
+};
+
+
+} // namespace Mona
@@ -0,0 +1,111 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/MPMCQueue.h"
+#include <atomic>
+
+namespace Mona {
+
+/// Lock-free queue with multiple producers and one consumer (intrusive-less Vyukov algorithm)
+/// capacity bounds the number of queued elements (0 means unbounded), push returns false when the queue is full
+/// Nodes popped are recycled for the next pushes (until cachedNodes, NODES_CACHE by default which fits the small queues by session),
+/// so the heap is used just to grow the queue
+template<typename Type>
+class MPSCQueue : virtual Object {
+public:
+	enum { NODES_CACHE = 16 };
+
+	MPSCQueue(UInt32 capacity = 0, UInt32 cachedNodes = NODES_CACHE) : capacity(capacity), _size(0), _pTail(new Node()), _nodes(capacity && capacity<cachedNodes ? capacity : cachedNodes) { _pHead = _pTail; }
+	virtual ~MPSCQueue() {
+		clear();
+		delete _pTail;
+		Node* pNode;
+		while (_nodes.pop(pNode))
+			delete pNode;
+	}
+
+	const UInt32	capacity;
+
+	UInt32			size() const { return _size; }
+	bool			empty() const { return _size == 0; }
+
+	// can be called by any thread, never blocks
+	// previousSize is the size of the queue before this push (if 0 the consumer can be sleeping)
+	bool push(const Type& value, UInt32* pPreviousSize = NULL) {
+		UInt32 previousSize(_size++);
+		if (capacity && previousSize >= capacity) {
+			--_size;
+			return false;
+		}
+		if (pPreviousSize)
+			*pPreviousSize = previousSize;
+		Node* pNode;
+		if (_nodes.pop(pNode)) {
+			pNode->value = value;
+			pNode->pNext.store(NULL, std::memory_order_relaxed);
+		} else
+			pNode = new Node(value);
+		// link the new node at the head, the consumer sees it as soon as pNext of the previous head is set
+		_pHead.exchange(pNode, std::memory_order_acq_rel)->pNext.store(pNode, std::memory_order_release);
+		return true;
+	}
+
+	// must be called always by the same thread (the consumer)
+	// can return false whereas size()>0 if a producer is pushing the next element
+	bool pop(Type& value) {
+		Node* pNext(_pTail->pNext.load(std::memory_order_acquire));
+		if (!pNext)
+			return false;
+		value = std::move(pNext->value);
+		pNext->value = Type();
+		// pNext of the previous tail has been written, so no producer references it anymore
+		if (!_nodes.push(_pTail))
+			delete _pTail;
+		_pTail = pNext; // becomes the new empty node
+		--_size;
+		return true;
+	}
+
+	// consumer side
+	void clear() {
+		Type value;
+		while (pop(value))
+			value = Type();
+	}
+
+private:
+	struct Node {
+		Node() : pNext(NULL) {}
+		Node(const Type& value) : value(value), pNext(NULL) {}
+
+		Type				value;
+		std::atomic<Node*>	pNext;
+	};
+
+	std::atomic<UInt32>		_size;
+	std::atomic<Node*>		_pHead; // producers side
+	Node*					_pTail; // consumer side
+	MPMCQueue<Node*>		_nodes; // recycled, pushed by the consumer and popped by the producers
+};
+
+
+} // namespace Mona
@@ -0,0 +1,59 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Exceptions.h"
+
+namespace Mona {
+
+/// Maps a file in memory: an existing file in read-only,
+/// or a file created with a fixed size and written through the memory (the system writes the pages back to the disk)
+class MappedFile : virtual Object {
+public:
+	MappedFile();
+	virtual ~MappedFile() { close(); }
+
+	/// size=0 maps the existing file in read-only, otherwise the file is created (or truncated) to size bytes and mapped writable
+	bool				open(Exception& ex, const std::string& path, UInt32 size = 0);
+	void				close();
+
+	bool				opened() const { return _data != NULL; }
+	bool				writable() const { return _writable; }
+	const std::string&	path() const { return _path; }
+
+	UInt8*				data() const { return _data; }
+	UInt32				size() const { return _size; }
+
+private:
+	UInt8*				_data;
+	UInt32				_size;
+	bool				_writable;
+	std::string			_path;
+#if defined(_WIN32)
+	void*				_file;
+	void*				_mapping;
+#else
+	int					_file;
+#endif
+};
+
+
+} // namespace Mona
@@ -21,11 +21,12 @@ This file is a part of Mona.
 
 #include "Mona/Mona.h"
 #include "Mona/PoolBuffers.h"
+#include "Mona/PoolObjects.h"
 
 
 namespace Mona {
 
-class PoolBuffer : virtual Object {
+class PoolBuffer : public PoolObject<PoolBuffer>, virtual Object {
 public:
 	PoolBuffer(const PoolBuffers& poolBuffers,UInt32 size=0) : _size(size),poolBuffers(poolBuffers),_pBuffer(NULL) {}
 	virtual ~PoolBuffer() { release(); }
@@ -22,29 +22,64 @@ This file is a part of Mona.
 #include "Mona/Mona.h"
 #include "Mona/Buffer.h"
 #include "Mona/Time.h"
-#include <deque>
+#include <vector>
 #include <mutex>
 
 namespace Mona {
 
+/// Buffers are kept by size class (256B, 1.5KB, 4KB, 16KB and 64KB) to be reused:
+/// magazines (a stack of buffers by class) are grouped in stripes, each one locked by its own mutex, and a thread uses the stripe
+/// selected by the hash of its id (two times more stripes than processors, so threads rarely share a stripe). Magazines are exchanged full with a depot.
+/// On NUMA systems stripes and depots are by node, a thread uses those of the node where it runs
+/// to get buffers allocated (first touched) by its node
 class PoolBuffers : virtual Object {
 	friend class PoolBuffer;
 public:
-	PoolBuffers(UInt16 maximumCapacity = 32768);
+	PoolBuffers(UInt32 maximumCapacity = 65536);
 	virtual ~PoolBuffers();
 
-	void clear() { clear(false); }
+	// On trim, the magazines of the depot not used during delay ms are freed (0 to never trim),
+	// and the depot never keeps more than maximum buffers by size class (0 for no limit)
+	void	setTrimming(UInt32 delay, UInt32 maximum = 0);
+	// To call regularly, frees the depot surplus at most one time by delay
+	void	trim();
+
+	// idle buffers
+	UInt32	available() const;
+
+	void	clear();
 
 private:
-	void		clear(bool deleting);
 	Buffer*		beginBuffer(UInt32 size=0) const;
 	void		endBuffer(Buffer* pBuffer) const;
 
-				
-	mutable std::deque<Buffer*>	_buffers;
-	mutable std::mutex			_mutex;
-	UInt16						_maximumCapacity;
-	mutable Time				_lastEmptyTime;
+	enum {
+		CLASSES = 5,
+		MAGAZINE_SIZE = 32
+	};
+	static const UInt32 _ClassSizes[CLASSES];
+
+	struct Stripe {
+		std::mutex				mutex;
+		std::vector<Buffer*>	magazines[CLASSES]; // until 2 magazines by class, to avoid a depot exchange on every limit crossing
+	};
+	struct Depot {
+		Depot() : idle(0) {}
+		std::mutex							mutex;
+		std::vector<std::vector<Buffer*>>	magazines; // full magazines, reloaded from the back
+		size_t								idle; // lowest number of magazines since the last trimming, the first ones have not been used meanwhile
+		Time								lastTrim;
+	};
+
+	Stripe&		stripe(UInt16& node) const;
+
+	UInt8					_classes; // classes used, according to the maximum capacity
+	UInt16					_nodes;
+	UInt32					_stripesSize; // by node
+	Stripe*					_stripes;
+	Depot*					_depots; // CLASSES by node
+	UInt32					_trimDelay;
+	UInt32					_trimMaximum;
 };
 
 
@@ -0,0 +1,138 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/MPMCQueue.h"
+#include <memory>
+#include <new>
+#include <cstdlib>
+
+#if defined(_WIN32) && defined(_DEBUG)
+	#pragma push_macro("new")
+	#undef new // debug new of Mona.h, redefined at the end of this file
+#endif
+
+namespace Mona {
+
+/// Recycles the memory of the objects allocated per message (senders, messages, decodings...), to remove malloc of the hot paths
+/// Each type has its own lock-free list of free blocks, bounded to CAPACITY blocks (beyond blocks go back to the heap)
+class PoolObjects : virtual Static {
+public:
+	enum { CAPACITY = 1024 };
+
+	// blocks taken on the heap, and recycled from a pool, since the start
+	static UInt64	Allocations() { return _Allocations.load(std::memory_order_relaxed); }
+	static UInt64	Recyclings() { return _Recyclings.load(std::memory_order_relaxed); }
+
+	// shared_ptr where the object and its counters are in one recycled block
+	template<typename Type, typename ...Args>
+	static std::shared_ptr<Type>	New(Args&&... args);
+
+	template<typename Type>
+	static void* Allocate(std::size_t size) {
+		void* pBlock;
+		if (size == sizeof(Type) && Blocks<Type>::PFree && Blocks<Type>::PFree->pop(pBlock)) {
+			_Recyclings.fetch_add(1, std::memory_order_relaxed);
+			return pBlock;
+		}
+		_Allocations.fetch_add(1, std::memory_order_relaxed);
+		if (!(pBlock = std::malloc(size)))
+			throw std::bad_alloc();
+		return pBlock;
+	}
+
+	template<typename Type>
+	static void Release(void* pBlock, std::size_t size) {
+		if (!pBlock)
+			return;
+		if (size != sizeof(Type) || !Blocks<Type>::PFree || !Blocks<Type>::PFree->push(pBlock))
+			std::free(pBlock);
+	}
+
+private:
+	template<typename Type>
+	struct Blocks : MPMCQueue<void*> {
+		Blocks() : MPMCQueue<void*>(CAPACITY) {}
+		// never deleted, blocks can be released until the end of the process
+		static Blocks* const PFree;
+	};
+
+	static std::atomic<UInt64>	_Allocations;
+	static std::atomic<UInt64>	_Recyclings;
+};
+
+template<typename Type>
+PoolObjects::Blocks<Type>* const PoolObjects::Blocks<Type>::PFree(new PoolObjects::Blocks<Type>());
+
+
+/// Allocator of PoolObjects, to use with std::allocate_shared (see PoolObjects::New)
+template<typename Type>
+class PoolAllocator {
+public:
+	typedef Type			value_type;
+	typedef Type*			pointer;
+	typedef const Type*		const_pointer;
+	typedef Type&			reference;
+	typedef const Type&		const_reference;
+	typedef std::size_t		size_type;
+	typedef std::ptrdiff_t	difference_type;
+	template<typename Other>
+	struct rebind { typedef PoolAllocator<Other> other; };
+
+	PoolAllocator() {}
+	template<typename Other>
+	PoolAllocator(const PoolAllocator<Other>& other) {}
+
+	Type*	allocate(std::size_t count) { return (Type*)PoolObjects::Allocate<Type>(count*sizeof(Type)); }
+	void	deallocate(Type* pObject, std::size_t count) { PoolObjects::Release<Type>(pObject, count*sizeof(Type)); }
+
+	template<typename Other>
+	bool operator==(const PoolAllocator<Other>& other) const { return true; }
+	template<typename Other>
+	bool operator!=(const PoolAllocator<Other>& other) const { return false; }
+};
+
+template<typename Type, typename ...Args>
+inline std::shared_ptr<Type> PoolObjects::New(Args&&... args) {
+	return std::allocate_shared<Type>(PoolAllocator<Type>(), std::forward<Args>(args)...);
+}
+
+
+/// Inherit of PoolObject<Type> to recycle the memory of a class allocated with new
+/// A derived class of a different size is allocated on the heap as usual
+template<typename Type>
+class PoolObject {
+public:
+	static void* operator new(std::size_t size) { return PoolObjects::Allocate<Type>(size); }
+	static void	 operator delete(void* pObject, std::size_t size) { PoolObjects::Release<Type>(pObject, size); }
+#if defined(_WIN32) && defined(_DEBUG)
+	// debug new of Mona.h
+	static void* operator new(std::size_t size, int blockUse, const char* file, int line) { return PoolObjects::Allocate<Type>(size); }
+	static void	 operator delete(void* pObject, int blockUse, const char* file, int line) { std::free(pObject); }
+#endif
+};
+
+
+} // namespace Mona
+
+#if defined(_WIN32) && defined(_DEBUG)
+	#pragma pop_macro("new")
+#endif
@@ -21,35 +21,41 @@ This file is a part of Mona.
 
 #include "Mona/Mona.h"
 #include "Mona/Startable.h"
-#include "Mona/WorkThread.h"
-#include <memory>
-#include <deque>
+#include "Mona/PoolThreads.h"
+#include "Mona/MPMCQueue.h"
 
 
 namespace Mona {
 
 class PoolThread : private Startable, virtual Object {
+	friend class PoolThreads;
 public:
-	PoolThread() : Startable("PoolThread" + std::to_string(++_Id)) {}
+	PoolThread(PoolThreads& pool) : Startable("PoolThread" + std::to_string(++_Id)), _pool(pool), _jobs(1024), _working(false), _executed(0), _stolen(0) {}
 	virtual ~PoolThread() {join();	}
 
 	void	join() { stop(); }
 
-	template<typename WorkThreadType>
-	void push(Exception& ex,const std::shared_ptr<WorkThreadType>& pWork) {
-		std::lock_guard<std::mutex> lock(_mutex);
-		if (!running() && !start(ex))
-			return;
-		_jobs.emplace_back(pWork);
-		wakeUp();
-	}
+	// jobs waiting in the queue of this thread
+	UInt32	queueing() const { return _jobs.size(); }
+	UInt64	executed() const { return _executed; }
+	// jobs taken in the queue of an other thread
+	UInt64	stolen() const { return _stolen; }
+
 private:
 	void	run(Exception& ex);
+	void	execute(WorkThread& work);
+
+	bool	wakeUp(Exception& ex);
+	bool	working() const { return _working; }
 
-	std::mutex								_mutex;
-	std::deque<std::shared_ptr<WorkThread>>	_jobs;
+	PoolThreads&					_pool;
+	MPMCQueue<PoolThreads::Job>		_jobs;
+	std::mutex						_mutex;
+	std::atomic<bool>				_working;
+	std::atomic<UInt64>				_executed;
+	std::atomic<UInt64>				_stolen;
 	
-	static UInt32							_Id;
+	static UInt32					_Id;
 
 };
 
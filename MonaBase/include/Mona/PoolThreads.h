@@ -20,39 +20,83 @@ This file is a part of Mona.
 #pragma once
 
 #include "Mona/Mona.h"
-#include "Mona/PoolThread.h"
-#include "Mona/Util.h"
+#include "Mona/WorkThread.h"
+#include "Mona/MPSCQueue.h"
+#include <vector>
 #include <deque>
+#include <mutex>
+#include <memory>
 
 namespace Mona {
 
+class PoolThread;
 class PoolThreads : virtual Object {
+	friend class PoolThread;
+	class Ordering;
 public:
-	PoolThreads(UInt16 threadsAvailable=0) {
-		if (threadsAvailable == 0)
-			threadsAvailable = Util::ProcessorCount();
-		for(UInt16 i=0;i<threadsAvailable;++i) _threads.emplace_back(new PoolThread());
-	}
-	virtual ~PoolThreads() {
-		for(PoolThread* pThread : _threads) delete pThread;
-	}
+	/// Keeps an order of execution between works (those of a session or of a socket for example):
+	/// they run one after the other, on any thread of the pool but preferably on the last one used
+	class Queue : virtual Object {
+		friend class PoolThreads;
+	public:
+		// works enqueued and not yet finished
+		UInt32	size() const;
+	private:
+		std::shared_ptr<Ordering>	_pOrdering;
+	};
+
+	PoolThreads(UInt16 threadsAvailable=0);
+	virtual ~PoolThreads();
 
-	void	join() { for(PoolThread* pThread : _threads) pThread->join(); }
+	void	join();
 	UInt32	threadsAvailable() const { return _threads.size(); }
+	// binds each thread to one of these processors in turn (empty to unbind), applied on the next start of the threads
+	void	setAffinity(const std::vector<UInt16>& processors);
 
+	// works waiting a thread
+	UInt32	queueing() const;
+	UInt64	executed() const;
+	// works executed by an other thread that the one which has received them
+	UInt64	stolen() const;
+
+	// without pQueue the work can run on any thread, in any order
 	template<typename WorkThreadType>
-    PoolThread* enqueue(Exception& ex, const std::shared_ptr<WorkThreadType>& pWork, PoolThread* pThread = NULL) {
-		if (!pThread) {
-			pThread = _threads.front();
-			_threads.pop_front();
-			_threads.emplace_back(pThread);
-		}
-		pThread->push<WorkThreadType>(ex, pWork);
-		return pThread;
+	bool enqueue(Exception& ex, const std::shared_ptr<WorkThreadType>& pWork, Queue* pQueue = NULL) {
+		return enqueue(ex, std::shared_ptr<WorkThread>(pWork), pQueue);
 	}
 
 private:
-	std::deque<PoolThread*>	_threads;
+	class Ordering : virtual Object {
+	public:
+		Ordering() : pending(0), pThread(NULL) {}
+
+		MPSCQueue<std::shared_ptr<WorkThread>>	works;
+		std::atomic<UInt32>						pending;
+		std::atomic<PoolThread*>				pThread; // last thread used (affinity)
+	};
+
+	struct Job {
+		Job() {}
+		Job(const std::shared_ptr<WorkThread>& pWork) : pWork(pWork) {}
+		Job(const std::shared_ptr<Ordering>& pOrdering) : pOrdering(pOrdering) {}
+
+		std::shared_ptr<WorkThread>	pWork;
+		std::shared_ptr<Ordering>	pOrdering; // if set, the job is to run the next work of this ordering
+	};
+
+	bool	enqueue(Exception& ex, const std::shared_ptr<WorkThread>& pWork, Queue* pQueue);
+	// push the job in the queue of pThread (or the next thread if NULL), and wake up an idle thread if pThread is busy
+	bool	push(Exception& ex, const Job& job, PoolThread* pThread = NULL);
+	// take a job in the queue of an other thread
+	bool	steal(PoolThread& thief, Job& job);
+
+	std::vector<PoolThread*>	_threads;
+	std::atomic<UInt32>			_next;
+
+	// jobs which have not found place in the queue of their thread
+	std::mutex					_mutexOverflow;
+	std::deque<Job>				_overflow;
+	std::atomic<UInt32>			_overflowSize;
 };
 
 
@@ -0,0 +1,86 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/PoolBuffer.h"
+#include <memory>
+
+
+namespace Mona {
+
+/// Immutable slice of a buffer shared between several owners, to give a same content to many receivers without copy.
+/// The memory goes back to its PoolBuffers (or its owner is deleted) when the last reference is released
+class SharedBuffer : virtual NullableObject {
+public:
+	SharedBuffer() : _data(NULL), _size(0) {} // NULL
+	SharedBuffer(const SharedBuffer& other) : _pOwner(other._pOwner), _data(other._data), _size(other._size) {}
+	// takes the content of buffer, without copy
+	explicit SharedBuffer(PoolBuffer& buffer) : _data(NULL), _size(0) {
+		std::shared_ptr<PoolBuffer> pBuffer(new PoolBuffer(buffer.poolBuffers));
+		pBuffer->swap(buffer);
+		_pOwner = pBuffer;
+		if (pBuffer->empty())
+			return;
+		_data = (*pBuffer)->data();
+		_size = (*pBuffer)->size();
+	}
+	// copies data, one time for all the owners
+	SharedBuffer(const PoolBuffers& poolBuffers, const UInt8* data, UInt32 size) : _size(size) {
+		std::shared_ptr<PoolBuffer> pBuffer(new PoolBuffer(poolBuffers, size));
+		memcpy((*pBuffer)->data(), data, size);
+		_pOwner = pBuffer;
+		_data = (*pBuffer)->data();
+	}
+	// refers to data kept by pOwner (a MappedFile for example), without copy
+	template<typename OwnerType>
+	SharedBuffer(const std::shared_ptr<OwnerType>& pOwner, const UInt8* data, UInt32 size) : _pOwner(pOwner), _data(data), _size(size) {}
+
+	SharedBuffer& operator=(const SharedBuffer& other) {
+		_pOwner = other._pOwner;
+		_data = other._data;
+		_size = other._size;
+		return *this;
+	}
+
+	const UInt8*	data() const { return _data; }
+	UInt32			size() const { return _size; }
+	bool			empty() const { return _size == 0; }
+
+	// part of this buffer, sharing the same memory
+	SharedBuffer	slice(UInt32 offset, UInt32 size = 0xFFFFFFFF) const {
+		SharedBuffer result(*this);
+		if (offset > _size)
+			offset = _size;
+		result._data += offset;
+		result._size = (_size - offset) < size ? (_size - offset) : size;
+		return result;
+	}
+
+	operator bool() const { return _pOwner ? true : false; }
+
+private:
+	std::shared_ptr<const void>	_pOwner;
+	const UInt8*				_data;
+	UInt32						_size;
+};
+
+
+} // namespace Mona
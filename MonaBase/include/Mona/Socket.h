@@ -33,28 +33,30 @@ public:
 	virtual void onError(const Exception& ex) = 0;
 	// Can be called by a separated thread!
 	// if ex of onReadable is raised, it's given to onError
-	virtual void onReadable(Exception& ex,UInt32 available) = 0;
+	// Events are edge-triggered: it has to read until EAGAIN, returns true if it remains possibly something to read (it will be called again)
+	virtual bool onReadable(Exception& ex) = 0;
 };
 
 class SocketFile : virtual NullableObject {
 	friend class SocketImpl;
 	friend class Socket;
 public:
-	SocketFile(const SocketFile& other) : _sockfd(other._sockfd) {}
+	SocketFile(const SocketFile& other) : _sockfd(other._sockfd), _nonBlocking(other._nonBlocking) {}
 	virtual ~SocketFile() {
 		if (_sockfd != NET_INVALID_SOCKET)
 			NET_CLOSESOCKET(_sockfd);
 	}
 	operator bool() const { return _sockfd != NET_INVALID_SOCKET;  }
 private:
-	SocketFile(NET_SOCKET sockfd) : _sockfd(sockfd) {}
+	SocketFile(NET_SOCKET sockfd, bool nonBlocking = false) : _sockfd(sockfd), _nonBlocking(nonBlocking) {}
 	NET_SOCKET			_sockfd;
+	bool				_nonBlocking; // already in non blocking mode (accept4)
 };
 
 
 class SocketImpl;
 class Socket : virtual Object {
-	friend class SocketManager;
+	friend class SocketReactor;
 	friend class SocketImpl;
 public:
 	enum Type {
@@ -111,18 +113,43 @@ public:
 	void setReusePort(bool flag);
 	bool getReusePort() const;
 
+	// Packets dropped by the kernel since the socket creation, connections refused on a full accept queue for a listening socket (Linux only, 0 elsewhere)
+	UInt32 drops() const;
+
+	// Datagrams given to sendTo are queued and sent together on the next writable event, with sendmmsg and UDP_SEGMENT (Linux only)
+	void setSendBatch(bool enable);
+	// Statistics since the previous call: datagrams sent by batch, system calls, and cumulated latency in microseconds since sendTo
+	void sendBatchStats(UInt64& datagrams, UInt64& calls, UInt64& latency);
+
+	// Bytes waiting in the send queue of the socket (data which could not be written immediately)
+	UInt32 queueing() const;
+	// Becomes true when queueing() exceeds the high watermark, and false again when it falls to the low watermark (high=0 disables it)
+	void setWatermarks(UInt32 high, UInt32 low);
+	bool congested() const;
+
 	SocketFile acceptConnection(Exception& ex,SocketAddress& address);
+	// To call in onReadable before returning false while it remains something to read,
+	// onReadable will be called again after the reading of the other ready sockets (fairness)
+	void yieldReading();
 
 	bool connect(Exception& ex, const SocketAddress& address,bool allowBroadcast=false);
 	bool bind(Exception& ex, const SocketAddress& address, bool reuseAddress = true);
 	bool bindWithListen(Exception& ex, const SocketAddress& address, bool reuseAddress = true,int backlog = 64);
 	void shutdown(Exception& ex, ShutdownType type = BOTH);
 	
+	// returns -1 without exception if nothing is available (EAGAIN), and 0 on graceful disconnection
 	int receiveBytes(Exception& ex, void* buffer, int length, int flags = 0);
 	int	receiveFrom(Exception& ex, void* buffer, int length, SocketAddress& address, int flags = 0);
+	// Receives until count datagrams in one system call (recvmmsg on Linux, successive recvfrom elsewhere), returns the number of datagrams received.
+	// lengths are the buffer capacities in input and the received sizes in output (-1 if the datagram has been truncated)
+	int	receiveFrom(Exception& ex, UInt32 count, void** buffers, int* lengths, SocketAddress** addresses, int flags = 0);
 
 	int sendBytes(Exception& ex, const void* buffer, int length, int flags = 0);
+	// Sends count buffers in one system call (sendmsg/writev, WSASend on Windows), returns the number of bytes sent
+	int sendBytes(Exception& ex, UInt32 count, const void** buffers, const int* lengths, int flags = 0);
 	int	sendTo(Exception& ex, const void* buffer, int length, const SocketAddress& address, bool allowBroadcast = false, int flags = 0);
+	// Sends length bytes of the file descriptor from offset (sendfile on Linux, read and send elsewhere), returns the number of bytes sent
+	int sendFile(Exception& ex, int file, UInt64 offset, int length);
 
 	// Can be called from one other thread than main thread (by the poolthread)
 	template<typename SocketSenderType>
@@ -143,11 +170,10 @@ public:
 	}
 
 	template<typename SenderType>
-	PoolThread* send(Exception& ex,const std::shared_ptr<SenderType>& pSender, PoolThread* pThread) {
+	bool send(Exception& ex,const std::shared_ptr<SenderType>& pSender, PoolThreads::Queue* pQueue) {
 		pSender->_pThis = pSender;
 		pSender->_pSocket.reset(new Socket(*this));
-		pThread = manager().poolThreads.enqueue<SenderType>(ex,pSender, pThread);
-		return pThread;
+		return manager().poolThreads.enqueue<SenderType>(ex,pSender, pQueue);
 	}
 
 	bool flush(Exception& ex);
@@ -156,9 +182,10 @@ private:
 	bool canSend(Exception& ex);
 	bool addSender(Exception& ex, std::shared_ptr<SocketSender> pSender);
 
-	// just for SocketManager class!
+	// just for SocketReactor class (SocketManager)!
 	void onError(const Exception& ex);
-	void onReadable(Exception& ex,UInt32 available);
+	bool onReadable(Exception& ex);
+	bool onWritable(Exception& ex);
 	bool onConnection();
 	
 
@@ -20,23 +20,24 @@ This file is a part of Mona.
 #pragma once
 
 #include "Mona.h"
-#include "Mona/Startable.h"
-#include "Mona/TaskHandler.h"
 #include "Mona/PoolThreads.h"
 #include "Mona/PoolBuffers.h"
+#include "Mona/TaskHandler.h"
 #include "Mona/Net.h"
-#include <map>
-#include <atomic>
+#include <vector>
+#include <memory>
 
 namespace Mona {
 
 class Socket;
-class SocketManager : private Task, private Startable, private TaskHandler, virtual Object {
+class SocketReactor;
+class SocketManager : virtual Object {
 	friend class SocketImpl;
 public:
-	SocketManager(TaskHandler& handler, const PoolBuffers& poolBuffers, PoolThreads& poolThreads, UInt32 bufferSize = 0, const std::string& name = "SocketManager");
-	SocketManager(const PoolBuffers& poolBuffers, PoolThreads& poolThreads, UInt32 bufferSize = 0, const std::string& name = "SocketManager");
-	virtual ~SocketManager() { stop(); }
+	// reactors = number of event loops (each one with its own thread) sharing the sockets, 0 means one by processor
+	SocketManager(TaskHandler& handler, const PoolBuffers& poolBuffers, PoolThreads& poolThreads, UInt32 bufferSize = 0, const std::string& name = "SocketManager", UInt16 reactors = 1);
+	SocketManager(const PoolBuffers& poolBuffers, PoolThreads& poolThreads, UInt32 bufferSize = 0, const std::string& name = "SocketManager", UInt16 reactors = 1);
+	virtual ~SocketManager();
 
 	bool					start(Exception& ex);
 	void					stop();
@@ -45,7 +46,11 @@ public:
 	const PoolBuffers&		poolBuffers;
 	const UInt32			bufferSize;
 
-	bool					running() const { return Startable::running(); }
+	bool					running() const;
+	UInt16					reactors() const { return _reactors.size(); }
+
+	// binds each reactor to one of these processors in turn (empty to unbind), to call before start
+	void					setAffinity(const std::vector<UInt16>& processors);
 
 private:
 	
@@ -58,34 +63,15 @@ private:
 
 	bool startWrite(NET_SOCKET sockfd,Socket** ppSocket) const;
 	bool stopWrite(NET_SOCKET sockfd,Socket** ppSocket) const;
+	// starts writing and flushes the socket as soon as possible, even if it's already writable
+	bool requestFlush(NET_SOCKET sockfd,Socket** ppSocket) const;
+	// ends the current reading once onReadable returns, and posts it again behind the events of the other ready sockets
+	void yieldReading(NET_SOCKET sockfd,Socket** ppSocket) const;
 
-	void					requestHandle();
-	void					run(Exception& ex);
-	void					handle(Exception& ex);
-
-	bool								_selfHandler;
-	Exception							_ex;
-
-	mutable  std::atomic<int>			_counter;
-	mutable  Signal						_initSignal;
-	mutable std::recursive_mutex		_mutex;
-
-    mutable std::map<NET_SOCKET, Socket**>		_sockets;
-
-    Exception							_exSkip;
-#if defined(_WIN32)
-    HWND								_eventSystem;
-#else
-	int									_eventSystem;
-#endif
-	int									_eventFD; // used just in linux case
-	
-	UInt32								_currentEvent;
-	int									_currentError;
-	Exception							_currentException;
+	// a socket stays on the same reactor for all its life, given by its file descriptor
+	SocketReactor&	reactor(NET_SOCKET sockfd) const;
 
-	Socket**							_ppSocket;
-    NET_SOCKET							_sockfd;
+	std::vector<std::unique_ptr<SocketReactor>>	_reactors;
 };
 
 
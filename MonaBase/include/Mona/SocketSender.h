@@ -24,7 +24,9 @@ This file is a part of Mona.
 #include "Mona/PoolThread.h"
 #include "Mona/SocketAddress.h"
 #include "Mona/PoolBuffer.h"
+#include "Mona/SharedBuffer.h"
 #include <memory>
+#include <vector>
 
 
 namespace Mona {
@@ -34,7 +36,7 @@ class SocketSender : public WorkThread, virtual Object {
 	friend class Socket;
 	friend class SocketImpl;
 public:
-	bool	available() { return _ppBuffer ? !_ppBuffer->empty() : (data() && _position < size()); }
+	bool	available() { return availableData() || _filePosition < _fileEnd; }
 
 	virtual const UInt8*	data() { return _data; }
 	virtual UInt32			size() { return _size; }
@@ -42,22 +44,41 @@ public:
 protected:
 	SocketSender(const char* name);
 	SocketSender(const char* name,const UInt8* data, UInt32 size);
+	virtual ~SocketSender();
 
 
 	// if return true and ex==true it will display a warning, otherwise return false == failed
 	bool							run(Exception& ex);
 
+	// Inserts buffer after the data written until now, it will be sent without copy (just for stream senders, see stream())
+	void							share(const SharedBuffer& buffer);
+	// Sends size bytes of the file from offset after everything else, without loading it in memory (sendfile on Linux),
+	// just for stream senders, returns false if the file can't be opened
+	bool							shareFile(Exception& ex, const std::string& path, UInt64 offset, UInt64 size);
+
 private:
+	bool							availableData() { return (_ppBuffer ? (!_ppBuffer->empty() && _position < (*_ppBuffer)->size()) : (data() && _position < size())) || _sharedIndex < _shareds.size(); }
 	
 	bool							buffering(const PoolBuffers& poolBuffers);
 
 	// send data
 	bool							flush(Exception& ex,Socket& socket);
 
+	// data remaining to send
+	const UInt8*					pending(UInt32& size);
+	// fills until count parts remaining to send (data and shared buffers), returns the count of parts filled
+	UInt32							pending(const void** buffers, int* lengths, UInt32 count);
+	// returns true if everything has been sent
+	bool							consume(UInt32 size);
+	// bytes remaining to send (data and shared buffers)
+	UInt32							queueing();
+
 
 	//// TO OVERLOAD ////////
 
 	virtual	UInt32					send(Exception& ex,Socket& socket,const UInt8* data, UInt32 size) = 0;
+	// true if send is a raw stream writing, then queued senders can be gathered in one system call
+	virtual bool					stream() { return false; }
 
 	std::unique_ptr<Socket>		_pSocket;
 	std::weak_ptr<SocketSender>	_pThis;
@@ -66,6 +87,21 @@ private:
 	UInt8*						_data;
 	UInt32						_size;
 	std::unique_ptr<PoolBuffer>	_ppBuffer;
+
+	struct Shared {
+		Shared(UInt32 position, const SharedBuffer& buffer) : position(position), buffer(buffer) {}
+		UInt32			position; // in data
+		SharedBuffer	buffer;
+	};
+	std::vector<Shared>			_shareds;
+	UInt32						_sharedIndex; // current shared buffer
+	UInt32						_sharedPosition; // in the current shared buffer
+
+	UInt32						_queued; // bytes counted in the socket queue (see SocketImpl::addSender)
+
+	int							_file; // descriptor
+	UInt64						_filePosition;
+	UInt64						_fileEnd;
 };
 
 
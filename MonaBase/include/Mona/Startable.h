@@ -22,6 +22,7 @@ This file is a part of Mona.
 #include "Mona/Exceptions.h"
 #include "Mona/Signal.h"
 #include <thread>
+#include <vector>
 
 
 namespace Mona {
@@ -54,6 +55,10 @@ public:
 	bool				running() const { return !_stop; }
 	const std::string&	name() const { return _name; }
 
+	// processors on which the thread can run (empty for any), applied on the next start
+	void						setAffinity(const std::vector<UInt16>& processors) { _affinity = processors; }
+	const std::vector<UInt16>&	affinity() const { return _affinity; }
+
 protected:
 	Startable(const std::string& name);
 	virtual ~Startable();
@@ -72,6 +77,7 @@ private:
 	Signal					_wakeUpSignal;
 	std::string				_name;
 	Priority				_priority;
+	std::vector<UInt16>		_affinity;
 };
 
 
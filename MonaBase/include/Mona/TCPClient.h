@@ -44,13 +44,18 @@ public:
 	bool					send(Exception& ex, const UInt8* data, UInt32 size);
 	void					disconnect();
 
+	// see Socket::setWatermarks
+	void					setWatermarks(UInt32 high, UInt32 low) { _socket.setWatermarks(high, low); }
+	UInt32					queueing() const { return _socket.queueing(); }
+	bool					congested() const { return _socket.congested(); }
+
 	template<typename TCPSenderType>
 	bool send(Exception& ex,const std::shared_ptr<TCPSenderType>& pSender) {
 		return _socket.send<TCPSenderType>(ex, pSender);
 	}
 	template<typename TCPSenderType>
-	PoolThread*	send(Exception& ex,const std::shared_ptr<TCPSenderType>& pSender, PoolThread* pThread) {
-		return _socket.send<TCPSenderType>(ex, pSender, pThread);
+	bool		send(Exception& ex,const std::shared_ptr<TCPSenderType>& pSender, PoolThreads::Queue* pQueue) {
+		return _socket.send<TCPSenderType>(ex, pSender, pQueue);
 	}
 
 	const SocketManager&	manager() const { return _socket.manager(); }
@@ -65,7 +70,7 @@ private:
 	const SocketAddress&	updateAddress() const { if (_address) return _address;  Exception ex; _socket.address(ex, _address); return _address; }
 	const SocketAddress&	updatePeerAddress() const { if (_peerAddress) return _peerAddress; Exception ex; _socket.peerAddress(ex, _peerAddress); return _peerAddress; }
 
-	void					onReadable(Exception& ex,UInt32 available);
+	bool					onReadable(Exception& ex);
 
 	Socket					_socket;
 
@@ -33,6 +33,7 @@ public:
 
 private:
 	UInt32	send(Exception& ex, Socket& socket, const UInt8* data, UInt32 size) { return socket.sendBytes(ex,data,size); }
+	bool	stream() { return true; }
 };
 
 
@@ -22,6 +22,7 @@ This file is a part of Mona.
 
 #include "Mona/Mona.h"
 #include "Mona/Socket.h"
+#include <atomic>
 
 
 namespace Mona {
@@ -36,22 +37,31 @@ public:
 	// safe-threading
 	SocketAddress&			address(SocketAddress& address){ std::lock_guard<std::recursive_mutex> lock(_mutex);  return address=_address; }
 
-	bool					start(Exception& ex, const SocketAddress& address);
+	// backlog = size of the accept queue of the kernel
+	bool					start(Exception& ex, const SocketAddress& address, int backlog = 64);
 	bool					running() { return _running;  }
 	void					stop();
 
+	// Cumulated since the creation: connections accepted, and connections dropped by the kernel on a full accept queue (Linux only)
+	UInt64					accepted() const { return _accepted; }
+	UInt64					dropped() const;
+
 	const SocketManager&	manager() const { return _socket.manager(); }
 protected:
 	void close() { stop(); }
 private:
 	virtual void	onConnection(Exception& ex,const SocketAddress& address,SocketFile& file) = 0;
-	// Can be called from one other thread
-	void			onReadable(Exception& ex,UInt32 available);
+	// Can be called from one other thread, accepts until ACCEPT_BUDGET connections by reading event
+	bool			onReadable(Exception& ex);
+
+	enum { ACCEPT_BUDGET = 64 };
 
 	Socket					_socket;
-	std::recursive_mutex	_mutex;
+	mutable std::recursive_mutex	_mutex;
 	volatile bool			_running;
 	SocketAddress			_address;
+	std::atomic<UInt64>		_accepted;
+	UInt64					_dropped; // by the previous listening sockets
 	
 };
 
@@ -22,33 +22,52 @@ This file is a part of Mona.
 #include "Mona/Mona.h"
 #include "Mona/Task.h"
 #include "Mona/Signal.h"
+#include "Mona/MPSCQueue.h"
 #include <mutex>
-
+#include <memory>
+#include <deque>
 
 namespace Mona {
 
 class TaskHandler : virtual Object {
 public:
-	TaskHandler() : _pTask(NULL), _stop(true) {}
+	// queueCapacity = maximum of tasks posted and waiting to be handled (0 means unbounded)
+	TaskHandler(UInt32 queueCapacity = 0) : _pTask(NULL), _stop(true), _tasks(queueCapacity, 1024), _deferredSize(0), _deferrals(0) {}
 	virtual ~TaskHandler() {stop(); }
 
 	bool waitHandle(Task& task);
 
+	// post a task which will be handled later by the handler thread, never blocks
+	// if returns false, ex is set if the handler is stopped, otherwise the queue is full and it can be retried later
+	// with defer, a task which doesn't fit in the queue is kept after it rather than refused, and the queue stays full
+	// for the other posts until the deferred tasks are handled (to keep the posting order)
+	bool postHandle(Exception& ex,const std::shared_ptr<Task>& pTask,bool defer=false);
+
+	UInt32	queueSize() const { return _tasks.size() + _deferredSize; }
+	// tasks deferred on a full queue since the creation
+	UInt64	deferrals() const { return _deferrals; }
+
 protected:
 	void start();
 	void stop();
 	bool running() { return !_stop; }
+
 	void giveHandle(Exception& ex);
+
 private:
 	virtual void requestHandle()=0;
 
-	std::recursive_mutex	_mutex;
-	std::mutex				_mutexWait;
-	Task*					_pTask;
-	Signal					_signal;
-	volatile bool			_stop;
+	std::recursive_mutex					_mutex;
+	std::mutex								_mutexWait;
+	Task*									_pTask;
+	Signal									_signal;
+	volatile bool							_stop;
+	MPSCQueue<std::shared_ptr<Task>>		_tasks; // caches more nodes than by default, few handlers post the most of the tasks
+	std::mutex								_mutexDeferred;
+	std::deque<std::shared_ptr<Task>>		_deferredTasks;
+	std::atomic<UInt32>						_deferredSize;
+	std::atomic<UInt64>						_deferrals;
 };
 
 
-
 } // namespace Mona
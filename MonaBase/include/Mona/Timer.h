@@ -0,0 +1,89 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include <functional>
+
+namespace Mona {
+
+/// Hierarchical timer wheel: 256 slots of 1ms, then 3 levels of 64 slots (until 18h, longer timeouts are cascaded again),
+/// raise() visits just the expired timers, and returns the time to wait before the next expiration.
+/// Not thread-safe, it must be used always by the same thread
+class Timer : virtual Object {
+public:
+	/// Function called on expiration with the delay of its raising (in ms),
+	/// returns the next timeout (in ms) or 0 to stop the timer
+	struct OnTimer : std::function<UInt32(UInt32 delay)>, virtual Object {
+		friend class Timer;
+	public:
+		template< class... Args >
+		OnTimer(Args... args) : std::function<UInt32(UInt32)>(args...), _pTimer(NULL), _expiration(0), _ppHead(NULL), _pPrev(NULL), _pNext(NULL) {}
+		virtual ~OnTimer() { if (_pTimer) _pTimer->remove(*this); }
+
+		// true if set, or in progress of raising
+		bool	running() const { return _pTimer != NULL; }
+		// expiration time (see Timer::Now)
+		Int64	expiration() const { return _expiration; }
+	private:
+		mutable const Timer*	_pTimer;
+		mutable Int64			_expiration;
+		mutable const OnTimer**	_ppHead;
+		mutable const OnTimer*	_pPrev;
+		mutable const OnTimer*	_pNext;
+	};
+
+	Timer();
+	virtual ~Timer();
+
+	/// Starts or restarts onTimer to expire in timeout ms (0 stops it)
+	void	set(const OnTimer& onTimer, UInt32 timeout) const;
+	void	remove(const OnTimer& onTimer) const;
+
+	UInt32	count() const { return _count; }
+
+	/// Raises expired timers, returns the time to wait before the next expiration (in ms, 0 if there is no more timer)
+	UInt32	raise();
+
+	static Int64 Now();
+
+private:
+	enum {
+		LEVEL0_BITS = 8,
+		LEVEL_BITS = 6,
+		LEVELS = 4,
+		SLOTS = (1 << LEVEL0_BITS) + (LEVELS - 1)*(1 << LEVEL_BITS)
+	};
+
+	void	insert(const OnTimer& onTimer) const;
+	void	unlink(const OnTimer& onTimer) const;
+	void	cascade(UInt8 level);
+	UInt32	next() const;
+
+	mutable const OnTimer*	_slots[SLOTS];
+	mutable const OnTimer*	_pExpired; // timers of the slot in progress of raising
+	mutable const OnTimer*	_pRaising; // timer in progress of raising, reset if removed meanwhile
+	mutable UInt32			_count;
+	Int64					_time; // last tick raised (in ms)
+};
+
+
+} // namespace Mona
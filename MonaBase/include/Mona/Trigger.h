@@ -34,10 +34,15 @@ public:
 	void start();
 	void reset();
 	void stop() { _running = false; }
+
+	bool running() const { return _running; }
+	// time before the next raising (in ms), 0 if stopped
+	UInt32 timeout() const;
 private:
-	Time		_timeInit;
+	UInt32		interval() const;
+
+	Time		_timeInit; // time of the start, or of the last raising
 	Int8		_cycle;
-	UInt8		_time;
 	bool		_running;
 
 };
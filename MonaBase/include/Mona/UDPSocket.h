@@ -22,6 +22,8 @@ This file is a part of Mona.
 
 #include "Mona/Mona.h"
 #include "Mona/Socket.h"
+#include <deque>
+#include <vector>
 
 namespace Mona {
 
@@ -30,6 +32,21 @@ public:
 	UDPSocket(const SocketManager& manager, bool allowBroadcast=false);
 	virtual ~UDPSocket();
 
+	struct Packet : virtual Object {
+		Packet(const PoolBuffers& poolBuffers, UInt32 size) : pBuffer(poolBuffers, size) {}
+		PoolBuffer		pBuffer;
+		SocketAddress	address;
+	};
+	typedef std::vector<Packet*> Packets;
+
+	// Reads until count datagrams by system call (recvmmsg on Linux) in count preallocated packets of packetSize bytes, bigger datagrams are ignored.
+	// To call before bind or connect, count=0 restores the reception datagram by datagram
+	void					setBatchReception(UInt16 count, UInt32 packetSize = 2048) { _batchCount = count; _packetSize = packetSize; }
+	// Datagrams sent are queued and emitted together by the socket manager thread with sendmmsg, consecutive datagrams to a same destination use UDP_SEGMENT (Linux only)
+	void					setBatchSending(bool enable) { _socket.setSendBatch(enable); }
+	// Statistics since the previous call: datagrams sent by batch, system calls, and cumulated latency in microseconds
+	void					batchSendingStats(UInt64& datagrams, UInt64& calls, UInt64& latency) { _socket.sendBatchStats(datagrams, calls, latency); }
+
 	// unsafe-threading
 	const SocketAddress&	address() const { std::lock_guard<std::mutex> lock(_mutex); return updateAddress(); }
 	const SocketAddress&	peerAddress() const {  std::lock_guard<std::mutex> lock(_mutex); return updatePeerAddress(); }
@@ -50,21 +67,32 @@ public:
 		return _socket.send<UDPSenderType>(ex, pSender);
 	}
 	template<typename UDPSenderType>
-	PoolThread* send(Exception& ex,const std::shared_ptr<UDPSenderType>& pSender, PoolThread* pThread) {
-		return _socket.send<UDPSenderType>(ex, pSender,pThread);
+	bool send(Exception& ex,const std::shared_ptr<UDPSenderType>& pSender, PoolThreads::Queue* pQueue) {
+		return _socket.send<UDPSenderType>(ex, pSender,pQueue);
 	}
 
 	const SocketManager&	manager() const { return _socket.manager(); }
 private:
 	virtual void			onReception(PoolBuffer& pBuffer, const SocketAddress& address) = 0;
+	// Batch reception (see setBatchReception), packet buffers can be swapped. By default gives packets one by one to onReception
+	virtual void			onReception(Packets& packets) { for (Packet* pPacket : packets) onReception(pPacket->pBuffer, pPacket->address); }
 
 	const SocketAddress&	updateAddress() const { if (_address) return _address;  Exception ex; _socket.address(ex, _address); return _address; }
 	const SocketAddress&	updatePeerAddress() const { if (_peerAddress) return _peerAddress; Exception ex; _socket.peerAddress(ex, _peerAddress); return _peerAddress; }
 	void					resetAddresses() {std::lock_guard<std::mutex> lock(_mutex);_address.reset();_peerAddress.reset();}
 
-	void					onReadable(Exception& ex,UInt32 available);
+	bool					onReadable(Exception& ex);
+	bool					receiveBatch(Exception& ex);
 	
 	const bool				_allowBroadcast;
+	UInt16					_batchCount;
+	UInt32					_packetSize;
+	// batch reception, always used by one reading thread at a time
+	std::deque<Packet>		_slots;
+	Packets					_packets;
+	std::vector<void*>		_buffers;
+	std::vector<int>		_lengths;
+	std::vector<SocketAddress*>	_addresses;
 	Socket					_socket;
 	mutable std::mutex		_mutex;
 	mutable SocketAddress	_address;
@@ -58,6 +58,14 @@ public:
 	static bool ReadIniFile(Exception& ex, const std::string& path, Parameters& parameters);
 
 	static unsigned ProcessorCount() { unsigned result(std::thread::hardware_concurrency());  return result > 0 ? result : 1; }
+	// NUMA node of each processor (by processor index), empty if the topology is unknown (Linux only)
+	static const std::vector<UInt16>& ProcessorNodes();
+	static UInt16 NodeCount();
+	// NUMA node of the processor which runs the current thread (0 if unknown)
+	static UInt16 CurrentNode();
+	// parses a processors list like "0-3,8", where "node1" means every processor of the NUMA node 1
+	static bool ParseProcessors(Exception& ex, const std::string& value, std::vector<UInt16>& processors);
+	static std::string& FormatProcessors(const std::vector<UInt16>& processors, std::string& value);
 	static const MapParameters& Environment();
 
 	template<typename Type>
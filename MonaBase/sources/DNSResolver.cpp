@@ -0,0 +1,269 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#include "Mona/DNSResolver.h"
+#include "Mona/DNS.h"
+#include "Mona/Time.h"
+#include "Mona/Logs.h"
+#include <fstream>
+#include <algorithm>
+
+using namespace std;
+
+namespace Mona {
+
+class DNSResolver::Entry : public HostEntry, virtual Object {
+public:
+	Entry(const string& name) : HostEntry(name), expiration(0) {}
+	Exception	ex;
+	Int64		expiration;
+};
+
+class DNSResolver::Resolution : public Task, virtual Object {
+public:
+	Resolution(TaskHandler& handler, const shared_ptr<const Entry>& pEntry, vector<OnResolved>& callbacks) : Task(handler), _pEntry(pEntry) { _callbacks.swap(callbacks); }
+
+	bool wait() { return waitHandle(); }
+
+private:
+	void handle(Exception& ex) {
+		for (const OnResolved& onResolved : _callbacks)
+			onResolved(_pEntry->ex, *_pEntry);
+	}
+
+	shared_ptr<const Entry>	_pEntry;
+	vector<OnResolved>		_callbacks;
+};
+
+
+DNSResolver::DNSResolver() : Startable("DNSResolver"), _pHandler(NULL), _positiveTTL(60000), _negativeTTL(10000) {
+}
+
+DNSResolver::DNSResolver(TaskHandler& handler) : Startable("DNSResolver"), _pHandler(&handler), _positiveTTL(60000), _negativeTTL(10000) {
+}
+
+DNSResolver::~DNSResolver() {
+	stop();
+}
+
+bool DNSResolver::start(Exception& ex) {
+	return Startable::start(ex, PRIORITY_LOW);
+}
+
+void DNSResolver::stop() {
+	Startable::stop();
+	lock_guard<mutex> lock(_mutex);
+	_queries.clear();
+	_waitings.clear();
+}
+
+void DNSResolver::setTTL(UInt32 positive, UInt32 negative) {
+	lock_guard<mutex> lock(_mutex);
+	_positiveTTL = positive * 1000ll;
+	_negativeTTL = negative * 1000ll;
+	purge(Time::Now());
+}
+
+bool DNSResolver::loadHosts(Exception& ex, const string& path) {
+	ifstream file(path, ios::in);
+	if (!file.good()) {
+		ex.set(Exception::FILE, "Impossible to open hosts file ", path);
+		return false;
+	}
+	string line;
+	string name;
+	vector<string> fields;
+	while (getline(file, line)) {
+		size_t comment = line.find('#');
+		if (comment != string::npos)
+			line.resize(comment);
+		fields.clear();
+		String::Split(line, " \t\r", fields, String::SPLIT_IGNORE_EMPTY | String::SPLIT_TRIM);
+		if (fields.size() < 2)
+			continue;
+		IPAddress address;
+		Exception exAddress;
+		if (!address.set(exAddress, fields[0])) {
+			WARN("Hosts file ", path, ", ", exAddress.error());
+			continue;
+		}
+		lock_guard<mutex> lock(_mutex);
+		shared_ptr<HostEntry>& pHost = _hosts[String::ToLower(name.assign(fields[1]))];
+		if (!pHost)
+			pHost.reset(new HostEntry(fields[1]));
+		pHost->addAddress(address);
+		for (UInt32 i = 2; i < fields.size(); ++i) {
+			shared_ptr<HostEntry>& pAlias = _hosts[String::ToLower(name.assign(fields[i]))];
+			if (pAlias)
+				continue; // first entry wins, as for the system resolver
+			pAlias = pHost;
+			pHost->addAlias(fields[i]);
+		}
+	}
+	return true;
+}
+
+void DNSResolver::addHost(const string& name, const IPAddress& address) {
+	string key(name);
+	lock_guard<mutex> lock(_mutex);
+	shared_ptr<HostEntry>& pHost = _hosts[String::ToLower(key)];
+	if (!pHost)
+		pHost.reset(new HostEntry(name));
+	pHost->addAddress(address);
+}
+
+UInt32 DNSResolver::cached() {
+	lock_guard<mutex> lock(_mutex);
+	purge(Time::Now());
+	return _cache.size();
+}
+
+void DNSResolver::clearCache() {
+	lock_guard<mutex> lock(_mutex);
+	_cache.clear();
+}
+
+void DNSResolver::purge(Int64 now) {
+	auto it = _cache.begin();
+	while (it != _cache.end()) {
+		if (now >= it->second->expiration)
+			it = _cache.erase(it);
+		else
+			++it;
+	}
+}
+
+bool DNSResolver::resolve(const string& host, const OnResolved& onResolved) {
+	Exception ex, ignore;
+	IPAddress address;
+	if (address.set(ignore, host)) {
+		HostEntry entry(host);
+		entry.addAddress(address);
+		onResolved(ex, entry);
+		return true;
+	}
+
+	string name(host);
+	String::ToLower(name);
+	shared_ptr<const HostEntry> pHost;
+	{
+		lock_guard<mutex> lock(_mutex);
+		auto itHost = _hosts.find(name);
+		if (itHost != _hosts.end())
+			pHost = itHost->second;
+		else {
+			auto it = _cache.find(name);
+			if (it != _cache.end()) {
+				if (Time::Now() < it->second->expiration) {
+					const Entry& entry(*it->second);
+					pHost = it->second;
+					ex.set(entry.ex);
+				} else
+					_cache.erase(it);
+			}
+			if (!pHost) {
+				if (!running())
+					ex.set(Exception::THREAD, "DNS resolver not running");
+				else {
+					vector<OnResolved>& callbacks(_waitings[name]);
+					if (callbacks.empty())
+						_queries.emplace_back(name);
+					callbacks.emplace_back(onResolved);
+				}
+			}
+		}
+	}
+	if (pHost) {
+		onResolved(ex, *pHost);
+		return true;
+	}
+	if (ex) {
+		HostEntry entry(host);
+		onResolved(ex, entry);
+		return true;
+	}
+	wakeUp();
+	return false;
+}
+
+void DNSResolver::run(Exception& ex) {
+	while (sleep(1000) != STOP) {
+		string name;
+		for (;;) {
+			{
+				lock_guard<mutex> lock(_mutex);
+				if (_queries.empty())
+					break;
+				name = move(_queries.front());
+				_queries.pop_front();
+			}
+
+			// blocking call, but just for this thread
+			Exception exHost;
+			HostEntry host;
+			bool success = DNS::HostByName(exHost, name, host);
+
+			shared_ptr<Entry> pEntry(new Entry(host.name().empty() ? name : host.name()));
+			if (success) {
+				for (const string& alias : host.aliases())
+					pEntry->addAlias(alias);
+				// getaddrinfo returns one address by socket type, keep just distinct addresses
+				for (const IPAddress& address : host.addresses()) {
+					if (find(pEntry->addresses().begin(), pEntry->addresses().end(), address) == pEntry->addresses().end())
+						pEntry->addAddress(address);
+				}
+			} else
+				pEntry->ex.set(exHost);
+
+			vector<OnResolved> callbacks;
+			{
+				lock_guard<mutex> lock(_mutex);
+				Int64 ttl(success ? _positiveTTL : _negativeTTL);
+				if (ttl) {
+					pEntry->expiration = Time::Now() + ttl;
+					_cache[name] = pEntry;
+				}
+				auto it = _waitings.find(name);
+				if (it != _waitings.end()) {
+					callbacks.swap(it->second);
+					_waitings.erase(it);
+				}
+			}
+			if (callbacks.empty())
+				continue;
+
+			if (!_pHandler) {
+				for (const OnResolved& onResolved : callbacks)
+					onResolved(pEntry->ex, *pEntry);
+			} else {
+				Exception exPost;
+				shared_ptr<Resolution> pResolution(new Resolution(*_pHandler, pEntry, callbacks));
+				if (!_pHandler->postHandle(exPost, pResolution) && !exPost)
+					pResolution->wait(); // queue full, wait that the handler thread takes it
+			}
+			if (!running())
+				return;
+		}
+		lock_guard<mutex> lock(_mutex);
+		purge(Time::Now());
+	}
+}
+
+
+} // namespace Mona
@@ -24,8 +24,11 @@ namespace Mona {
 using namespace std;
 
 FilePath& FilePath::operator=(const FilePath& other) {
-	if (_attributesLoaded = other._attributesLoaded)
-		_attributes.lastModified.update(other._attributes.lastModified); 
+	if (_attributesLoaded = other._attributesLoaded) {
+		_attributes.lastModified.update(other._attributes.lastModified);
+		_attributes.size = other._attributes.size;
+		_attributes.isDirectory = other._attributes.isDirectory;
+	}
 	_extension = other._extension;
 	_fullPath = other._fullPath;
 	_directory = other._directory;
@@ -0,0 +1,178 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#include "Mona/FileWriter.h"
+#include "Mona/FileSystem.h"
+#include "Mona/Logs.h"
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace Mona {
+
+static void FileSync(FILE* pFile) {
+	fflush(pFile);
+#if defined(_WIN32)
+	_commit(_fileno(pFile));
+#else
+	fsync(fileno(pFile));
+#endif
+}
+
+FileWriter::File::~File() {
+	if (_pFile)
+		fclose(_pFile);
+}
+
+
+FileWriter::FileWriter(const PoolBuffers& poolBuffers, const char* name) : Startable(name), _poolBuffers(poolBuffers), _queueing(0), _dropped(0), _maximum(0), _sync(SYNC_CLOSE), _period(1000) {
+}
+
+void FileWriter::stop() {
+	Startable::stop();
+}
+
+shared_ptr<FileWriter::File> FileWriter::open(Exception& ex, const string& path, bool append) {
+	lock_guard<mutex> lock(_mutex);
+	if (!running() && !start(ex, Startable::PRIORITY_LOW))
+		return nullptr;
+	return make_shared<File>(path, append);
+}
+
+bool FileWriter::write(const shared_ptr<File>& pFile, PoolBuffer& pBuffer) {
+	if (pFile->_failed)
+		return false;
+	return push(pFile, &pBuffer, false);
+}
+
+void FileWriter::close(const shared_ptr<File>& pFile) {
+	push(pFile, NULL, true);
+}
+
+bool FileWriter::push(const shared_ptr<File>& pFile, PoolBuffer* pBuffer, bool close) {
+	UInt32 size(pBuffer ? (*pBuffer)->size() : 0);
+	lock_guard<mutex> lock(_mutex);
+	if (!running()) {
+		Exception ex;
+		if (!start(ex, Startable::PRIORITY_LOW)) {
+			ERROR(ex.error());
+			return false;
+		}
+	}
+	if (size && _maximum && (_queueing + size) > _maximum) {
+		++_dropped;
+		return false;
+	}
+	_operations.emplace_back(pFile, _poolBuffers, close);
+	if (pBuffer)
+		_operations.back().pBuffer.swap(*pBuffer);
+	_queueing += size;
+	wakeUp();
+	return true;
+}
+
+
+void FileWriter::run(Exception& ex) {
+
+	deque<shared_ptr<File>> written; // files to fsync on the next period
+	Time lastSync;
+
+	for (;;) {
+
+		WakeUpType wakeUpType = sleep(_sync == SYNC_PERIODIC ? _period : 60000);
+
+		for (;;) {
+			Operation* pOperation;
+			{
+				lock_guard<mutex> lock(_mutex);
+				if (_operations.empty())
+					break;
+				pOperation = &_operations.front();
+			}
+
+			File& file(*pOperation->pFile);
+			UInt32 size(pOperation->pBuffer->size());
+
+			if (!file._failed && (size || pOperation->close) && !file._pFile) {
+				string directory(file.path);
+				if (FileSystem::Parent(directory).size() < file.path.size() && !FileSystem::Exists(directory)) {
+					Exception exDirectory;
+					FileSystem::CreateDirectories(exDirectory, directory);
+					if (exDirectory)
+						WARN(exDirectory.error());
+				}
+				if (!(file._pFile = fopen(file.path.c_str(), file._append ? "ab" : "wb"))) {
+					ERROR("Impossible to open file ", file.path, " to write it");
+					file._failed = true;
+				} else
+					setvbuf(file._pFile, NULL, _IONBF, 0); // buffers are already large, no need of stdio buffering
+			}
+
+			if (size && file._pFile && !file._failed) {
+				if (fwrite(pOperation->pBuffer->data(), 1, size, file._pFile) != size) {
+					ERROR("Impossible to write ", size, " bytes in file ", file.path);
+					file._failed = true;
+				} else if (_sync == SYNC_ALWAYS)
+					FileSync(file._pFile);
+				else if (_sync == SYNC_PERIODIC && !file._written) {
+					file._written = true;
+					written.emplace_back(pOperation->pFile);
+				}
+			}
+
+			if (pOperation->close && file._pFile) {
+				if (_sync != SYNC_NEVER)
+					FileSync(file._pFile);
+				fclose(file._pFile);
+				file._pFile = NULL;
+				file._written = false;
+			}
+
+			lock_guard<mutex> lock(_mutex);
+			_queueing -= size;
+			_operations.pop_front();
+		}
+
+		if (!written.empty() && (wakeUpType == STOP || lastSync.isElapsed(_period))) {
+			// periodic sync
+			for (shared_ptr<File>& pFile : written) {
+				if (pFile->_written && pFile->_pFile)
+					FileSync(pFile->_pFile);
+				pFile->_written = false;
+			}
+			written.clear();
+			lastSync.update();
+		}
+
+		if (wakeUpType == STOP) {
+			lock_guard<mutex> lock(_mutex);
+			if (_operations.empty()) {
+				stop(); // to set running=false!
+				return;
+			}
+		}
+	}
+}
+
+
+} // namespace Mona
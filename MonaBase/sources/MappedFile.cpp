@@ -0,0 +1,136 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#include "Mona/MappedFile.h"
+#if defined(_WIN32)
+	#include <windows.h>
+#else
+	#include <fcntl.h>
+	#include <errno.h>
+	#include <unistd.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+#endif
+
+namespace Mona {
+
+using namespace std;
+
+#if defined(_WIN32)
+MappedFile::MappedFile() : _data(NULL), _size(0), _writable(false), _file(INVALID_HANDLE_VALUE), _mapping(NULL) {}
+#else
+MappedFile::MappedFile() : _data(NULL), _size(0), _writable(false), _file(-1) {}
+#endif
+
+bool MappedFile::open(Exception& ex, const string& path, UInt32 size) {
+	close();
+	_writable = size>0;
+#if defined(_WIN32)
+	_file = CreateFile(path.c_str(), _writable ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ, FILE_SHARE_READ, NULL, _writable ? CREATE_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (_file == INVALID_HANDLE_VALUE) {
+		ex.set(Exception::FILE, "Impossible to open file ", path, " (error ", GetLastError(), ")");
+		return false;
+	}
+	if (!_writable) {
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(_file, &fileSize) || fileSize.HighPart) {
+			ex.set(Exception::FILE, "Impossible to map file ", path, ", size unknown or exceeding 4GB");
+			close();
+			return false;
+		}
+		size = fileSize.LowPart;
+	}
+	if (size>0) {
+		_mapping = CreateFileMapping(_file, NULL, _writable ? PAGE_READWRITE : PAGE_READONLY, 0, size, NULL);
+		if (_mapping)
+			_data = (UInt8*)MapViewOfFile(_mapping, _writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, size);
+		if (!_data) {
+			ex.set(Exception::FILE, "Impossible to map file ", path, " (error ", GetLastError(), ")");
+			close();
+			return false;
+		}
+	}
+#else
+	_file = ::open(path.c_str(), _writable ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDONLY, 0644);
+	if (_file < 0) {
+		ex.set(Exception::FILE, "Impossible to open file ", path, " (error ", errno, ")");
+		return false;
+	}
+	if (_writable) {
+		if (ftruncate(_file, size) != 0) {
+			ex.set(Exception::FILE, "Impossible to allocate ", size, " bytes to file ", path, " (error ", errno, ")");
+			close();
+			return false;
+		}
+	} else {
+		struct stat status;
+		if (fstat(_file, &status) != 0 || status.st_size > 0xFFFFFFFF) {
+			ex.set(Exception::FILE, "Impossible to map file ", path, ", size unknown or exceeding 4GB");
+			close();
+			return false;
+		}
+		size = (UInt32)status.st_size;
+	}
+	if (size>0) {
+		void* data = mmap(NULL, size, _writable ? (PROT_READ | PROT_WRITE) : PROT_READ, MAP_SHARED, _file, 0);
+		if (data == MAP_FAILED) {
+			ex.set(Exception::FILE, "Impossible to map file ", path, " (error ", errno, ")");
+			close();
+			return false;
+		}
+		_data = (UInt8*)data;
+	}
+#endif
+	if (!_data) {
+		ex.set(Exception::FILE, "Impossible to map the empty file ", path);
+		close();
+		return false;
+	}
+	_size = size;
+	_path = path;
+	return true;
+}
+
+void MappedFile::close() {
+#if defined(_WIN32)
+	if (_data)
+		UnmapViewOfFile(_data);
+	if (_mapping) {
+		CloseHandle(_mapping);
+		_mapping = NULL;
+	}
+	if (_file != INVALID_HANDLE_VALUE) {
+		CloseHandle(_file);
+		_file = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (_data)
+		munmap(_data, _size);
+	if (_file >= 0) {
+		::close(_file);
+		_file = -1;
+	}
+#endif
+	_data = NULL;
+	_size = 0;
+	_path.clear();
+}
+
+
+} // namespace Mona
@@ -19,7 +19,10 @@ This file is a part of Mona.
 
 #include "Mona/PoolBuffers.h"
 #include "Mona/PoolBuffer.h"
-//#include <atomic>
+#include "Mona/Util.h"
+#include <thread>
+#include <algorithm>
+#include <iterator>
 
 
 using namespace std;
@@ -27,68 +30,167 @@ using namespace std;
 
 namespace Mona {
 
-PoolBuffers::PoolBuffers(UInt16 maximumCapacity) : _maximumCapacity(maximumCapacity) {
-	// at least one buffer
-	_buffers.emplace_back(new Buffer(0));
+const UInt32 PoolBuffers::_ClassSizes[] = { 256, 1536, 4096, 16384, 65536 };
+
+PoolBuffers::PoolBuffers(UInt32 maximumCapacity) : _classes(0), _nodes(Util::NodeCount()), _trimDelay(120000), _trimMaximum(0) { // 2 minutes
+	while (_classes < CLASSES && _ClassSizes[_classes] <= maximumCapacity)
+		++_classes;
+	// more stripes than threads to limit collisions
+	_stripesSize = max(Util::ProcessorCount() * 2 / _nodes, 2u);
+	_stripes = new Stripe[_stripesSize*_nodes];
+	_depots = new Depot[CLASSES*_nodes];
 }
 
 PoolBuffers::~PoolBuffers() {
-	clear(true);
+	clear();
+	delete [] _stripes;
+	delete [] _depots;
 }
 
-void PoolBuffers::clear(bool deleting) {
-	lock_guard<mutex> lock(_mutex);
-	for(Buffer* pBuffer : _buffers)
-		delete pBuffer;
-	_buffers.clear();
-	// at least one buffer
-	if (!deleting)
-		_buffers.emplace_back(new Buffer(0));
+void PoolBuffers::setTrimming(UInt32 delay, UInt32 maximum) {
+	_trimDelay = delay;
+	_trimMaximum = maximum;
+}
+
+UInt32 PoolBuffers::available() const {
+	UInt32 count(0);
+	for (UInt32 i = 0; i < _stripesSize*_nodes; ++i) {
+		lock_guard<mutex> lock(_stripes[i].mutex);
+		for (UInt8 j = 0; j < _classes; ++j)
+			count += _stripes[i].magazines[j].size();
+	}
+	for (UInt32 j = 0; j < CLASSES*_nodes; ++j) {
+		lock_guard<mutex> lock(_depots[j].mutex);
+		count += _depots[j].magazines.size()*MAGAZINE_SIZE;
+	}
+	return count;
+}
+
+void PoolBuffers::clear() {
+	for (UInt32 i = 0; i < _stripesSize*_nodes; ++i) {
+		lock_guard<mutex> lock(_stripes[i].mutex);
+		for (UInt8 j = 0; j < _classes; ++j) {
+			for (Buffer* pBuffer : _stripes[i].magazines[j])
+				delete pBuffer;
+			_stripes[i].magazines[j].clear();
+		}
+	}
+	for (UInt32 j = 0; j < CLASSES*_nodes; ++j) {
+		lock_guard<mutex> lock(_depots[j].mutex);
+		for (vector<Buffer*>& magazine : _depots[j].magazines) {
+			for (Buffer* pBuffer : magazine)
+				delete pBuffer;
+		}
+		_depots[j].magazines.clear();
+		_depots[j].idle = 0;
+	}
+}
+
+void PoolBuffers::trim() {
+	if (!_trimDelay)
+		return;
+	for (UInt32 j = 0; j < CLASSES*_nodes; ++j) {
+		Depot& depot(_depots[j]);
+		vector<vector<Buffer*>> surplus;
+		{
+			lock_guard<mutex> lock(depot.mutex);
+			if (!depot.lastTrim.isElapsed(_trimDelay))
+				continue;
+			depot.lastTrim.update();
+			// magazines below the lowest level of the period have not been used, the traffic peak is over
+			if (depot.idle) {
+				surplus.assign(make_move_iterator(depot.magazines.begin()), make_move_iterator(depot.magazines.begin() + depot.idle));
+				depot.magazines.erase(depot.magazines.begin(), depot.magazines.begin() + depot.idle);
+			}
+			depot.idle = depot.magazines.size();
+		}
+		for (vector<Buffer*>& magazine : surplus) {
+			for (Buffer* pBuffer : magazine)
+				delete pBuffer;
+		}
+	}
 }
 
-// static atomic_int n;
+PoolBuffers::Stripe& PoolBuffers::stripe(UInt16& node) const {
+	node = _nodes > 1 ? Util::CurrentNode() : 0;
+	// mix the bits, thread ids are often aligned addresses
+	UInt64 value(hash<thread::id>()(this_thread::get_id()));
+	value ^= value >> 33;
+	value *= 0xff51afd7ed558ccdULL;
+	value ^= value >> 33;
+	return _stripes[node*_stripesSize + value % _stripesSize];
+}
 
 Buffer* PoolBuffers::beginBuffer(UInt32 size) const {
+	UInt8 index(0);
+	while (index < _classes && _ClassSizes[index] < size)
+		++index;
+	if (index == _classes)
+		return new Buffer(size);
+
 	Buffer* pBuffer(NULL);
-	if (size > _maximumCapacity) {
-		pBuffer = new Buffer(size);
-	//	printf("New %d %p\n", ++n,pBuffer);
-		return pBuffer;
-	} else {
-		lock_guard<mutex> lock(_mutex);
-		pBuffer = _buffers.front();
-		_buffers.pop_front();
-		// at least one buffer
-		if (_buffers.empty()) {
-			_buffers.emplace_back(new Buffer(0));
-			_lastEmptyTime.update();
+	UInt16 node;
+	Stripe& stripe(this->stripe(node));
+	{
+		lock_guard<mutex> lock(stripe.mutex);
+		vector<Buffer*>& magazine(stripe.magazines[index]);
+		if (magazine.empty()) {
+			// reload from the depot
+			Depot& depot(_depots[node*CLASSES + index]);
+			lock_guard<mutex> lock(depot.mutex);
+			if (!depot.magazines.empty()) {
+				magazine.swap(depot.magazines.back());
+				depot.magazines.pop_back();
+				if (depot.magazines.size() < depot.idle)
+					depot.idle = depot.magazines.size();
+			}
+		}
+		if (!magazine.empty()) {
+			pBuffer = magazine.back();
+			magazine.pop_back();
 		}
 	}
-	if (size>0)
-		pBuffer->resize(size,false);
-	// printf("get Buffer %u\n",pBuffer->capacity());
-//	printf("Get %d %p\n", ++n,pBuffer);
+	if (!pBuffer)
+		pBuffer = new Buffer(_ClassSizes[index]);
+	pBuffer->resize(size, false);
 	return pBuffer;
 }
 
 void PoolBuffers::endBuffer(Buffer* pBuffer) const {
-	if (pBuffer->capacity() > _maximumCapacity) {
-		delete pBuffer;
-		return;
-	}
 	pBuffer->clear(); //to fix clip, and resize to 0
-	
-	// printf("release Buffer %u\n",pBuffer->capacity());
-//	printf("Release %d %p\n", --n,pBuffer);
-	_mutex.lock();
-	if (_lastEmptyTime.isElapsed(120000)) { // 2 minutes
-		_lastEmptyTime.update();
-		_mutex.unlock();
+	// class of its capacity (which can have grown meanwhile)
+	UInt8 index(_classes);
+	while (index>0 && _ClassSizes[index-1] > pBuffer->capacity())
+		--index;
+	if (index-- == 0 || pBuffer->capacity() > _ClassSizes[_classes-1]) {
 		delete pBuffer;
 		return;
 	}
-	_buffers.emplace_back(pBuffer);
-	_mutex.unlock();
+
+	vector<Buffer*> full;
+	UInt16 node;
+	Stripe& stripe(this->stripe(node));
+	{
+		lock_guard<mutex> lock(stripe.mutex);
+		vector<Buffer*>& magazine(stripe.magazines[index]);
+		magazine.emplace_back(pBuffer);
+		if (magazine.size() < 2*MAGAZINE_SIZE)
+			return;
+		// gives a full magazine to the depot
+		full.assign(magazine.end() - MAGAZINE_SIZE, magazine.end());
+		magazine.resize(MAGAZINE_SIZE);
+	}
+
+	Depot& depot(_depots[node*CLASSES + index]);
+	{
+		lock_guard<mutex> lock(depot.mutex);
+		if (!_trimMaximum || (depot.magazines.size()+1)*MAGAZINE_SIZE <= _trimMaximum) {
+			depot.magazines.emplace_back(move(full));
+			return;
+		}
+	}
+	for (Buffer* pBuffer : full)
+		delete pBuffer;
 }
 
 
@@ -28,43 +28,67 @@ namespace Mona {
 
 UInt32	PoolThread::_Id(0);
 
+bool PoolThread::wakeUp(Exception& ex) {
+	if (!running()) {
+		lock_guard<mutex> lock(_mutex);
+		if (!running() && !start(ex))
+			return false;
+	}
+	Startable::wakeUp();
+	return true;
+}
 
 void PoolThread::run(Exception& exc) {
 
-	for(;;) {
+	WakeUpType wakeUpType(WAKEUP);
 
-		WakeUpType wakeUpType = sleep(120000); // 2 mn sec of timeout
-		
-		for (;;) {
-			WorkThread* pWork;
-			{
-				lock_guard<mutex> lock(_mutex);
-				if(_jobs.empty()) {
-					if (wakeUpType != WAKEUP) { // STOP or TIMEOUT
-						stop(); // to set running=false!
-						return;
-					}
-					break;
-				}
-				pWork = _jobs.front().get();
-			}
+	for(;;) {
 
-			try {
-				Exception ex;
-				EXCEPTION_TO_LOG(pWork->run(ex),pWork->name);
-			} catch (exception& ex) {
-				ERROR(pWork->name,", ",ex.what());
-			} catch (...) {
-				ERROR(pWork->name,", unknown error");
+		PoolThreads::Job job;
+		if (!_jobs.pop(job) && !_pool.steal(*this, job)) {
+			if (_working) {
+				// check again once idle, a job can have been pushed while this thread was seen busy
+				_working = false;
+				continue;
 			}
+			if (wakeUpType == STOP)
+				return; // no more jobs, and stop requested
+			wakeUpType = sleep();
+			continue;
+		}
+		_working = true;
 
-			{
-				lock_guard<mutex> lock(_mutex);
-				_jobs.pop_front();
-			}
+		if (!job.pOrdering) {
+			execute(*job.pWork);
+			continue;
+		}
+		
+		// ordered works, runs the next one of this ordering
+		PoolThreads::Ordering& ordering(*job.pOrdering);
+		ordering.pThread = this;
+		while (!ordering.works.pop(job.pWork)) // a producer is finishing to link its work
+			this_thread::yield();
+		execute(*job.pWork);
+		job.pWork.reset();
+		// remaining works go back at the end of the queue to let run the other jobs meanwhile (and to be stolen if need)
+		if (--ordering.pending) {
+			Exception ex;
+			_pool.push(ex, job, this);
 		}
 	}
 }
 
+void PoolThread::execute(WorkThread& work) {
+	try {
+		Exception ex;
+		EXCEPTION_TO_LOG(work.run(ex),work.name);
+	} catch (exception& ex) {
+		ERROR(work.name,", ",ex.what());
+	} catch (...) {
+		ERROR(work.name,", unknown error");
+	}
+	++_executed;
+}
+
 
 } // namespace Mona
@@ -0,0 +1,142 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#include "Mona/PoolThreads.h"
+#include "Mona/PoolThread.h"
+#include "Mona/Util.h"
+
+
+using namespace std;
+
+
+namespace Mona {
+
+UInt32 PoolThreads::Queue::size() const {
+	return _pOrdering ? _pOrdering->pending.load() : 0;
+}
+
+PoolThreads::PoolThreads(UInt16 threadsAvailable) : _next(0), _overflowSize(0) {
+	if (threadsAvailable == 0)
+		threadsAvailable = Util::ProcessorCount();
+	for (UInt16 i = 0; i < threadsAvailable; ++i)
+		_threads.emplace_back(new PoolThread(*this));
+}
+
+PoolThreads::~PoolThreads() {
+	// join all the threads before to delete one of them (they steal each other)
+	join();
+	for (PoolThread* pThread : _threads)
+		delete pThread;
+}
+
+void PoolThreads::join() {
+	for (PoolThread* pThread : _threads)
+		pThread->join();
+	// jobs enqueued meanwhile by a work on a thread already joined have restarted it
+	for (PoolThread* pThread : _threads)
+		pThread->join();
+}
+
+void PoolThreads::setAffinity(const vector<UInt16>& processors) {
+	vector<UInt16> processor;
+	for (UInt32 i = 0; i < _threads.size(); ++i) {
+		if (!processors.empty())
+			processor.assign(1, processors[i % processors.size()]);
+		_threads[i]->setAffinity(processor);
+	}
+}
+
+UInt32 PoolThreads::queueing() const {
+	UInt32 count(_overflowSize);
+	for (PoolThread* pThread : _threads)
+		count += pThread->queueing();
+	return count;
+}
+
+UInt64 PoolThreads::executed() const {
+	UInt64 count(0);
+	for (PoolThread* pThread : _threads)
+		count += pThread->executed();
+	return count;
+}
+
+UInt64 PoolThreads::stolen() const {
+	UInt64 count(0);
+	for (PoolThread* pThread : _threads)
+		count += pThread->stolen();
+	return count;
+}
+
+bool PoolThreads::enqueue(Exception& ex, const shared_ptr<WorkThread>& pWork, Queue* pQueue) {
+	if (!pQueue)
+		return push(ex, Job(pWork));
+	if (!pQueue->_pOrdering)
+		pQueue->_pOrdering.reset(new Ordering());
+	Ordering& ordering(*pQueue->_pOrdering);
+	ordering.works.push(pWork);
+	if (ordering.pending++)
+		return true; // the thread which runs the previous work will schedule this one
+	return push(ex, Job(pQueue->_pOrdering), ordering.pThread);
+}
+
+bool PoolThreads::push(Exception& ex, const Job& job, PoolThread* pThread) {
+	if (!pThread)
+		pThread = _threads[_next++ % _threads.size()];
+	if (!pThread->_jobs.push(job)) {
+		lock_guard<mutex> lock(_mutexOverflow);
+		_overflow.emplace_back(job);
+		++_overflowSize;
+	}
+	if (!pThread->wakeUp(ex))
+		return false; // the job stays in queue, an other thread can steal it
+	if (!pThread->working())
+		return true;
+	// thread busy, wake up an idle one to steal the job
+	for (PoolThread* pIdle : _threads) {
+		if (pIdle->working())
+			continue;
+		Exception exIdle;
+		pIdle->wakeUp(exIdle);
+		break;
+	}
+	return true;
+}
+
+bool PoolThreads::steal(PoolThread& thief, Job& job) {
+	UInt32 size(_threads.size()), first(_next);
+	for (UInt32 i = 0; i < size; ++i) {
+		PoolThread* pThread(_threads[(first + i) % size]);
+		if (pThread == &thief || !pThread->_jobs.pop(job))
+			continue;
+		++thief._stolen;
+		return true;
+	}
+	if (!_overflowSize)
+		return false;
+	lock_guard<mutex> lock(_mutexOverflow);
+	if (_overflow.empty())
+		return false;
+	job = move(_overflow.front());
+	_overflow.pop_front();
+	--_overflowSize;
+	return true;
+}
+
+
+} // namespace Mona
@@ -19,6 +19,27 @@ This file is a part of Mona.
 
 
 #include "Mona/Socket.h"
+#if _OS == _OS_LINUX
+#include <linux/sock_diag.h>
+#endif
+#include <atomic>
+#include <chrono>
+#if defined(_WIN32)
+#include <io.h>
+#elif _OS == _OS_LINUX
+#include <sys/sendfile.h>
+#else
+#include <unistd.h>
+#endif
+#if _OS == _OS_LINUX
+#include <netinet/udp.h>
+#ifndef SOL_UDP
+#define SOL_UDP			17
+#endif
+#ifndef UDP_SEGMENT
+#define UDP_SEGMENT		103
+#endif
+#endif
 
 using namespace std;
 
@@ -74,6 +95,18 @@ public:
 #endif
 	}
 
+	UInt32 drops() const {
+#if _OS == _OS_LINUX && defined(SO_MEMINFO)
+		Exception ex;
+		UInt32 meminfo[SK_MEMINFO_VARS];
+		memset(meminfo, 0, sizeof(meminfo));
+		getOption(ex, SOL_SOCKET, SO_MEMINFO, meminfo);
+		return meminfo[SK_MEMINFO_DROPS];
+#else
+		return 0;
+#endif
+	}
+
 	SocketAddress& address(Exception& ex, SocketAddress& address) const {
 		ASSERT_RETURN(_initialized, address)
 		union {
@@ -121,6 +154,16 @@ public:
 		_pManagedSocket(NULL),
 		manager(manager),
 		_writing(false),
+		_sendBatch(false),
+		_egressWriting(false),
+		_gso(true),
+		_sentDatagrams(0),
+		_sendCalls(0),
+		_sendLatency(0),
+		_queueing(0),
+		_congested(false),
+		_highWatermark(0),
+		_lowWatermark(0),
 		SocketFile(NET_INVALID_SOCKET) {
 	}
 
@@ -133,7 +176,17 @@ public:
 		_pManagedSocket(NULL),
 		manager(manager),
 		_writing(false),
-		SocketFile(file._sockfd) {
+		_sendBatch(false),
+		_egressWriting(false),
+		_gso(true),
+		_sentDatagrams(0),
+		_sendCalls(0),
+		_sendLatency(0),
+		_queueing(0),
+		_congested(false),
+		_highWatermark(0),
+		_lowWatermark(0),
+		SocketFile(file._sockfd, file._nonBlocking) {
 
 		file._sockfd = NET_INVALID_SOCKET;
 		setNoSigPipe();
@@ -148,17 +201,58 @@ public:
 	}
 
 	void release() {
-		lock_guard<recursive_mutex> lock(_mutexManaged);
-		if (!_pSocket)
-			return;
-		if (_pManagedSocket) {
+		bool managed;
+		{
+			lock_guard<recursive_mutex> lock(_mutexManaged);
+			if (!_pSocket)
+				return;
+			managed = _pManagedSocket != NULL;
+			_pManagedSocket = NULL; // a writable event caught meanwhile flushes nothing now
+			_pSocket = NULL;
+			lock_guard<mutex>	lockSenders(_mutexAsync);
+			_senders.clear();
+			_queueing = 0;
+			_congested = false;
+			_connecting = false;
+			lock_guard<mutex>	lockEgress(_mutexEgress);
+			_egress.clear();
+		}
+		// outside of _mutexManaged, because the removing waits the end of a writable event which flushes under it
+		if (managed)
 			manager.remove(_sockfd);
-			_pManagedSocket = NULL;
+	}
+
+	bool sendBatch() const { return _sendBatch; }
+	void setSendBatch(bool enable) {
+#if _OS == _OS_LINUX
+		_sendBatch = enable;
+#endif
+	}
+	void sendBatchStats(UInt64& datagrams, UInt64& calls, UInt64& latency) {
+		datagrams = _sentDatagrams.exchange(0);
+		calls = _sendCalls.exchange(0);
+		latency = _sendLatency.exchange(0);
+	}
+
+	UInt32 highWatermark() const { return _highWatermark; }
+	UInt32 lowWatermark() const { return _lowWatermark; }
+	void setWatermarks(UInt32 high, UInt32 low) {
+		lock_guard<mutex> lock(_mutexAsync);
+		_highWatermark = high;
+		_lowWatermark = low < high ? low : high;
+		congest();
+	}
+	UInt32 queueing() const { return _queueing; }
+	bool congested() const { return _congested; }
+
+	// Called by the socketmanager thread when the socket becomes writable (edge-triggered), so connection is established too
+	bool onWritable(Exception& ex) {
+		lock_guard<recursive_mutex>	lock(_mutexManaged);
+		{
+			lock_guard<mutex> lockAsync(_mutexAsync);
+			_connecting = false;
 		}
-		_pSocket = NULL;
-		lock_guard<mutex>	lockSenders(_mutexAsync);
-		_senders.clear();
-		_connecting = false;
+		return flush(ex);
 	}
 
 	// Can be called by a separated thread (socketmanager handle thread)
@@ -179,10 +273,17 @@ public:
 		NET_SOCKLEN addrSize = sizeof(addr);
 		NET_SOCKET sockfd;
 		do {
+#if _OS == _OS_LINUX
+			// non blocking and close-on-exec in the same system call
+			sockfd = ::accept4(_sockfd, (sockaddr*)&addr, &addrSize, SOCK_NONBLOCK | SOCK_CLOEXEC);
+#else
 			sockfd = ::accept(_sockfd, (sockaddr*)&addr, &addrSize);  // TODO acceptEx?
+#endif
 		} while (sockfd == NET_INVALID_SOCKET && Net::LastError() == NET_EINTR);
 		if (sockfd == NET_INVALID_SOCKET) {
-			Net::SetError(ex);
+			int err = Net::LastError();
+			if (err != NET_EAGAIN && err != NET_EWOULDBLOCK) // else no more connection to accept
+				Net::SetError(ex, err);
 			return NET_INVALID_SOCKET;
 		}
 		address.set((sockaddr&)addr);
@@ -291,6 +392,81 @@ public:
 	}
 
 
+	int sendBytes(Exception& ex, UInt32 count, const void** buffers, const int* lengths, int flags) {
+		ASSERT_RETURN(_initialized, 0);
+		if (count == 0)
+			return 0;
+		enum { MAX_COUNT = 64 };
+		if (count > MAX_COUNT)
+			count = MAX_COUNT;
+		int rc;
+#if defined(_WIN32)
+		WSABUF	bufs[MAX_COUNT];
+		for (UInt32 i = 0; i < count; ++i) {
+			bufs[i].buf = (char*)buffers[i];
+			bufs[i].len = lengths[i];
+		}
+		DWORD sent(0);
+		rc = ::WSASend(_sockfd, bufs, count, &sent, flags, NULL, NULL) == 0 ? (int)sent : -1;
+#else
+		struct iovec	iovs[MAX_COUNT];
+		for (UInt32 i = 0; i < count; ++i) {
+			iovs[i].iov_base = (void*)buffers[i];
+			iovs[i].iov_len = lengths[i];
+		}
+		struct msghdr	msg;
+		memset(&msg, 0, sizeof(msg));
+		msg.msg_iov = iovs;
+		msg.msg_iovlen = count;
+		do {
+			rc = ::sendmsg(_sockfd, &msg, flags);
+		} while (rc < 0 && Net::LastError() == NET_EINTR);
+#endif
+		if (rc < 0) {
+			int err = Net::LastError();
+			if (err == NET_EAGAIN || err == NET_EWOULDBLOCK)
+				return 0;
+			Net::SetError(ex, err);
+		}
+		return rc;
+	}
+
+
+	int sendFile(Exception& ex, int file, UInt64 offset, int length) {
+		ASSERT_RETURN(_initialized, 0);
+#if _OS == _OS_LINUX
+		int rc;
+		off_t position(offset);
+		do {
+			rc = ::sendfile(_sockfd, file, &position, length);
+		} while (rc < 0 && Net::LastError() == NET_EINTR);
+		if (rc < 0) {
+			int err = Net::LastError();
+			if (err == NET_EAGAIN || err == NET_EWOULDBLOCK)
+				return 0;
+			Net::SetError(ex, err);
+		} else if (rc == 0)
+			ex.set(Exception::FILE, "File to send shorter than expected");
+		return rc;
+#else
+		// read and send, what is not sent will be read again on the next call
+		char buffer[65536];
+		if (length > (int)sizeof(buffer))
+			length = sizeof(buffer);
+#if defined(_WIN32)
+		int size = _lseeki64(file, offset, SEEK_SET) < 0 ? -1 : _read(file, buffer, length);
+#else
+		int size = ::pread(file, buffer, length, offset);
+#endif
+		if (size <= 0) {
+			ex.set(Exception::FILE, "Impossible to read the file to send");
+			return -1;
+		}
+		return sendBytes(ex, buffer, size, 0);
+#endif
+	}
+
+
 	int receiveBytes(Exception& ex, void* buffer, int length, int flags) {
 		ASSERT_RETURN(_initialized, 0);
 		int rc;
@@ -300,7 +476,7 @@ public:
 		if (rc < 0) {
 			int err = Net::LastError();
 			if (err == NET_EAGAIN || err == NET_EWOULDBLOCK)
-				return 0;
+				return -1;
 			Net::SetError(ex, err);
 		}
 		return rc;
@@ -316,6 +492,9 @@ public:
 		if (allowBroadcast && address.host().isAnyBroadcast())
 			setOption(ex, SOL_SOCKET, SO_BROADCAST,1); // ex is warning here
 
+		if (_sendBatch && _pManagedSocket)
+			return queue(buffer, length, address);
+
 		int rc;
 		do {
 			rc = ::sendto(_sockfd, (const char*)buffer, length, flags, address.addr(), address.size());
@@ -346,13 +525,71 @@ public:
 		if (rc < 0) {
 			int err = Net::LastError();
 			if (err == NET_EAGAIN || err == NET_EWOULDBLOCK)
-				return 0;
+				return -1;
 			Net::SetError(ex, err);
 		}
 		address.set((sockaddr&)addr);
 		return rc;
 	}
 
+	int receiveFrom(Exception& ex, UInt32 count, void** buffers, int* lengths, SocketAddress** addresses, int flags) {
+		if (count == 0)
+			return 0;
+		if (!_initialized && !init(ex, addresses[0]->family()))
+			return 0;
+#if _OS == _OS_LINUX
+		union Address {
+			struct sockaddr_in  sa_in;
+			struct sockaddr_in6 sa_in6;
+		};
+		enum { MAX_COUNT = 64 };
+		if (count > MAX_COUNT)
+			count = MAX_COUNT;
+		Address			addrs[MAX_COUNT];
+		struct iovec	iovs[MAX_COUNT];
+		struct mmsghdr	msgs[MAX_COUNT];
+		memset(msgs, 0, sizeof(struct mmsghdr)*count);
+		for (UInt32 i = 0; i < count; ++i) {
+			iovs[i].iov_base = buffers[i];
+			iovs[i].iov_len = lengths[i];
+			msgs[i].msg_hdr.msg_name = &addrs[i];
+			msgs[i].msg_hdr.msg_namelen = sizeof(Address);
+			msgs[i].msg_hdr.msg_iov = &iovs[i];
+			msgs[i].msg_hdr.msg_iovlen = 1;
+		}
+		int rc;
+		do {
+			rc = ::recvmmsg(_sockfd, msgs, count, flags, NULL);
+		} while (rc < 0 && Net::LastError() == NET_EINTR);
+		if (rc < 0) {
+			int err = Net::LastError();
+			if (err != NET_EAGAIN && err != NET_EWOULDBLOCK)
+				Net::SetError(ex, err);
+			return 0;
+		}
+		for (int i = 0; i < rc; ++i) {
+			lengths[i] = (msgs[i].msg_hdr.msg_flags & MSG_TRUNC) ? -1 : msgs[i].msg_len;
+			addresses[i]->set((sockaddr&)addrs[i]);
+		}
+		return rc;
+#else
+		UInt32 received(0);
+		while (received < count) {
+			int rc = receiveFrom(ex, buffers[received], lengths[received], *addresses[received], flags);
+			if (ex) {
+				if (Net::LastError() != NET_EMSGSIZE)
+					break;
+				// truncated datagram (WSAEMSGSIZE)
+				ex.set(Exception::NIL);
+				rc = -1;
+			} else if (rc <= 0)
+				break; // nothing more to read
+			lengths[received++] = rc;
+		}
+		return received;
+#endif
+	}
+
 
 	bool canSend(Exception& ex) {
 		lock_guard<mutex> lock(_mutexAsync);
@@ -362,9 +599,23 @@ public:
 		lock_guard<recursive_mutex>	lock(_mutexManaged);
 		if (!managed(ex)) // check init already, so _sockfd is good!
 			return false;
-		lock_guard<mutex> lockAsync(_mutexAsync);
-		_senders.emplace_back(pSender);
-		return _writing = manager.startWrite(_sockfd,_pManagedSocket);
+		bool connecting;
+		{
+			lock_guard<mutex> lockAsync(_mutexAsync);
+			_senders.emplace_back(pSender);
+			_queueing += (pSender->_queued = pSender->queueing());
+			congest();
+			if (!(_writing = manager.startWrite(_sockfd, _pManagedSocket)))
+				return false;
+			connecting = _connecting;
+		}
+#if !defined(_WIN32)
+		// edge-triggered: socket can have become writable before the sender addition, so tries again now
+		// (an EAGAIN now guarantees a next writable event, and connection establishment will flush it)
+		if (!connecting)
+			flush(ex);
+#endif
+		return true;
 	}
 
 		
@@ -374,36 +625,260 @@ public:
 		lock_guard<recursive_mutex>	lock(_mutexManaged);
 		if (!_pManagedSocket)
 			return true; // mean no Senders queue!!
+		// datagrams queued first, senders are here just if the queue was full
+		if (!flushEgress(ex))
+			return false; // socket buffer full, writing is always started
 		lock_guard<mutex>	lockAsync(_mutexAsync);
 		while (!_senders.empty()) {
+			// a file part is sent alone by SocketSender::flush
+			if (_senders.size() > 1 && _senders.front()->stream() && _senders.front()->availableData()) {
+				if (!flushStream(ex)) {
+					if (!_writing)
+						_writing = manager.startWrite(_sockfd,_pManagedSocket);
+					return false;
+				}
+				continue;
+			}
 			if (!_senders.front()->flush(ex,*_pSocket)) {
 				if (!_writing)
 					_writing = manager.startWrite(_sockfd,_pManagedSocket);
 				return false;
 			}
-			_senders.pop_front();
+			popSender();
 		}
-		if (_writing)
-			_writing = !manager.stopWrite(_sockfd,_pManagedSocket);
+		lock_guard<mutex>	lockEgress(_mutexEgress);
+		if (!_egress.empty())
+			return false; // datagrams queued meanwhile, writing is always started
+		if (_writing || _egressWriting)
+			_writing = _egressWriting = !manager.stopWrite(_sockfd,_pManagedSocket);
 		return true;
 	}
 
 	
+	// Is called from onReadable (by the handler thread of the socket manager)
+	void yieldReading() {
+		lock_guard<recursive_mutex>	lock(_mutexManaged);
+		if (_pManagedSocket)
+			manager.yieldReading(_sockfd, _pManagedSocket);
+	}
+
 	bool managed(Exception& ex) {
 		ASSERT_RETURN(_initialized, false);
 		lock_guard<recursive_mutex>	lock(_mutexManaged);
 		if (_pManagedSocket)
 			return true;
 		ASSERT_RETURN(_pSocket!=NULL,false)
-		ioctl(ex,FIONBIO, 1); // set non blocking mode (usefull for posix)
-		if (ex)
+		if (!_nonBlocking) {
+			ioctl(ex,FIONBIO, 1); // set non blocking mode (usefull for posix)
+			if (ex)
+				return false;
+			_nonBlocking = true;
+		}
+		if (!(_pManagedSocket = manager.add(ex, _sockfd, *_pSocket)))
 			return false;
-		return (_pManagedSocket=manager.add(ex,_sockfd, *_pSocket))!=NULL;
+#if !defined(_WIN32)
+		_writing = true; // the socket manager waits the first writable event to catch the connection establishment
+#endif
+		return true;
 	}
 	
 
 private:
 
+	struct Datagram : virtual Mona::Object {
+		Datagram(const PoolBuffers& poolBuffers, const void* data, int size, const SocketAddress& address) : pBuffer(poolBuffers,size), address(address), time(Clock()) {
+			memcpy(pBuffer->data(), data, size);
+		}
+		PoolBuffer		pBuffer;
+		SocketAddress	address;
+		Int64			time;
+	};
+
+	static Int64 Clock() { return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count(); }
+
+	// Can be called by any thread, the datagram is sent on the next writable event by the manager socket thread
+	int queue(const void* buffer, int length, const SocketAddress& address) {
+		lock_guard<mutex> lock(_mutexEgress);
+		if (_egress.size() >= 4096)
+			return 0; // congested, the sender will be buffered as for a EAGAIN error
+		_egress.emplace_back(manager.poolBuffers, buffer, length, address);
+		if (_egress.size() == 1 && !(_egressWriting = manager.requestFlush(_sockfd, _pManagedSocket))) {
+			_egress.pop_back();
+			return 0;
+		}
+		return length;
+	}
+
+	// Gathers the pending data of the first stream senders in one writev call, without copying them,
+	// returns false if the socket buffer is full (called under _mutexAsync)
+	bool flushStream(Exception& ex) {
+		enum { MAX_COUNT = 64 };
+		const void*	buffers[MAX_COUNT];
+		int			lengths[MAX_COUNT];
+		UInt32		totals[MAX_COUNT]; // size gathered by sender
+		UInt32 count(0), senders(0);
+		for (const shared_ptr<SocketSender>& pSender : _senders) {
+			if (count == MAX_COUNT || !pSender->stream())
+				break;
+			// the parts of a sender (data and shared buffers)
+			UInt32 parts(pSender->pending(buffers + count, lengths + count, MAX_COUNT - count));
+			totals[senders] = 0;
+			while (parts--)
+				totals[senders] += lengths[count++];
+			++senders;
+			if (pSender->_filePosition < pSender->_fileEnd)
+				break; // its file has to be sent before the next senders
+		}
+		int sent = sendBytes(ex, count, buffers, lengths, 0);
+		for (UInt32 i = 0; i < senders; ++i) {
+			SocketSender& sender(*_senders.front());
+			if (ex) {
+				// terminate the sender, as SocketSender::flush does
+				sender.consume(totals[i]);
+			} else if ((UInt32)sent < totals[i]) {
+				// partially sent, the rest is kept in the sender buffer (see Socket::send)
+				sender.consume(sent);
+				return false;
+			} else if (!sender.consume(totals[i])) {
+				// more parts than gathered, remains the first sender
+				return true;
+			} else
+				sent -= totals[i];
+			popSender();
+		}
+		return true;
+	}
+
+	// called under _mutexAsync
+	void popSender() {
+		_queueing -= _senders.front()->_queued;
+		_senders.pop_front();
+		congest();
+	}
+
+	// Hysteresis between the watermarks, called under _mutexAsync
+	void congest() {
+		if (!_highWatermark)
+			_congested = false;
+		else if (_queueing > _highWatermark)
+			_congested = true;
+		else if (_queueing <= _lowWatermark)
+			_congested = false;
+	}
+
+	// Sends queued datagrams, returns false if the socket buffer is full
+	bool flushEgress(Exception& ex) {
+		for (;;) {
+			{
+				lock_guard<mutex> lock(_mutexEgress);
+				// deque::push_back keeps element references valid, so the queue can grow during sending
+				_batch.clear();
+				for (Datagram& datagram : _egress) {
+					_batch.emplace_back(&datagram);
+					if (_batch.size() == 256)
+						break;
+				}
+			}
+			if (_batch.empty())
+				return true;
+			bool blocked(false);
+			UInt32 done(sendDatagrams(ex, blocked));
+			{
+				lock_guard<mutex> lock(_mutexEgress);
+				while (done--)
+					_egress.pop_front();
+			}
+			if (blocked)
+				return false;
+		}
+	}
+
+	// Groups consecutive datagrams to a same destination in one UDP_SEGMENT message (all with the same size, excepting the last one which can be shorter),
+	// and sends messages with sendmmsg. Returns the count of datagrams done (sent or failed)
+	UInt32 sendDatagrams(Exception& ex, bool& blocked) {
+#if _OS == _OS_LINUX
+		enum { MAX_MESSAGES = 64, MAX_SEGMENTS = 64, MAX_GSO_SIZE = 65000 };
+		struct mmsghdr	msgs[MAX_MESSAGES];
+		struct iovec	iovs[256];
+		char			controls[MAX_MESSAGES][CMSG_SPACE(sizeof(UInt16))];
+		UInt32			segments[MAX_MESSAGES];
+		UInt32			messages(0), count(0);
+		memset(msgs, 0, sizeof(msgs));
+		while (count < _batch.size() && messages < MAX_MESSAGES) {
+			Datagram& first(*_batch[count]);
+			UInt32 size(first.pBuffer->size()), total(size), run(1);
+			iovs[count].iov_base = first.pBuffer->data();
+			iovs[count].iov_len = size;
+			while (_gso && (count + run) < _batch.size() && run < MAX_SEGMENTS) {
+				Datagram& next(*_batch[count + run]);
+				UInt32 nextSize(next.pBuffer->size());
+				if (nextSize>size || (total+nextSize)>MAX_GSO_SIZE || next.address != first.address)
+					break;
+				iovs[count + run].iov_base = next.pBuffer->data();
+				iovs[count + run].iov_len = nextSize;
+				total += nextSize;
+				++run;
+				if (nextSize < size)
+					break; // a shorter datagram ends the segmentation
+			}
+			msghdr& msg(msgs[messages].msg_hdr);
+			msg.msg_name = (void*)first.address.addr();
+			msg.msg_namelen = first.address.size();
+			msg.msg_iov = &iovs[count];
+			msg.msg_iovlen = run;
+			if (run > 1) {
+				msg.msg_control = controls[messages];
+				msg.msg_controllen = sizeof(controls[messages]);
+				cmsghdr* pControl(CMSG_FIRSTHDR(&msg));
+				pControl->cmsg_level = SOL_UDP;
+				pControl->cmsg_type = UDP_SEGMENT;
+				pControl->cmsg_len = CMSG_LEN(sizeof(UInt16));
+				UInt16 segment(size);
+				memcpy(CMSG_DATA(pControl), &segment, sizeof(segment));
+			}
+			segments[messages++] = run;
+			count += run;
+		}
+
+		UInt32 message(0), done(0);
+		while (message < messages) {
+			int rc;
+			do {
+				rc = ::sendmmsg(_sockfd, msgs + message, messages - message, 0);
+			} while (rc < 0 && Net::LastError() == NET_EINTR);
+			++_sendCalls;
+			if (rc < 0) {
+				int err = Net::LastError();
+				if (err == NET_EAGAIN || err == NET_EWOULDBLOCK) {
+					blocked = true;
+					break;
+				}
+				if (segments[message]>1 && (err == EIO || err == EINVAL)) {
+					// UDP_SEGMENT unsupported (kernel<4.18 or no checksum offload), resend without it
+					_gso = false;
+					break;
+				}
+				Net::SetError(ex, err); // just this message is lost (ex is a warning here)
+				done += segments[message++];
+				continue;
+			}
+			Int64 now(Clock()), latency(0);
+			UInt32 sent(0);
+			for (int i = 0; i < rc; ++i) {
+				for (UInt32 j = 0; j < segments[message]; ++j)
+					latency += now - _batch[done + j]->time;
+				sent += segments[message];
+				done += segments[message++];
+			}
+			_sentDatagrams += sent;
+			_sendLatency += latency;
+		}
+		return done;
+#else
+		return _batch.size();
+#endif
+	}
+
 	bool init(Exception& ex, IPAddress::Family family) {
 		lock_guard<mutex>	lock(_mutexInit);
 		if (_initialized)
@@ -463,6 +938,23 @@ private:
 	deque<shared_ptr<SocketSender>>	_senders;
 	volatile bool					_connecting;
 
+	// send queue watermarks
+	atomic<UInt32>					_queueing;
+	atomic<bool>					_congested;
+	UInt32							_highWatermark;
+	UInt32							_lowWatermark;
+
+	// batch sending
+	volatile bool					_sendBatch;
+	mutex							_mutexEgress;
+	deque<Datagram>					_egress;
+	bool							_egressWriting;
+	vector<Datagram*>				_batch; // used just by the flushing thread
+	bool							_gso;
+	atomic<UInt64>					_sentDatagrams;
+	atomic<UInt64>					_sendCalls;
+	atomic<UInt64>					_sendLatency;
+
 	mutex							_mutexInit;
 	volatile bool					_initialized; // to protect _sockfd access
 };
@@ -490,18 +982,23 @@ void Socket::close() {
 		return;
 	if (_owner)
 		_pImpl->release();
+	bool sendBatch(_pImpl->sendBatch());
+	UInt32 highWatermark(_pImpl->highWatermark()), lowWatermark(_pImpl->lowWatermark());
 	_pImpl.reset(new SocketImpl(*this, _pImpl->manager, _pImpl->type));
+	_pImpl->setSendBatch(sendBatch);
+	_pImpl->setWatermarks(highWatermark, lowWatermark);
 }
 
 void Socket::onError(const Exception& ex) { _events.onError(ex); }
-void Socket::onReadable(Exception& ex,UInt32 available) { _events.onReadable(ex,available); }
+bool Socket::onReadable(Exception& ex) { return _events.onReadable(ex); }
+bool Socket::onWritable(Exception& ex) { return _pImpl->onWritable(ex); }
 bool Socket::onConnection() { return _pImpl->onConnection(); }
 
 bool		Socket::canSend(Exception& ex) { return _pImpl->canSend(ex); }
 bool		Socket::addSender(Exception& ex, std::shared_ptr<SocketSender> pSender) { return _pImpl->addSender(ex,pSender); }
 bool		Socket::flush(Exception& ex) {return _pImpl->flush(ex);}
 
-SocketFile	Socket::acceptConnection(Exception& ex,SocketAddress& address) { return SocketFile(_pImpl->acceptConnection(ex,address)); }
+SocketFile	Socket::acceptConnection(Exception& ex,SocketAddress& address) { return SocketFile(_pImpl->acceptConnection(ex,address), _OS == _OS_LINUX); } // accept4 gives it in non blocking mode on linux
 UInt32	 Socket::available(Exception& ex) const { return _pImpl->available(ex); }
 bool Socket::connect(Exception& ex, const SocketAddress& address,bool allowBroadcast) { return _pImpl->connect(ex,address,allowBroadcast); }
 bool Socket::bind(Exception& ex, const SocketAddress& address, bool reuseAddress) { return _pImpl->bind(ex,address,reuseAddress); }
@@ -510,8 +1007,11 @@ void Socket::shutdown(Exception& ex, ShutdownType type) { return _pImpl->shutdow
 	
 int Socket::receiveBytes(Exception& ex, void* buffer, int length, int flags) { return _pImpl->receiveBytes(ex,buffer,length,flags); }
 int	Socket::receiveFrom(Exception& ex, void* buffer, int length, SocketAddress& address, int flags) { return _pImpl->receiveFrom(ex,buffer,length,address,flags); }
+int	Socket::receiveFrom(Exception& ex, UInt32 count, void** buffers, int* lengths, SocketAddress** addresses, int flags) { return _pImpl->receiveFrom(ex,count,buffers,lengths,addresses,flags); }
 
 int Socket::sendBytes(Exception& ex, const void* buffer, int length, int flags)  { return _pImpl->sendBytes(ex,buffer,length,flags); }
+int Socket::sendBytes(Exception& ex, UInt32 count, const void** buffers, const int* lengths, int flags)  { return _pImpl->sendBytes(ex,count,buffers,lengths,flags); }
+int Socket::sendFile(Exception& ex, int file, UInt64 offset, int length) { return _pImpl->sendFile(ex,file,offset,length); }
 int	Socket::sendTo(Exception& ex, const void* buffer, int length, const SocketAddress& address, bool allowBroadcast, int flags)  { return _pImpl->sendTo(ex,buffer,length,address,allowBroadcast,flags); }
 
 
@@ -541,8 +1041,16 @@ bool Socket::getOOBInline(Exception& ex) const { return _pImpl->getOOBInline(ex)
 void Socket::setLinger(Exception& ex,bool on, int seconds) { _pImpl->setLinger(ex,on,seconds); }
 bool Socket::getLinger(Exception& ex, int& seconds) const { return _pImpl->getLinger(ex,seconds); }
 
+void Socket::setSendBatch(bool enable) { _pImpl->setSendBatch(enable); }
+void Socket::sendBatchStats(UInt64& datagrams, UInt64& calls, UInt64& latency) { _pImpl->sendBatchStats(datagrams, calls, latency); }
+void Socket::setWatermarks(UInt32 high, UInt32 low) { _pImpl->setWatermarks(high, low); }
+UInt32 Socket::queueing() const { return _pImpl->queueing(); }
+bool Socket::congested() const { return _pImpl->congested(); }
+void Socket::yieldReading() { _pImpl->yieldReading(); }
+
 void Socket::setReusePort(bool flag) { _pImpl->setReusePort(flag); }
 bool Socket::getReusePort() const  { return _pImpl->getReusePort(); }
+UInt32 Socket::drops() const  { return _pImpl->drops(); }
 
 int Socket::IOCTL(Exception& ex,NET_SOCKET sockfd,NET_IOCTLREQUEST request,int value) {
 	ASSERT_RETURN(sockfd!=NET_INVALID_SOCKET, value)
@@ -19,6 +19,10 @@ This file is a part of Mona.
 
 #include "Mona/SocketManager.h"
 #include "Mona/Socket.h"
+#include "Mona/Util.h"
+#include <map>
+#include <deque>
+#include <atomic>
 #if !defined(_WIN32)
 #include <unistd.h>
 #include "sys/epoll.h"
@@ -36,16 +40,128 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT uMsg, WPARAM wParam, LPARAM lParam) {
 #endif
 
 
-SocketManager::SocketManager(TaskHandler& handler, const PoolBuffers& poolBuffers, PoolThreads& poolThreads, UInt32 bufferSize, const string& name) : poolBuffers(poolBuffers),
-   _selfHandler(false), poolThreads(poolThreads), _eventFD(0), _sockfd(NET_INVALID_SOCKET), _eventSystem(0), bufferSize(bufferSize), Startable(name), Task(handler), _currentEvent(0), _currentError(0), _initSignal(false), _ppSocket(NULL),_counter(0) {
+// State of a managed socket, the Socket** given to SocketImpl points on pSocket (first member)
+struct ManagedSocket {
+	ManagedSocket(Socket& socket, NET_SOCKET sockfd) : pSocket(&socket), sockfd(sockfd), reading(false), again(false), yielding(false),
+#if defined(_WIN32)
+		writing(false) {}
+#else
+		writing(true) {} // to catch the first writable event (connection establishment)
+#endif
+
+	Socket*						pSocket; // NULL when removed
+	const NET_SOCKET			sockfd;
+	std::recursive_mutex		mutex; // to avoid a removing while socket is used
+	std::atomic<bool>			reading; // a reception event is posted or is reading
+	std::atomic<bool>			again; // a reception event has been caught during the reading (edge-triggered)
+	std::atomic<bool>			yielding; // the reading ends before EAGAIN and continues behind the other ready sockets
+	std::atomic<bool>			writing; // writable events are expected
+	std::weak_ptr<ManagedSocket>	weak;
+};
+
+
+class SocketEvent;
+class SocketReactor : private Task, private Startable, private TaskHandler, virtual Object {
+	friend class SocketEvent;
+public:
+	SocketReactor(TaskHandler& handler, UInt32 bufferSize, const string& name);
+	SocketReactor(UInt32 bufferSize, const string& name);
+	virtual ~SocketReactor() { stop(); }
+
+	bool					start(Exception& ex);
+	void					stop();
+
+	bool					running() const { return Startable::running(); }
+	void					setAffinity(const vector<UInt16>& processors) { Startable::setAffinity(processors); }
+
+	Socket**				add(Exception& ex,NET_SOCKET sockfd,Socket& socket) const;
+	void					remove(NET_SOCKET sockfd) const;
+	bool					startWrite(NET_SOCKET sockfd,Socket** ppSocket) const;
+	bool					stopWrite(NET_SOCKET sockfd,Socket** ppSocket) const;
+	bool					requestFlush(NET_SOCKET sockfd,Socket** ppSocket) const;
+	void					yieldReading(NET_SOCKET sockfd,Socket** ppSocket) const;
+
+private:
+#if defined(_WIN32)
+	// updates the socket registration in the event system (FD_WRITE just if writing)
+	bool					arm(ManagedSocket& managed) const;
+#else
+	// wakes up the event system thread to release removed sockets, to flush sockets or to read again yielding sockets
+	bool					wakeUp() const;
+	size_t					wakeUps() const { return _removedSockets.size() + _flushSockets.size() + _readSockets.size(); }
+#endif
+	// handler thread side, for one socket
+	void					handle(ManagedSocket& managed,UInt32 events,int error,Exception& exception);
+	// returns false if the socket has been removed
+	bool					read(ManagedSocket& managed,UInt32 events,int error,Exception& exception);
+	// returns false if the event can't be posted for the moment (handler queue full)
+	bool					post(const shared_ptr<SocketEvent>& pEvent);
+
+	void					requestHandle();
+	void					run(Exception& ex);
+	void					handle(Exception& ex);
+
+	TaskHandler&						_handler;
+	const UInt32						_bufferSize;
+	bool								_selfHandler;
+	Exception							_ex;
+
+	mutable  std::atomic<int>			_counter;
+	mutable  Signal						_initSignal;
+	mutable std::recursive_mutex		_mutex;
+
+    mutable std::map<NET_SOCKET, shared_ptr<ManagedSocket>>		_sockets;
+	mutable vector<shared_ptr<ManagedSocket>>						_removedSockets; // released by the event system thread when no more used
+	mutable vector<shared_ptr<ManagedSocket>>						_flushSockets; // flushed by the event system thread
+	mutable vector<shared_ptr<ManagedSocket>>						_readSockets; // posted again by the event system thread behind the ready sockets
+
+#if defined(_WIN32)
+    HWND								_eventSystem;
+#else
+	int									_eventSystem;
+#endif
+	int									_eventFD; // used just in linux case
+	
+	// used just in windows case, where events are handled synchronously
+	UInt32								_currentEvent;
+	int									_currentError;
+	Exception							_currentException;
+	shared_ptr<ManagedSocket>			_pCurrentSocket;
+};
+
+
+// Event of one socket, posted by the event system thread to be handled later by the handler thread
+class SocketEvent : public Task, virtual Object {
+public:
+	SocketEvent(SocketReactor& reactor, const shared_ptr<ManagedSocket>& pManaged, UInt32 events, int error, const Exception& exception) : Task(reactor._handler),
+		_reactor(reactor), _pManaged(pManaged), _events(events), _error(error) {
+		if (exception)
+			_exception.set(exception);
+	}
+
+	ManagedSocket&	managed() { return *_pManaged; }
+
+private:
+	void handle(Exception& ex) { _reactor.handle(*_pManaged, _events, _error, _exception); }
+
+	SocketReactor&					_reactor;
+	const shared_ptr<ManagedSocket>	_pManaged;
+	const UInt32					_events;
+	const int						_error;
+	Exception						_exception;
+};
+
+
+SocketReactor::SocketReactor(TaskHandler& handler, UInt32 bufferSize, const string& name) : _handler(handler),
+   _selfHandler(false), _eventFD(0), _eventSystem(0), _bufferSize(bufferSize), Startable(name), Task(handler), _currentEvent(0), _currentError(0), _initSignal(false),_counter(0) {
 
 }
-SocketManager::SocketManager(const PoolBuffers& poolBuffers, PoolThreads& poolThreads, UInt32 bufferSize, const string& name) : poolBuffers(poolBuffers),
-   _selfHandler(true), poolThreads(poolThreads), _eventFD(0), _sockfd(NET_INVALID_SOCKET), _eventSystem(0), bufferSize(bufferSize), Startable(name), Task((TaskHandler&)*this), _currentEvent(0), _currentError(0), _initSignal(false), _ppSocket(NULL),_counter(0) {
+SocketReactor::SocketReactor(UInt32 bufferSize, const string& name) : _handler(*this),
+   _selfHandler(true), _eventFD(0), _eventSystem(0), _bufferSize(bufferSize), Startable(name), Task((TaskHandler&)*this), _currentEvent(0), _currentError(0), _initSignal(false),_counter(0) {
 
 }
 
-bool SocketManager::start(Exception& ex) {
+bool SocketReactor::start(Exception& ex) {
 	if (Startable::running())
 		return true;
 	_initSignal.reset();
@@ -53,7 +169,7 @@ bool SocketManager::start(Exception& ex) {
 	return Startable::start(ex);
 }
 
-void SocketManager::stop() {
+void SocketReactor::stop() {
 	if (!Startable::running())
 		return;
 	TaskHandler::stop();
@@ -71,7 +187,7 @@ void SocketManager::stop() {
 
 
 
-Socket** SocketManager::add(Exception& ex,NET_SOCKET sockfd,Socket& socket) const {
+Socket** SocketReactor::add(Exception& ex,NET_SOCKET sockfd,Socket& socket) const {
 	if (!Startable::running()) {
 		ex.set(Exception::SOCKET, name(), "is not running");
 		return NULL;
@@ -88,70 +204,106 @@ Socket** SocketManager::add(Exception& ex,NET_SOCKET sockfd,Socket& socket) cons
 
 	auto it = _sockets.lower_bound(sockfd);
 	if (it != _sockets.end() && it->first == sockfd)
-		return it->second; // already managed
+		return &it->second->pSocket; // already managed
 	
-	Socket** ppSocket = new Socket*(&socket);
+	shared_ptr<ManagedSocket> pManaged(new ManagedSocket(socket, sockfd));
+	pManaged->weak = pManaged;
 
 #if defined(_WIN32)
 	int flags = FD_CONNECT | FD_ACCEPT | FD_CLOSE | FD_READ;
 	if (WSAAsyncSelect(sockfd, _eventSystem, 104, flags) != 0) {
-		delete ppSocket;
 		Net::SetError(ex);
 		return NULL;
 	}
 #else
 	epoll_event event;
 	memset(&event, 0, sizeof(event));
-	event.events = EPOLLIN | EPOLLRDHUP;
-	 event.data.fd = sockfd;
-	 event.data.ptr = ppSocket;
-	 int res = epoll_ctl(_eventSystem, EPOLL_CTL_ADD,sockfd, &event);
+	// edge-triggered, registered one time for reading and writing (no more epoll_ctl until the removing)
+	event.events = EPOLLIN | EPOLLRDHUP | EPOLLOUT | EPOLLET;
+	event.data.ptr = pManaged.get();
+	int res = epoll_ctl(_eventSystem, EPOLL_CTL_ADD,sockfd, &event);
 	if(res<0) {
-		delete ppSocket;
         Net::SetError(ex);
 		return NULL;
 	}
 #endif
 
 	++_counter;
-	_sockets.emplace_hint(it, sockfd, ppSocket);
+	it = _sockets.emplace_hint(it, sockfd, pManaged);
 
-	if(bufferSize>0) {
-		socket.setReceiveBufferSize(ex, bufferSize);
-		socket.setSendBufferSize(ex, bufferSize);
+	if(_bufferSize>0) {
+		socket.setReceiveBufferSize(ex, _bufferSize);
+		socket.setSendBufferSize(ex, _bufferSize);
 	}
 
-	return ppSocket;
+	return &it->second->pSocket;
 }
 
-bool SocketManager::startWrite(NET_SOCKET sockfd,Socket** ppSocket) const {
 #if defined(_WIN32)
-	return WSAAsyncSelect(sockfd, _eventSystem, 104, FD_CONNECT | FD_ACCEPT | FD_CLOSE | FD_READ | FD_WRITE) == 0;
+bool SocketReactor::arm(ManagedSocket& managed) const {
+	// remove erases the socket under this lock before to unregister it, so a removed socket can't be registered again
+	lock_guard<recursive_mutex> lock(_mutex);
+	if (_eventSystem == 0)
+		return false;
+	auto it = _sockets.find(managed.sockfd);
+	if (it == _sockets.end() || it->second.get() != &managed) // removed
+		return false;
+	return WSAAsyncSelect(managed.sockfd, _eventSystem, 104, FD_CONNECT | FD_ACCEPT | FD_CLOSE | FD_READ | (managed.writing ? FD_WRITE : 0)) == 0;
+}
 #else
-	epoll_event event;
-	memset(&event, 0, sizeof(event));
-	event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP;
-	event.data.fd = sockfd;
-	event.data.ptr = ppSocket;
-    return epoll_ctl(_eventSystem, EPOLL_CTL_MOD, sockfd, &event)>=0;
+bool SocketReactor::wakeUp() const {
+	static const char WakeUp(0);
+	return write(_eventFD, &WakeUp, sizeof(WakeUp)) >= 0;
+}
+#endif
+
+bool SocketReactor::startWrite(NET_SOCKET sockfd,Socket** ppSocket) const {
+	ManagedSocket& managed(*reinterpret_cast<ManagedSocket*>(ppSocket)); // pSocket is the first member
+	managed.writing = true;
+#if defined(_WIN32)
+	return arm(managed);
+#else
+	return managed.pSocket!=NULL; // EPOLLOUT is always registered
 #endif
 }
 
-bool SocketManager::stopWrite(NET_SOCKET sockfd,Socket** ppSocket) const {
+bool SocketReactor::stopWrite(NET_SOCKET sockfd,Socket** ppSocket) const {
+	ManagedSocket& managed(*reinterpret_cast<ManagedSocket*>(ppSocket)); // pSocket is the first member
+	managed.writing = false;
 #if defined(_WIN32)
-	return WSAAsyncSelect(sockfd, _eventSystem, 104, FD_CONNECT | FD_ACCEPT | FD_CLOSE | FD_READ) == 0;
+	return arm(managed);
 #else
-	epoll_event event;
-	memset(&event, 0, sizeof(event));
-	event.events = EPOLLIN | EPOLLRDHUP;
-	event.data.fd = sockfd;
-	event.data.ptr = ppSocket;
-    return epoll_ctl(_eventSystem, EPOLL_CTL_MOD,sockfd, &event) >= 0;
+	return true;
+#endif
+}
+
+bool SocketReactor::requestFlush(NET_SOCKET sockfd,Socket** ppSocket) const {
+#if defined(_WIN32)
+	return startWrite(sockfd, ppSocket); // FD_WRITE is posted immediatly if the socket is writable
+#else
+	ManagedSocket& managed(*reinterpret_cast<ManagedSocket*>(ppSocket)); // pSocket is the first member
+	managed.writing = true;
+	// edge-triggered, no writable event will come if the socket is already writable
+	lock_guard<recursive_mutex> lock(_mutex);
+	if (!managed.pSocket)
+		return false;
+	_flushSockets.emplace_back(managed.weak.lock());
+	if (wakeUps() == 1 && !wakeUp()) { // else already waked up
+		_flushSockets.pop_back(); // event system is stopping
+		return false;
+	}
+	return true;
 #endif
 }
 
+void SocketReactor::yieldReading(NET_SOCKET sockfd,Socket** ppSocket) const {
+#if !defined(_WIN32) // else FD_ACCEPT and FD_READ are posted again after the next accept or recv call
+	reinterpret_cast<ManagedSocket*>(ppSocket)->yielding = true; // pSocket is the first member
+#endif
+}
 
-void SocketManager::remove(NET_SOCKET sockfd) const {
+
+void SocketReactor::remove(NET_SOCKET sockfd) const {
 	if (!Startable::running())
 		return;
 
@@ -160,123 +312,181 @@ void SocketManager::remove(NET_SOCKET sockfd) const {
 	if (_eventSystem == 0) // keep it to avoid dead lock on sockets deletion! (and _sockets is necessary empty!)
 		return;
 
-	lock_guard<recursive_mutex> lock(_mutex);
-	auto it = _sockets.find(sockfd);
-	if(it == _sockets.end())
-		return;
-
-	Socket** ppSocket = it->second;
-	_sockets.erase(it);
-	(*ppSocket) = NULL;
+	shared_ptr<ManagedSocket> pManaged;
+	{
+		lock_guard<recursive_mutex> lock(_mutex);
+		auto it = _sockets.find(sockfd);
+		if(it == _sockets.end())
+			return;
+		pManaged = it->second;
+		_sockets.erase(it);
+	}
 
+	{
+		// wait the end of a possible usage of the socket
+		lock_guard<recursive_mutex> lockSocket(pManaged->mutex);
+		pManaged->pSocket = NULL;
 #if defined(_WIN32)
-	if (_eventSystem==0 || (WSAAsyncSelect(sockfd,_eventSystem,0,0)==0 && !PostMessage(_eventSystem,0,(WPARAM)ppSocket,0)))
-		delete ppSocket;
+		WSAAsyncSelect(sockfd, _eventSystem, 0, 0);
 #else
-	epoll_event event;
-	memset(&event, 0, sizeof(event));
-	if (_eventSystem==0 || (epoll_ctl(_eventSystem, EPOLL_CTL_DEL,sockfd,&event)>=0 && write(_eventFD,&ppSocket,sizeof(ppSocket))<0))
-		delete ppSocket;
+		epoll_event event;
+		memset(&event, 0, sizeof(event));
+		epoll_ctl(_eventSystem, EPOLL_CTL_DEL, sockfd, &event);
 #endif
+	}
 	--_counter;
+
+#if !defined(_WIN32)
+	// unregistered, but events already caught by the event system thread can reference it yet,
+	// so it's released by this thread once its current events treated
+	lock_guard<recursive_mutex> lock(_mutex);
+	_removedSockets.emplace_back(pManaged);
+	if (wakeUps() == 1 && !wakeUp()) // else already waked up
+		_removedSockets.pop_back(); // event system is stopping
+#endif
 }
 
-void SocketManager::handle(Exception& ex) {
+void SocketReactor::handle(Exception& ex) {
 	if (_eventSystem==0) {
 		if (_ex)
 			ex.set(_ex);
-		lock_guard<recursive_mutex> lock(_mutex);
-		if (_sockets.empty())
-			return;
-		_currentException.set(Exception::NETWORK, "SocketManager is stopping");
-		for (auto& it : _sockets) {
-			(*it.second)->onError(_currentException);
-			delete it.second;
+		map<NET_SOCKET, shared_ptr<ManagedSocket>> sockets;
+		{
+			lock_guard<recursive_mutex> lock(_mutex);
+			sockets.swap(_sockets); // onError can remove sockets
+		}
+		Exception exStop;
+		exStop.set(Exception::NETWORK, "SocketManager is stopping");
+		for (auto& it : sockets) {
+			lock_guard<recursive_mutex> lockSocket(it.second->mutex);
+			Socket* pSocket(it.second->pSocket);
+			if (!pSocket)
+				continue;
+			it.second->pSocket = NULL;
+			pSocket->onError(exStop);
 		}
-		_sockets.clear();
+		lock_guard<recursive_mutex> lock(_mutex);
+		for (auto& it : sockets)
+			_removedSockets.emplace_back(it.second); // Socket can always reference it
 		return;
 	}
 
-	lock_guard<recursive_mutex>	lock(_mutex);
+#if defined(_WIN32)
+	if (_pCurrentSocket)
+		handle(*_pCurrentSocket, _currentEvent, _currentError, _currentException);
+#endif
+}
 
-	if (!_ppSocket) {
-		if (_sockfd == NET_INVALID_SOCKET)
-			return;
-		auto it = _sockets.find(_sockfd);
-		if(it==_sockets.end())
-			return;
-		_ppSocket = it->second;
+void SocketReactor::handle(ManagedSocket& managed,UInt32 events,int error,Exception& exception) {
+#if defined(_WIN32)
+	read(managed, events, error, exception);
+#else
+	// edge-triggered: if an event has been caught meanwhile, the reading has to continue (nothing else will be notified)
+	while (read(managed, events, error, exception)) {
+		if (managed.yielding.exchange(false)) {
+			// reading stays pending, the event system thread posts it again behind the events of the other ready sockets
+			lock_guard<recursive_mutex> lock(_mutex);
+			if (managed.pSocket) {
+				_readSockets.emplace_back(managed.weak.lock());
+				if (wakeUps() > 1 || wakeUp()) // else event system is stopping
+					break;
+				_readSockets.pop_back();
+			}
+		}
+		managed.reading = false;
+		if (!managed.again.exchange(false) || managed.reading.exchange(true))
+			break; // nothing new, or a new event is already posted
+		events = EPOLLIN;
+		error = 0;
 	}
+#endif
+}
 
-	Socket* pSocket(*_ppSocket);
-	if (!pSocket) // expired!
-		return;
+bool SocketReactor::read(ManagedSocket& managed,UInt32 events,int error,Exception& exception) {
+	lock_guard<recursive_mutex> lock(managed.mutex);
 
+	Socket* pSocket(managed.pSocket);
+	if (!pSocket) // expired!
+		return false;
 
-	if (_currentException) {
-		pSocket->onError(_currentException);
-		_currentException.set(Exception::NIL);
-		if (*_ppSocket == NULL) // expired!
-			return;
+	if (exception) {
+		pSocket->onError(exception);
+		exception.set(Exception::NIL);
+		if (!managed.pSocket) // expired!
+			return false;
 	}
 
-
-	if (_currentError != 0) {
+	if (error != 0) {
 #if !defined(_WIN32)
-		if (_currentError == NET_EINTR) {
+		if (error == NET_EINTR) {
 			if(pSocket->onConnection()) {
-				if (*_ppSocket == NULL) // expired!
-					return;
+				if (!managed.pSocket) // expired!
+					return false;
 				static char Temp;
-				pSocket->receiveBytes(_currentException,&Temp,1); // to get the correct connection error!
+				pSocket->receiveBytes(exception,&Temp,1); // to get the correct connection error!
 			}
 		}
 #endif
-		if (!_currentException)
-			Net::SetError(_currentException, _currentError);
-		pSocket->onError(_currentException);
-		_currentException.set(Exception::NIL);
-		if (*_ppSocket == NULL) // expired!
-			return;
+		if (!exception)
+			Net::SetError(exception, error);
+		pSocket->onError(exception);
+		exception.set(Exception::NIL);
+		if (!managed.pSocket) // expired!
+			return false;
 	}
 
-	if (_currentEvent == 0)
-		return;
-
+	if (events == 0)
+		return true;
 
 	/// now, connect, read, accept, or hangup event
 #if defined(_WIN32)
-	if (_currentEvent == FD_CONNECT) {
+	if (events == FD_CONNECT) {
 		pSocket->onConnection();
-		if (_currentError==0 || *_ppSocket == NULL)
-			return;
+		if (error==0 || !managed.pSocket)
+			return managed.pSocket!=NULL;
 	}
-
-#else
-	do { // call onReadable at minimum one time (it can be an accept or hangup)
 #endif
-		pSocket->onReadable(_currentException,pSocket->available(_exSkip));
-		if (_currentException) {
-			if (*_ppSocket==NULL)
-				return;
-			pSocket->onError(_currentException);
-			_currentException.set(Exception::NIL);
+	// call onReadable at minimum one time (it can be an accept or hangup), and until everything has been read (no FIONREAD request)
+	// managed.pSocket is checked because the socket can be deleted in pSocket->onReadable if on request the user call "close"
+	bool more;
+	do {
+		more = pSocket->onReadable(exception);
+		if (exception) {
+			if (!managed.pSocket)
+				return false;
+			pSocket->onError(exception);
+			exception.set(Exception::NIL);
 		}
-#if !defined(_WIN32)
-	} while (*_ppSocket && pSocket->available(_exSkip) > 0);  // just one time for windows, and fill available bytes for posix
-	// while !exs because the socket can be deleted in pSocket->onReadable if on request the user call "close"
-#endif
+	} while (more && managed.pSocket);
+	return managed.pSocket!=NULL;
 }
 
-void SocketManager::requestHandle() {
+bool SocketReactor::post(const shared_ptr<SocketEvent>& pEvent) {
+	Exception ex;
+	if (_handler.postHandle(ex, pEvent))
+		return true;
+	if (!ex)
+		return false; // queue full, retry later
+	// handler stopped, event is lost
+	pEvent->managed().reading = false;
+	return true;
+}
+
+void SocketReactor::requestHandle() {
 	Exception ex;
 	giveHandle(ex);
 }
 
-void SocketManager::run(Exception& exThread) {
+void SocketReactor::run(Exception& exThread) {
 	Exception& ex(_selfHandler ? exThread : _ex);
 	const char* name = Startable::name().c_str();
 	_eventSystem = 0;
+	{
+		lock_guard<recursive_mutex> lock(_mutex);
+		_removedSockets.clear(); // sockets of a previous running
+		_flushSockets.clear();
+		_readSockets.clear();
+	}
 #if defined(_WIN32)
 	WNDCLASSEX wc;
 	memset(&wc, 0, sizeof(wc));
@@ -311,7 +521,7 @@ void SocketManager::run(Exception& exThread) {
 		epoll_event event;
 		memset(&event, 0, sizeof(event));
 		event.events = EPOLLIN;
-		event.data.fd = readFD;
+		event.data.ptr = NULL;
 		epoll_ctl(_eventSystem, EPOLL_CTL_ADD,readFD, &event);	
 	}
 #endif
@@ -328,35 +538,33 @@ void SocketManager::run(Exception& exThread) {
 	MSG msg;
 	int result;
 	while ((result = GetMessage(&msg, _eventSystem, 0, 0)) > 0) {
-		if (msg.wParam == 0)
-			continue;
-		if (msg.message == 0) {
-			// no mutex for ppSocket methods access because the socket has been removed already here!
-			delete ((atomic<Socket*>*)msg.wParam);
-			continue;
-		} else if (msg.message != 104) // unknown message
+		if (msg.wParam == 0 || msg.message != 104) // unknown message
 			continue;
 		_currentEvent = WSAGETSELECTEVENT(msg.lParam);
-		_sockfd = msg.wParam;
-		if (_currentEvent == FD_WRITE) {
-			_currentEvent = 0;
+		NET_SOCKET sockfd(msg.wParam);
+		{
 			// protected for _sockets access
 			lock_guard<recursive_mutex> lock(_mutex);
-			auto& it = _sockets.find(_sockfd);
-			if (it != _sockets.end()) {
-				_ppSocket = it->second;
-				(*_ppSocket)->flush(_currentException);
-			}
+			auto it = _sockets.find(sockfd);
+			if (it == _sockets.end())
+				continue; // removed
+			_pCurrentSocket = it->second;
+		}
+		if (_currentEvent == FD_WRITE) {
+			_currentEvent = 0;
+			lock_guard<recursive_mutex> lock(_pCurrentSocket->mutex);
+			if (_pCurrentSocket->pSocket)
+				_pCurrentSocket->pSocket->onWritable(_currentException);
 		}
 		// FD_CONNECT | FD_ACCEPT | FD_CLOSE | FD_READ | FD_WRITE
-		if (_currentEvent==FD_READ && Socket::IOCTL(_exSkip, _sockfd, FIONREAD, 0) || _currentEvent || _currentException) {
+		if (_currentEvent || _currentException) {
 			if (_currentEvent != FD_CLOSE) // in close case, it's not an error!
 				_currentError = WSAGETSELECTERROR(msg.lParam);
 			Task::waitHandle();
 		}
 		_currentException.set(Exception::NIL);
-		_ppSocket = NULL;
-		_sockfd = INVALID_SOCKET;
+		_currentError = 0;
+		_pCurrentSocket.reset();
 	}
 	DestroyWindow(_eventSystem);
 	if (result < 0) {
@@ -365,12 +573,17 @@ void SocketManager::run(Exception& exThread) {
 	}
 #else
     int count = _counter+1;
-	vector<epoll_event> events(count);
-	vector<Socket**>	removedSockets;
+	vector<epoll_event>				events(count);
+	deque<shared_ptr<SocketEvent>>	deferredEvents; // events refused by a full handler queue
+	vector<shared_ptr<ManagedSocket>>	removedSockets;
+	vector<shared_ptr<ManagedSocket>>	flushSockets;
+	vector<shared_ptr<ManagedSocket>>	readSockets;
+	char							signals[64];
 
 	for(;;) {
 
-		int results = epoll_wait(_eventSystem,&events[0],events.size(), -1);
+		// if the handler queue is full, sockets concerned wait (kernel buffers absorb the load) and events are retried a few later
+		int results = epoll_wait(_eventSystem,&events[0],events.size(), deferredEvents.empty() ? -1 : 10);
 
 		if(results<0 && errno!=NET_EINTR) {
 			Net::SetError(ex);
@@ -378,50 +591,83 @@ void SocketManager::run(Exception& exThread) {
 			break;
 		}
 
+		while (!deferredEvents.empty() && post(deferredEvents.front()))
+			deferredEvents.pop_front();
+
 		// for each ready socket
 		int i=0;
 		for(i;i<results;++i) {
 			epoll_event& event = events[i];
 
-			if(event.data.fd==readFD) {
+			if(!event.data.ptr) {
 
 				if(event.events&EPOLLHUP) {
 					i=-1; // termination signal!
 					break;
 				}
-
-				while (Socket::IOCTL(_exSkip,readFD, FIONREAD, 0)>=sizeof(_ppSocket) && read(readFD, &_ppSocket, sizeof(_ppSocket)) > 0) {
-					// no mutex for ppSocket methods access because the socket has been removed already here!
-					removedSockets.emplace_back(_ppSocket);
+				// sockets removed (released after the current events) or to flush
+				Exception exSkip;
+				int available(Socket::IOCTL(exSkip, readFD, FIONREAD, 0));
+				while (available > 0 && ::read(readFD, signals, available > sizeof(signals) ? sizeof(signals) : available) > 0)
+					available -= sizeof(signals);
+				{
+					lock_guard<recursive_mutex> lock(_mutex);
+					removedSockets.insert(removedSockets.end(), _removedSockets.begin(), _removedSockets.end());
+					_removedSockets.clear();
+					flushSockets.swap(_flushSockets);
+					readSockets.swap(_readSockets);
+				}
+				for (shared_ptr<ManagedSocket>& pManaged : flushSockets) {
+					lock_guard<recursive_mutex> lock(pManaged->mutex);
+					if (!pManaged->pSocket)
+						continue;
+					Exception exFlush;
+					pManaged->pSocket->flush(exFlush);
+					if (exFlush && pManaged->pSocket)
+						pManaged->pSocket->onError(exFlush);
+				}
+				flushSockets.clear();
+				// yielding sockets, posted behind the events already deferred (EPOLLIN as if a new edge was caught)
+				for (shared_ptr<ManagedSocket>& pManaged : readSockets) {
+					shared_ptr<SocketEvent> pEvent(new SocketEvent(*this, pManaged, EPOLLIN, 0, Exception()));
+					if (!deferredEvents.empty() || !post(pEvent))
+						deferredEvents.emplace_back(pEvent);
 				}
-				_ppSocket = NULL;
+				readSockets.clear();
 				continue;	
 			}
 		
-			_currentEvent = event.events;
-			if(_currentEvent&EPOLLERR) {
-                _currentError = Net::LastError();
-				_currentEvent &= ~EPOLLERR;
-			}
-
-			if(_currentEvent&EPOLLOUT) {
-				lock_guard<recursive_mutex> lock(_mutex);
-				_ppSocket = (Socket**)event.data.ptr;
-				Socket* pSocket(*_ppSocket);
-				if(pSocket)
-					pSocket->flush(_currentException);
-				_currentEvent &= ~EPOLLOUT;
+			ManagedSocket& managed(*(ManagedSocket*)event.data.ptr);
+			UInt32 currentEvent(event.events);
+			int currentError(0);
+			Exception currentException;
+			if(currentEvent&EPOLLERR) {
+                currentError = Net::LastError();
+				currentEvent &= ~EPOLLERR;
 			}
 
-			if(_currentException || _currentError>0 || _currentEvent>0) {
-				if(!_ppSocket)
-					_ppSocket = (Socket**)event.data.ptr;
-				Task::waitHandle();
-				_currentException.set(Exception::NIL);
-				_currentError = 0;
+			if(currentEvent&EPOLLOUT) {
+				// EPOLLOUT is given with every event while the socket is writable, flush just if expected,
+				// and not on error (a failed connection is not an established connection, the reading will get the error)
+				if (managed.writing && !(event.events&(EPOLLERR|EPOLLHUP))) {
+					lock_guard<recursive_mutex> lock(managed.mutex);
+					if(managed.pSocket)
+						managed.pSocket->onWritable(currentException);
+				}
+				currentEvent &= ~EPOLLOUT;
 			}
 
-			_ppSocket = NULL;
+			if(!currentException && currentError==0 && currentEvent==0)
+				continue;
+
+			// edge-triggered: if a reading is pending, it will read again
+			managed.again = true;
+			if (managed.reading.exchange(true))
+				continue;
+			managed.again = false;
+			shared_ptr<SocketEvent> pEvent(new SocketEvent(*this, managed.weak.lock(), currentEvent, currentError, currentException));
+			if (!deferredEvents.empty() || !post(pEvent))
+				deferredEvents.emplace_back(pEvent);
 		}
 		if(i==-1)
 			break; // termination signal!
@@ -429,19 +675,11 @@ void SocketManager::run(Exception& exThread) {
 		if(count!=events.size())
 			events.resize(count);
 
-		// remove sockets
-		if(removedSockets.empty())
-			continue;
-		for (Socket** ppSocket : removedSockets)
-			delete ppSocket;
+		// release removed sockets, no more referenced by this thread
 		removedSockets.clear();
 	}
 	::close(readFD);  // close reader pipe side
 	::close(_eventSystem); // close the system message
-
-	for (Socket** ppSocket : removedSockets)
-		delete ppSocket;
-	removedSockets.clear();
 #endif
 
 
@@ -451,8 +689,11 @@ void SocketManager::run(Exception& exThread) {
 	if (!Task::waitHandle()) { // to remove possible sockets remaing, or to set exception if(ex)
 		lock_guard<recursive_mutex> lock(_mutex);
 		if (!_sockets.empty()) {
-			for (auto& it : _sockets)
-				delete it.second;
+			for (auto& it : _sockets) {
+				lock_guard<recursive_mutex> lockSocket(it.second->mutex);
+				it.second->pSocket = NULL;
+				_removedSockets.emplace_back(it.second); // Socket can always reference it
+			}
 			_sockets.clear();
 			exThread.set(Exception::NETWORK, "TaskHandler of SocketManager is stopped, impossible to warn remaining sockets");
 		}
@@ -460,7 +701,93 @@ void SocketManager::run(Exception& exThread) {
 
 }
 
-	
+
+SocketManager::SocketManager(TaskHandler& handler, const PoolBuffers& poolBuffers, PoolThreads& poolThreads, UInt32 bufferSize, const string& name, UInt16 reactors) : poolBuffers(poolBuffers),
+	poolThreads(poolThreads), bufferSize(bufferSize) {
+	if (reactors == 0)
+		reactors = Util::ProcessorCount();
+	string reactorName;
+	for (UInt16 i = 0; i < reactors; ++i)
+		_reactors.emplace_back(new SocketReactor(handler, bufferSize, i == 0 ? name : String::Format(reactorName, name, i)));
+}
+SocketManager::SocketManager(const PoolBuffers& poolBuffers, PoolThreads& poolThreads, UInt32 bufferSize, const string& name, UInt16 reactors) : poolBuffers(poolBuffers),
+	poolThreads(poolThreads), bufferSize(bufferSize) {
+	if (reactors == 0)
+		reactors = Util::ProcessorCount();
+	string reactorName;
+	for (UInt16 i = 0; i < reactors; ++i)
+		_reactors.emplace_back(new SocketReactor(bufferSize, i == 0 ? name : String::Format(reactorName, name, i)));
+}
+
+SocketManager::~SocketManager() {
+	stop();
+}
+
+bool SocketManager::start(Exception& ex) {
+	for (auto& pReactor : _reactors) {
+		if (pReactor->start(ex))
+			continue;
+		stop();
+		return false;
+	}
+	return true;
+}
+
+void SocketManager::stop() {
+	for (auto& pReactor : _reactors)
+		pReactor->stop();
+}
+
+void SocketManager::setAffinity(const vector<UInt16>& processors) {
+	vector<UInt16> processor;
+	for (UInt32 i = 0; i < _reactors.size(); ++i) {
+		if (!processors.empty())
+			processor.assign(1, processors[i % processors.size()]);
+		_reactors[i]->setAffinity(processor);
+	}
+}
+
+bool SocketManager::running() const {
+	for (auto& pReactor : _reactors) {
+		if (pReactor->running())
+			return true;
+	}
+	return false;
+}
+
+SocketReactor& SocketManager::reactor(NET_SOCKET sockfd) const {
+	if (_reactors.size() == 1)
+		return *_reactors.front();
+#if defined(_WIN32)
+	return *_reactors[(sockfd >> 2) % _reactors.size()]; // SOCKET handles are multiple of 4 on windows
+#else
+	return *_reactors[sockfd % _reactors.size()];
+#endif
+}
+
+Socket** SocketManager::add(Exception& ex,NET_SOCKET sockfd,Socket& socket) const {
+	return reactor(sockfd).add(ex, sockfd, socket);
+}
+
+void SocketManager::remove(NET_SOCKET sockfd) const {
+	reactor(sockfd).remove(sockfd);
+}
+
+bool SocketManager::startWrite(NET_SOCKET sockfd,Socket** ppSocket) const {
+	return reactor(sockfd).startWrite(sockfd, ppSocket);
+}
+
+bool SocketManager::stopWrite(NET_SOCKET sockfd,Socket** ppSocket) const {
+	return reactor(sockfd).stopWrite(sockfd, ppSocket);
+}
+
+bool SocketManager::requestFlush(NET_SOCKET sockfd,Socket** ppSocket) const {
+	return reactor(sockfd).requestFlush(sockfd, ppSocket);
+}
+
+void SocketManager::yieldReading(NET_SOCKET sockfd,Socket** ppSocket) const {
+	reactor(sockfd).yieldReading(sockfd, ppSocket);
+}
 
 
 } // namespace Mona
@@ -19,6 +19,12 @@ This file is a part of Mona.
 
 #include "Mona/SocketSender.h"
 #include "Mona/Socket.h"
+#include <fcntl.h>
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 
 using namespace std;
@@ -27,11 +33,21 @@ using namespace std;
 namespace Mona {
 
 SocketSender::SocketSender(const char* name) : WorkThread(name),
-	_position(0), _data(NULL), _size(0) {
+	_position(0), _data(NULL), _size(0), _sharedIndex(0), _sharedPosition(0), _queued(0), _file(-1), _filePosition(0), _fileEnd(0) {
 }
 
 SocketSender::SocketSender(const char* name,const UInt8* data, UInt32 size) : WorkThread(name),
-	_position(0), _data((UInt8*)data), _size(size) {
+	_position(0), _data((UInt8*)data), _size(size), _sharedIndex(0), _sharedPosition(0), _queued(0), _file(-1), _filePosition(0), _fileEnd(0) {
+}
+
+SocketSender::~SocketSender() {
+	if (_file < 0)
+		return;
+#if defined(_WIN32)
+	_close(_file);
+#else
+	::close(_file);
+#endif
 }
 
 bool SocketSender::run(Exception& ex) {
@@ -49,34 +65,131 @@ bool SocketSender::run(Exception& ex) {
 }
 
 
+void SocketSender::share(const SharedBuffer& buffer) {
+	if (!buffer.empty())
+		_shareds.emplace_back(size(), buffer);
+}
+
+bool SocketSender::shareFile(Exception& ex, const string& path, UInt64 offset, UInt64 size) {
+	if (_file >= 0) {
+		ex.set(Exception::FILE, "SocketSender ", name, " has already a file to send");
+		return false;
+	}
+#if defined(_WIN32)
+	_file = _open(path.c_str(), _O_RDONLY | _O_BINARY);
+#else
+	_file = ::open(path.c_str(), O_RDONLY);
+#endif
+	if (_file < 0) {
+		ex.set(Exception::FILE, "Impossible to open ", path, " file");
+		return false;
+	}
+	_filePosition = offset;
+	_fileEnd = offset + size;
+	return true;
+}
+
 bool SocketSender::flush(Exception& ex,Socket& socket) {
-	if(!available())
-		return true;
-
-	UInt32 size;
-	const UInt8* data;
-	if (_ppBuffer) {
-		size = (*_ppBuffer)->size();
-		data = (*_ppBuffer)->data();
-	} else {
-		size = this->size();
-		data = this->data();
+	// part by part (data, shared buffers and file)
+	while (available()) {
+		if (!availableData()) {
+			// file by chunks to not monopolize the sending thread
+			UInt32 size(_fileEnd - _filePosition > 0x100000 ? 0x100000 : UInt32(_fileEnd - _filePosition));
+			UInt32 sent(socket.sendFile(ex, _file, _filePosition, size));
+			if (ex) // terminate the sender
+				return true;
+			if ((_filePosition += sent) >= _fileEnd)
+				return true;
+			if (sent < size)
+				return !buffering(socket.manager().poolBuffers);
+			continue;
+		}
+		UInt32 size;
+		const UInt8* data(pending(size));
+
+		UInt32 sent(send(ex,socket,data, size));
+
+		if (ex) // terminate the sender
+			return true;
+		// everything has been sent
+		if (consume(sent))
+			return true;
+		if (sent < size)
+			return !buffering(socket.manager().poolBuffers);
 	}
+	return true;
+}
 
-	_position += send(ex,socket,data + _position, size - _position);
+const UInt8* SocketSender::pending(UInt32& size) {
+	const void* buffer;
+	int length;
+	if (!pending(&buffer, &length, 1)) {
+		size = 0;
+		return NULL;
+	}
+	size = length;
+	return (const UInt8*)buffer;
+}
 
-	if (ex) // terminate the sender
-		_position = size;
-	// everything has been sent
-	if (_position >= size) {
-		if (_ppBuffer)
-			_ppBuffer->release();
-		return true;
+UInt32 SocketSender::pending(const void** buffers, int* lengths, UInt32 count) {
+	if (!availableData())
+		return 0;
+	const UInt8* data(_ppBuffer ? (*_ppBuffer)->data() : this->data());
+	UInt32 size(_ppBuffer ? (*_ppBuffer)->size() : this->size());
+	UInt32 position(_position), sharedPosition(_sharedPosition), filled(0);
+	for (UInt32 index = _sharedIndex; filled < count; ++index) {
+		// data until the next shared buffer
+		UInt32 end(index < _shareds.size() ? _shareds[index].position : size);
+		if (position < end) {
+			buffers[filled] = data + position;
+			lengths[filled++] = end - position;
+			position = end;
+			if (filled == count)
+				break;
+		}
+		if (index >= _shareds.size())
+			break;
+		const SharedBuffer& buffer(_shareds[index].buffer);
+		buffers[filled] = buffer.data() + sharedPosition;
+		lengths[filled++] = buffer.size() - sharedPosition;
+		sharedPosition = 0;
 	}
+	return filled;
+}
 
-	if (buffering(socket.manager().poolBuffers))
+bool SocketSender::consume(UInt32 size) {
+	while (size > 0 && availableData()) {
+		UInt32 count;
+		if (_sharedIndex < _shareds.size() && _position >= _shareds[_sharedIndex].position) {
+			const SharedBuffer& buffer(_shareds[_sharedIndex].buffer);
+			count = min(size, buffer.size() - _sharedPosition);
+			if ((_sharedPosition += count) == buffer.size()) {
+				++_sharedIndex;
+				_sharedPosition = 0;
+			}
+		} else {
+			UInt32 end(_sharedIndex < _shareds.size() ? _shareds[_sharedIndex].position : (_ppBuffer ? (*_ppBuffer)->size() : this->size()));
+			count = min(size, end - _position);
+			_position += count;
+		}
+		size -= count;
+	}
+	if (availableData())
 		return false;
-	return true;
+	if (_ppBuffer)
+		_ppBuffer->release();
+	// release the shared buffers as soon as possible
+	_shareds.clear();
+	_sharedIndex = 0;
+	return _filePosition >= _fileEnd;
+}
+
+UInt32 SocketSender::queueing() {
+	UInt32 size(_ppBuffer ? (_ppBuffer->empty() ? 0 : (*_ppBuffer)->size()) : (data() ? this->size() : 0));
+	UInt32 queueing(_position < size ? (size - _position) : 0);
+	for (UInt32 index = _sharedIndex; index < _shareds.size(); ++index)
+		queueing += _shareds[index].buffer.size();
+	return queueing - _sharedPosition;
 }
 
 bool SocketSender::buffering(const PoolBuffers& poolBuffers) {
@@ -84,10 +197,12 @@ bool SocketSender::buffering(const PoolBuffers& poolBuffers) {
 	if (!_data || _ppBuffer)
 		return true; // no buffering required
 	if (_position >= _size)
-		return false; // no more data to send
+		return _sharedIndex < _shareds.size() || _filePosition < _fileEnd; // no more data to send, excepting shared buffers and file
 	UInt32 size(_size-_position);
 	_ppBuffer.reset(new PoolBuffer(poolBuffers, size));
 	memmove((*_ppBuffer)->data(), _data + _position, size);
+	for (Shared& shared : _shareds)
+		shared.position = shared.position > _position ? (shared.position - _position) : 0;
 	_position = 0;
 	return true;
 }
@@ -21,6 +21,7 @@ This file is a part of Mona.
 #include "Mona/Startable.h"
 #if !defined(_WIN32)
 #include <sys/prctl.h> // for thread name
+#include <sched.h> // for thread affinity
 #else
 #include <windows.h>
 #endif
@@ -96,6 +97,33 @@ void Startable::process() {
 	}
 #endif
 
+	// set affinity
+	if (!_affinity.empty()) {
+		string processors;
+		Util::FormatProcessors(_affinity, processors);
+#if defined(_WIN32)
+		DWORD_PTR mask(0);
+		for (UInt16 processor : _affinity) {
+			if (processor < sizeof(mask) * 8)
+				mask |= DWORD_PTR(1) << processor;
+		}
+		if (SetThreadAffinityMask(GetCurrentThread(), mask) == 0)
+			WARN("Impossible to bind the thread ", _name, " to the processors ", processors);
+#elif defined(__linux__)
+		cpu_set_t set;
+		CPU_ZERO(&set);
+		for (UInt16 processor : _affinity) {
+			if (processor < CPU_SETSIZE)
+				CPU_SET(processor, &set);
+		}
+		int result;
+		if (result = pthread_setaffinity_np(pthread_self(), sizeof(set), &set))
+			WARN("Impossible to bind the thread ", _name, " to the processors ", processors, ", ", strerror(result));
+#else
+		WARN("Impossible to bind the thread ", _name, " to the processors ", processors, ", not supported by this system");
+#endif
+	}
+
 	try {
 		Exception ex;
 		run(ex);
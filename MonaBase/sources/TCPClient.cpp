@@ -38,25 +38,31 @@ TCPClient::~TCPClient() {
 }
 
 
-void TCPClient::onReadable(Exception& ex,UInt32 available) {
-
-	if (available == 0) {
-		close(); // Graceful disconnection
-		return;
-	}
+bool TCPClient::onReadable(Exception& ex) {
 
 	lock_guard<recursive_mutex> lock(_mutex);
+	if (!_connected)
+		return false;
 
-	if(available>(_pBuffer->size() - _rest))
-		_pBuffer->resize(_rest+available,true);
+	// reads in all the buffer capacity (without FIONREAD request), and grows it if less than 2048 bytes are free
+	UInt32 capacity(_pBuffer->capacity());
+	_pBuffer->resize(capacity < (_rest + 2048) ? (_rest + 2048) : capacity, true);
 
 	Exception exRecv;
-	int received = _socket.receiveBytes(exRecv,_pBuffer->data()+_rest, available);
+	int received = _socket.receiveBytes(exRecv,_pBuffer->data()+_rest, _pBuffer->size()-_rest);
+	if (received < 0 && !exRecv) {
+		// nothing more to read (EAGAIN)
+		if (_rest)
+			_pBuffer->resize(_rest, true);
+		else
+			_pBuffer.release();
+		return false;
+	}
 	if (received <= 0) {
 		if (exRecv)
 			onError(exRecv); // to be before onDisconnection!
 		close(); // Graceful disconnection
-		return;
+		return false;
 	} else if (exRecv)
 		ex.set(exRecv); // received > 0, so WARN
 
@@ -92,7 +98,9 @@ void TCPClient::onReadable(Exception& ex,UInt32 available) {
 
 		_rest = rest;
 	}
-
+	if (_rest)
+		_pBuffer->resize(_rest, true);
+	return true;
 }
 
 
@@ -142,7 +150,7 @@ void TCPClient::close() {
 bool TCPClient::send(Exception& ex,const UInt8* data,UInt32 size) {
 	if(size==0)
 		return true;
-	shared_ptr<TCPSender> pSender(new TCPSender("TCPClient::send",data, size));
+	shared_ptr<TCPSender> pSender(PoolObjects::New<TCPSender>("TCPClient::send",data, size));
 	return _socket.send(ex, pSender);
 }
 
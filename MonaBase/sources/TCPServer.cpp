@@ -25,21 +25,21 @@ using namespace std;
 
 namespace Mona {
 
-TCPServer::TCPServer(const SocketManager& manager) : _running(false),_socket(*this,manager) {
+TCPServer::TCPServer(const SocketManager& manager) : _running(false),_socket(*this,manager),_accepted(0),_dropped(0) {
 }
 
 TCPServer::~TCPServer() {
 	stop();
 }
 
-bool TCPServer::start(Exception& ex,const SocketAddress& address) {
+bool TCPServer::start(Exception& ex,const SocketAddress& address,int backlog) {
 	lock_guard<recursive_mutex> lock(_mutex);
 	if (_running) {
 		if (address == _address)
 			return true;
 		stop();
 	}
-	if (!_socket.bindWithListen(ex, address))
+	if (!_socket.bindWithListen(ex, address, true, backlog))
 		return false;
 	_address = address;
 	return _running=true;
@@ -49,17 +49,31 @@ void TCPServer::stop() {
 	lock_guard<recursive_mutex> lock(_mutex);
 	if (!_running)
 		return;
+	_dropped += _socket.drops(); // counter of the listening socket, lost with it
 	_socket.close();
 	_address.reset();
 	_running = false;
 }
 
-void TCPServer::onReadable(Exception& ex,UInt32 available) {
+UInt64 TCPServer::dropped() const {
+	lock_guard<recursive_mutex> lock(_mutex);
+	return _running ? (_dropped + _socket.drops()) : _dropped;
+}
+
+bool TCPServer::onReadable(Exception& ex) {
+	// drains the accept queue, but after ACCEPT_BUDGET connections the other ready sockets are read before to continue
 	SocketAddress address;
-	SocketFile file(_socket.acceptConnection(ex,address));
-	if (!file)
-		return;
-	onConnection(ex,address,file);
+	for (UInt32 i = 0; i < ACCEPT_BUDGET; ++i) {
+		SocketFile file(_socket.acceptConnection(ex,address));
+		if (!file)
+			return false; // no more connection to accept (or error)
+		++_accepted;
+		onConnection(ex,address,file);
+		if (ex)
+			return true; // ex will be reported, and next connections accepted then
+	}
+	_socket.yieldReading();
+	return false;
 }
 
 
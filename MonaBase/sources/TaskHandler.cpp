@@ -35,6 +35,11 @@ void TaskHandler::stop() {
 	lock_guard<recursive_mutex> lock(_mutex);
 	_stop=true;
 	_signal.set();
+	// release the tasks which will never be handled
+	_tasks.clear();
+	lock_guard<mutex> lockDeferred(_mutexDeferred);
+	_deferredTasks.clear();
+	_deferredSize = 0;
 }
 
 bool TaskHandler::waitHandle(Task& task) {
@@ -49,14 +54,58 @@ bool TaskHandler::waitHandle(Task& task) {
 	return _signal.wait();
 }
 
+bool TaskHandler::postHandle(Exception& ex,const shared_ptr<Task>& pTask,bool defer) {
+	if (_stop) {
+		ex.set(Exception::APPLICATION, "TaskHandler is stopped");
+		return false;
+	}
+	UInt32 previousSize;
+	if (_deferredSize == 0 && _tasks.push(pTask, &previousSize)) {
+		if (previousSize == 0) // else the handler thread is already warned
+			requestHandle();
+		return true;
+	}
+	if (!defer)
+		return false;
+	{
+		lock_guard<mutex> lock(_mutexDeferred);
+		_deferredTasks.emplace_back(pTask);
+		previousSize = _deferredSize++;
+	}
+	++_deferrals;
+	if (previousSize == 0) // the handler thread can have drained the queue meanwhile
+		requestHandle();
+	return true;
+}
+
 void TaskHandler::giveHandle(Exception& ex) {
 	lock_guard<recursive_mutex> lock(_mutex);
-	if(!_pTask)
-		return;
-	_pTask->handle(ex);
-	_pTask=NULL;
-	_signal.set();
-}
+	if(_pTask) {
+		_pTask->handle(ex);
+		_pTask=NULL;
+		_signal.set();
+	}
 
+	// posted tasks, by batch to let a chance to the handler thread to do something else
+	UInt32 count(_tasks.capacity && _tasks.capacity<256 ? _tasks.capacity : 256);
+	shared_ptr<Task> pTask;
+	while (!ex && count-- > 0) {
+		if (!_tasks.pop(pTask)) {
+			// queue drained, now the deferred tasks (nothing is queued before that they are all handled)
+			if (_deferredSize == 0 || !_tasks.empty())
+				break;
+			lock_guard<mutex> lockDeferred(_mutexDeferred);
+			if (_deferredTasks.empty())
+				break; // stopped meanwhile
+			pTask = move(_deferredTasks.front());
+			_deferredTasks.pop_front();
+			--_deferredSize;
+		}
+		pTask->handle(ex);
+		pTask.reset();
+	}
+	if (!_stop && (!_tasks.empty() || _deferredSize > 0))
+		requestHandle();
+}
 
 } // namespace Mona
@@ -0,0 +1,199 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+
+#include "Mona/Timer.h"
+#include <chrono>
+#include <cstring>
+
+
+using namespace std;
+
+
+namespace Mona {
+
+Timer::Timer() : _pExpired(NULL), _pRaising(NULL), _count(0), _time(Now()) {
+	memset(_slots, 0, sizeof(_slots));
+}
+
+Timer::~Timer() {
+	// unregister the timers always running, to not remove them from a deleted timer then
+	for (const OnTimer*& pHead : _slots) {
+		while (pHead)
+			unlink(*pHead);
+	}
+}
+
+Int64 Timer::Now() {
+	return chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Timer::set(const OnTimer& onTimer, UInt32 timeout) const {
+	if (onTimer._pTimer)
+		onTimer._pTimer->unlink(onTimer);
+	if (!timeout)
+		return;
+	onTimer._expiration = Now() + timeout;
+	if (onTimer._expiration <= _time)
+		onTimer._expiration = _time + 1; // the current tick has been raised already
+	insert(onTimer);
+}
+
+void Timer::remove(const OnTimer& onTimer) const {
+	if (&onTimer == _pRaising)
+		_pRaising = NULL;
+	if (onTimer._pTimer == this)
+		unlink(onTimer);
+}
+
+void Timer::insert(const OnTimer& onTimer) const {
+	// here _expiration >= _time
+	Int64 delta(onTimer._expiration - _time);
+	UInt32 index;
+	if (delta < (1 << LEVEL0_BITS))
+		index = onTimer._expiration & ((1 << LEVEL0_BITS) - 1);
+	else {
+		UInt8 level(1), shift(LEVEL0_BITS);
+		while (level < (LEVELS - 1) && delta >= (Int64(1) << (shift + LEVEL_BITS))) {
+			++level;
+			shift += LEVEL_BITS;
+		}
+		Int64 expiration(onTimer._expiration);
+		if (delta >= (Int64(1) << (shift + LEVEL_BITS)))
+			expiration = _time + (Int64(1) << (shift + LEVEL_BITS)) - 1; // beyond the last level, will be cascaded again
+		index = (1 << LEVEL0_BITS) + (level - 1)*(1 << LEVEL_BITS) + ((expiration >> shift) & ((1 << LEVEL_BITS) - 1));
+	}
+	const OnTimer*& pHead(_slots[index]);
+	onTimer._pTimer = this;
+	onTimer._ppHead = &pHead;
+	onTimer._pPrev = NULL;
+	onTimer._pNext = pHead;
+	if (pHead)
+		pHead->_pPrev = &onTimer;
+	pHead = &onTimer;
+	++_count;
+}
+
+void Timer::unlink(const OnTimer& onTimer) const {
+	if (!onTimer._ppHead) {
+		// in progress of raising
+		onTimer._pTimer = NULL;
+		return;
+	}
+	if (onTimer._pPrev)
+		onTimer._pPrev->_pNext = onTimer._pNext;
+	else
+		*onTimer._ppHead = onTimer._pNext;
+	if (onTimer._pNext)
+		onTimer._pNext->_pPrev = onTimer._pPrev;
+	onTimer._pTimer = NULL;
+	onTimer._ppHead = NULL;
+	onTimer._pPrev = onTimer._pNext = NULL;
+	--_count;
+}
+
+void Timer::cascade(UInt8 level) {
+	// timers of the current slot of this level are distributed in the lower levels
+	UInt8 shift(LEVEL0_BITS + (level - 1)*LEVEL_BITS);
+	const OnTimer*& pHead(_slots[(1 << LEVEL0_BITS) + (level - 1)*(1 << LEVEL_BITS) + ((_time >> shift) & ((1 << LEVEL_BITS) - 1))]);
+	while (pHead) {
+		const OnTimer& onTimer(*pHead);
+		unlink(onTimer);
+		insert(onTimer);
+	}
+}
+
+UInt32 Timer::raise() {
+	Int64 now(Now());
+	while (_time < now) {
+		if (!_count) {
+			_time = now; // nothing to raise meanwhile
+			break;
+		}
+		++_time;
+
+		if (!(_time & ((1 << LEVEL0_BITS) - 1))) {
+			// cascades from the highest level which has wrapped
+			UInt8 level(1);
+			while (level < (LEVELS - 1) && !((_time >> (LEVEL0_BITS + (level - 1)*LEVEL_BITS)) & ((1 << LEVEL_BITS) - 1)))
+				++level;
+			while (level > 0)
+				cascade(level--);
+		}
+
+		const OnTimer*& pHead(_slots[_time & ((1 << LEVEL0_BITS) - 1)]);
+		if (!pHead)
+			continue;
+		// moves the expired timers in _pExpired, to not raise ones which would be set in this same slot by a callback
+		_pExpired = pHead;
+		pHead = NULL;
+		for (const OnTimer* pOnTimer = _pExpired; pOnTimer; pOnTimer = pOnTimer->_pNext)
+			pOnTimer->_ppHead = &_pExpired;
+		while (_pExpired) {
+			const OnTimer& onTimer(*_pExpired);
+			UInt32 delay(UInt32(now - onTimer._expiration));
+			unlink(onTimer);
+			if (!onTimer)
+				continue;
+			// stays attached to this timer during its callback to know if it's removed or deleted meanwhile
+			onTimer._pTimer = this;
+			_pRaising = &onTimer;
+			UInt32 timeout(onTimer(delay));
+			if (!_pRaising)
+				continue; // removed or deleted by its callback
+			_pRaising = NULL;
+			if (!onTimer._ppHead)
+				onTimer._pTimer = NULL; // not set again by its callback
+			if (timeout)
+				set(onTimer, timeout);
+		}
+	}
+	return next();
+}
+
+UInt32 Timer::next() const {
+	if (!_count)
+		return 0;
+	// first tick which will raise a timer, or will cascade a level
+	Int64 expiration(0);
+	for (UInt32 i = 1; i < (1 << LEVEL0_BITS); ++i) {
+		if (_slots[(_time + i) & ((1 << LEVEL0_BITS) - 1)]) {
+			expiration = _time + i;
+			break;
+		}
+	}
+	UInt8 shift(LEVEL0_BITS);
+	for (UInt8 level = 1; level < LEVELS; ++level) {
+		const OnTimer** slots(_slots + (1 << LEVEL0_BITS) + (level - 1)*(1 << LEVEL_BITS));
+		Int64 index(_time >> shift);
+		for (UInt32 i = 1; i <= (1 << LEVEL_BITS); ++i) {
+			if (!slots[(index + i) & ((1 << LEVEL_BITS) - 1)])
+				continue;
+			Int64 cascade((index + i) << shift);
+			if (!expiration || cascade < expiration)
+				expiration = cascade;
+			break;
+		}
+		shift += LEVEL_BITS;
+	}
+	return UInt32(expiration - _time);
+}
+
+
+} // namespace Mona
@@ -25,13 +25,12 @@ using namespace std;
 
 namespace Mona {
 
-Trigger::Trigger() : _time(1),_cycle(0),_running(false) {
+Trigger::Trigger() : _cycle(0),_running(false) {
 	
 }
 
 void Trigger::reset() {
 	_timeInit.update();
-	_time=1;
 	_cycle=0;
 }
 
@@ -42,23 +41,27 @@ void Trigger::start() {
 	_running=true;
 }
 
-UInt16 Trigger::raise(Exception& ex) {
+UInt32 Trigger::interval() const {
+	// 1 sec before the first raising, then 2, 2, 4, 6, 8, 10 and 12 sec before the failure
+	return _cycle>1 ? (_cycle-1)*2000 : (_cycle ? 2000 : 1000);
+}
+
+UInt32 Trigger::timeout() const {
 	if(!_running)
 		return 0;
-	// Wait at least 1 sec before to begin the repeat cycle, it means that it will be between 1 and 3 sec in truth (freg mangement is set to 2)
-	if(_time==1 && !_timeInit.isElapsed(1000))
+	Int64 elapsed(_timeInit.elapsed());
+	return elapsed<interval() ? UInt32(interval()-elapsed) : 1;
+}
+
+UInt16 Trigger::raise(Exception& ex) {
+	if(!_running || _timeInit.elapsed()<interval())
+		return 0;
+	_timeInit.update();
+	if (++_cycle == 8) {
+		ex.set(Exception::PROTOCOL, "Repeat trigger failed");
 		return 0;
-	++_time;
-	if(_time>=_cycle) {
-		_time=1;
-		++_cycle;
-		if (_cycle == 8) {
-			ex.set(Exception::PROTOCOL, "Repeat trigger failed");
-			return 0;
-		}
-		return _cycle;
 	}
-	return 0;
+	return _cycle;
 }
 
 
@@ -28,24 +28,82 @@ using namespace std;
 namespace Mona {
 
 
-UDPSocket::UDPSocket(const SocketManager& manager, bool allowBroadcast) : _socket(*this,manager,Socket::DATAGRAM), _allowBroadcast(allowBroadcast) {
+UDPSocket::UDPSocket(const SocketManager& manager, bool allowBroadcast) : _socket(*this,manager,Socket::DATAGRAM), _allowBroadcast(allowBroadcast),_batchCount(0),_packetSize(0) {
 }
 
 UDPSocket::~UDPSocket() {
 	close();
 }
 
-void UDPSocket::onReadable(Exception& ex,UInt32 available) {
-	if(available==0)
-		return;
+bool UDPSocket::onReadable(Exception& ex) {
+	if (_batchCount)
+		return receiveBatch(ex);
 
-	PoolBuffer pBuffer(_socket.manager().poolBuffers,available);
+	UInt32 available(_socket.available(ex));
+	if (ex)
+		return false;
 	SocketAddress address;
+	if (!available) {
+		// nothing to read, an empty datagram, or a datagram arrived after FIONREAD: peek to not lose it with a zero-sized reading
+		UInt8 peek;
+		if (_socket.receiveFrom(ex, &peek, 0, address, MSG_PEEK) < 0)
+			return ex ? true : false; // error of one datagram (ICMP), or EAGAIN
+		available = _socket.available(ex); // size of the datagram now (0 if it's really empty)
+		if (ex)
+			return false;
+	}
+	PoolBuffer pBuffer(_socket.manager().poolBuffers,available);
 	int size = _socket.receiveFrom(ex,pBuffer->data(), available, address);
-	if (ex || size <= 0)
-		return;
-	pBuffer->resize(size, true);
-	onReception(pBuffer,address);
+	if (ex)
+		return true; // error of one datagram (ICMP), continue to read the following ones
+	if (size < 0)
+		return false; // EAGAIN
+	if (size > 0) { // else empty datagram
+		pBuffer->resize(size, true);
+		onReception(pBuffer,address);
+	}
+	return true;
+}
+
+bool UDPSocket::receiveBatch(Exception& ex) {
+	if (_slots.size() != _batchCount) {
+		_slots.clear();
+		for (UInt16 i = 0; i < _batchCount; ++i)
+			_slots.emplace_back(_socket.manager().poolBuffers, _packetSize);
+		_packets.reserve(_batchCount);
+		_buffers.resize(_batchCount);
+		_lengths.resize(_batchCount);
+		_addresses.resize(_batchCount);
+	}
+
+	for (UInt16 i = 0; i < _batchCount; ++i) {
+		Packet& packet(_slots[i]);
+		// buffer has been reduced by the previous reception, or reallocated if it has been swapped
+		packet.pBuffer->resize(_packetSize, false);
+		_buffers[i] = packet.pBuffer->data();
+		_lengths[i] = _packetSize;
+		_addresses[i] = &packet.address;
+	}
+
+	int count = _socket.receiveFrom(ex, _batchCount, _buffers.data(), _lengths.data(), _addresses.data());
+	UInt32 truncated(0);
+	_packets.clear();
+	for (int i = 0; i < count; ++i) {
+		if (_lengths[i] <= 0) {
+			if (_lengths[i] < 0)
+				++truncated;
+			continue;
+		}
+		Packet& packet(_slots[i]);
+		packet.pBuffer->resize(_lengths[i], true);
+		_packets.emplace_back(&packet);
+	}
+	if (!_packets.empty())
+		onReception(_packets);
+	if (truncated && !ex)
+		ex.set(Exception::NETWORK, truncated, " datagram(s) bigger than ", _packetSize, " bytes ignored");
+	// a full batch means that other datagrams can be waiting, an error concerns just one datagram (ICMP)
+	return count == _batchCount || ex;
 }
 
 bool UDPSocket::send(Exception& ex, const UInt8* data, UInt32 size) {
@@ -23,6 +23,7 @@ This file is a part of Mona.
 #include "Mona/Time.h"
 #include "Mona/Timezone.h"
 #include <fstream>
+#include <algorithm>
 
 
 #if defined(_WIN32)
@@ -92,6 +93,105 @@ UInt8 Util::Get7BitValueSize(UInt64 value) {
 	return result;
 }
 
+static vector<UInt16> ReadProcessorNodes() {
+	vector<UInt16> nodes;
+#if defined(__linux__)
+	// node numbers can have holes
+	string line;
+	vector<UInt16> processors;
+	for (UInt16 node = 0; node < 256; ++node) {
+		ifstream file("/sys/devices/system/node/node" + to_string(node) + "/cpulist");
+		if (!file.good() || !getline(file, line))
+			continue;
+		Exception ex;
+		if (!Util::ParseProcessors(ex, line, processors))
+			continue;
+		for (UInt16 processor : processors) {
+			if (processor >= nodes.size())
+				nodes.resize(processor + 1, 0);
+			nodes[processor] = node;
+		}
+	}
+#endif
+	return nodes;
+}
+
+const vector<UInt16>& Util::ProcessorNodes() {
+	static const vector<UInt16> Nodes(ReadProcessorNodes());
+	return Nodes;
+}
+
+UInt16 Util::NodeCount() {
+	static const UInt16 Count(ProcessorNodes().empty() ? 1 : (*max_element(ProcessorNodes().begin(), ProcessorNodes().end()) + 1));
+	return Count;
+}
+
+UInt16 Util::CurrentNode() {
+#if defined(__linux__)
+	const vector<UInt16>& nodes(ProcessorNodes());
+	int processor(sched_getcpu());
+	if (processor >= 0 && (size_t)processor < nodes.size())
+		return nodes[processor];
+#endif
+	return 0;
+}
+
+bool Util::ParseProcessors(Exception& ex, const string& value, vector<UInt16>& processors) {
+	processors.clear();
+	vector<string> items;
+	String::Split(value, ",", items, String::SPLIT_IGNORE_EMPTY | String::SPLIT_TRIM);
+	for (string& item : items) {
+		if (String::ICompare(item, "node", 4) == 0) {
+			UInt16 node(String::ToNumber<UInt16>(ex, item.substr(4), 0));
+			if (ex)
+				return false;
+			const vector<UInt16>& nodes(ProcessorNodes());
+			size_t size(processors.size());
+			for (UInt16 processor = 0; processor < nodes.size(); ++processor) {
+				if (nodes[processor] == node)
+					processors.emplace_back(processor);
+			}
+			if (processors.size() == size) {
+				ex.set(Exception::ARGUMENT, "NUMA node ", node, " unknown");
+				return false;
+			}
+			continue;
+		}
+		size_t dash(item.find('-'));
+		UInt16 first(String::ToNumber<UInt16>(ex, item.substr(0, dash), 0));
+		UInt16 last(dash == string::npos ? first : String::ToNumber<UInt16>(ex, item.substr(dash + 1), 0));
+		if (ex)
+			return false;
+		if (last < first) {
+			ex.set(Exception::ARGUMENT, "Invalid processors range ", item);
+			return false;
+		}
+		while (first <= last)
+			processors.emplace_back(first++);
+	}
+	sort(processors.begin(), processors.end());
+	processors.erase(unique(processors.begin(), processors.end()), processors.end());
+	return true;
+}
+
+string& Util::FormatProcessors(const vector<UInt16>& processors, string& value) {
+	value.clear();
+	auto it = processors.begin();
+	while (it != processors.end()) {
+		// compacts the consecutive processors in a range
+		auto itLast(it);
+		while ((itLast + 1) != processors.end() && *(itLast + 1) == *itLast + 1)
+			++itLast;
+		if (!value.empty())
+			value += ',';
+		String::Append(value, *it);
+		if (itLast != it)
+			String::Append(value, '-', *itLast);
+		it = itLast + 1;
+	}
+	return value;
+}
+
 // environment variables (TODO test on service windows!!)
 const MapParameters& Util::Environment() {
 	lock_guard<mutex> lock(_MutexEnvironment);
@@ -79,6 +79,7 @@ public:
 		VIDEO				=0x09,
 		DATA				=0x0F,
 		INVOCATION_AMF3		=0x11,
+		DATA_AMF0			=0x12, // also the FLV tag type of script data
 		INVOCATION			=0x14
 	};
 };
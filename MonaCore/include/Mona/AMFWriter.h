@@ -27,7 +27,7 @@ This file is a part of Mona.
 namespace Mona {
 
 
-class AMFWriter : public DataWriter {
+class AMFWriter : public DataWriter, public PoolObject<AMFWriter> {
 public:
 	AMFWriter(const PoolBuffers& poolBuffers);
 
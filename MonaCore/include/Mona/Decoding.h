@@ -46,11 +46,16 @@ private:
 	bool			run(Exception& ex);
 	void			handle(Exception& ex);
 
+	// post to the invoker thread without waiting its handling, deferred after its queue if full
+	void			post(const std::shared_ptr<Task>& pTask);
+
 	PoolBuffer						_pBuffer;
 	Expirable<Session>				_expirableSession;
 	SocketAddress					_address;
 	UInt32							_size;
 	const UInt8*					_current;
+	Invoker&						_invoker;
+	std::weak_ptr<Decoding>			_pThis; // set by Session to post itself
 };
 
 
@@ -23,6 +23,7 @@ This file is a part of Mona.
 #include "Mona/Writer.h"
 #include "Mona/AMF.h"
 #include "Mona/AMFWriter.h"
+#include "Mona/AMFReader.h"
 
 namespace Mona {
 
@@ -38,6 +39,10 @@ public:
 	AMFWriter&				writeAMFStatus(const std::string& code, const std::string& description, bool withoutClosing = false) { return writeAMFState("onStatus", code, description, withoutClosing); }
 	AMFWriter&				writeAMFError(const std::string& code, const std::string& description, bool withoutClosing = false) { return writeAMFState("_error", code, description, withoutClosing); }
 	bool					writeMedia(MediaType type,UInt32 time,PacketReader& packet);
+	bool					writeMedia(MediaType type,UInt32 time,const SharedBuffer& payload);
+
+	// data of RTMP and RTMFP streams are AMF
+	void					createReader(PacketReader& packet,std::shared_ptr<DataReader>& pReader) { pReader.reset(new AMFReader(packet)); }
 
 protected:
 	FlashWriter(WriterHandler* pHandler=NULL);
@@ -45,6 +50,8 @@ protected:
 	virtual ~FlashWriter();
 
 	virtual AMFWriter&		write(AMF::ContentType type,UInt32 time=0,PacketReader* pPacket=NULL)=0;
+	// by default copies the payload, to overload when the protocol can send it without copy
+	virtual AMFWriter&		write(AMF::ContentType type,UInt32 time,const SharedBuffer& payload);
 
 	AMFWriter&				writeAMFState(const std::string& name,const std::string& code,const std::string& description,bool withoutClosing=false);
 };
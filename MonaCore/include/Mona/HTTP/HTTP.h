@@ -154,10 +154,18 @@ public:
 		SORT_BY_SIZE = 8
 	};
 
+	enum EncodingType {
+		ENCODING_IDENTITY = 0,
+		ENCODING_GZIP = 1,
+		ENCODING_BROTLI = 2
+	};
+
 	
 	static CommandType	ParseCommand(Exception& ex,const char* value);
 	static ContentType	ParseContentType(const char* value,std::string& subType);
 	static UInt8		ParseConnection(Exception& ex,const char* value);
+	// returns the EncodingType accepted by a "Accept-Encoding" header
+	static UInt8		ParseAcceptEncoding(const char* value);
 
 	static std::string&	FormatContentType(ContentType type,const std::string& subType,std::string& value);
 
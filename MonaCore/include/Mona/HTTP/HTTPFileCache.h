@@ -0,0 +1,93 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Startable.h"
+#include "Mona/SharedBuffer.h"
+#include "Mona/FilePath.h"
+#include "Mona/HTTP/HTTP.h"
+#include <list>
+#include <unordered_map>
+
+namespace Mona {
+
+/// \class LRU cache of small static files with their prebuilt response headers,
+/// invalidated by inotify on Linux (revalidated every second elsewhere)
+class HTTPFileCache : private Startable, virtual Object {
+public:
+	class File : virtual Object {
+	public:
+		File(const std::string& path, Int64 lastModified) : path(path), lastModified(lastModified), type(HTTP::CONTENT_ABSENT), size(0) {}
+
+		const std::string	path;
+		const Time			lastModified;
+
+		HTTP::ContentType	type;
+		std::string			subType;
+		std::string			etag; // strong, quoted
+		std::string			headers; // Last-Modified, ETag, Accept-Ranges (and Vary if compressed variants)
+		SharedBuffer		content;
+		SharedBuffer		gzip; // precompressed variant (path.gz)
+		SharedBuffer		brotli; // precompressed variant (path.br)
+		UInt32				size; // memory used
+	private:
+		friend class HTTPFileCache;
+		Time				_checked;
+	};
+
+	HTTPFileCache(const PoolBuffers& poolBuffers);
+	virtual ~HTTPFileCache();
+
+	/// \brief size = memory limit of the cache, fileSize = size limit of a file to cache (0 disables the cache)
+	bool	start(Exception& ex, UInt32 size, UInt32 fileSize);
+	void	stop();
+
+	/// \brief returns the cached file without any disk access, or null
+	std::shared_ptr<const File> find(const std::string& path);
+	/// \brief reads the file and its precompressed variants to cache it, returns null if it can't be cached
+	std::shared_ptr<const File> load(const FilePath& file);
+
+	UInt32	count();
+	UInt32	size();
+
+private:
+	void	run(Exception& ex);
+	void	invalidate(const std::string& path);
+	bool	watch(const std::string& directory);
+	void	remove(std::list<std::shared_ptr<File>>::iterator it);
+
+	const PoolBuffers&	_poolBuffers;
+	UInt32				_maxSize;
+	UInt32				_maxFileSize;
+
+	std::mutex															_mutex;
+	std::list<std::shared_ptr<File>>									_files; // most recently used first
+	std::unordered_map<std::string, std::list<std::shared_ptr<File>>::iterator>	_index;
+	UInt32																_size;
+	UInt32																_invalidations; // to not cache a file modified during its reading
+
+	int									_inotify;
+	std::unordered_map<int, std::string>	_watches; // directory by watch descriptor
+	std::unordered_map<std::string, int>	_directories;
+};
+
+
+} // namespace Mona
@@ -50,6 +50,10 @@ public:
 	UInt8						cacheControl;
 	
 	Date						ifModifiedSince;
+	std::string					range;
+	std::string					ifRange;
+	std::string					ifNoneMatch;
+	UInt8						acceptEncoding;
 	UInt8						accessControlRequestMethod;
 
 	std::string					secWebsocketKey;
@@ -25,6 +25,7 @@ This file is a part of Mona.
 #include "Mona/FilePath.h"
 #include "Mona/HTTP/HTTP.h"
 #include "Mona/HTTP/HTTPPacket.h"
+#include "Mona/HTTP/HTTPFileCache.h"
 #include "Mona/Client.h"
 
 
@@ -49,26 +50,43 @@ public:
 
 	DataWriter&		writer(const std::string& code, HTTP::ContentType type, const std::string& subType,const UInt8* data,UInt32 size);
 	void			writeError(int code, const std::string& description,bool close=false);
-	void			writeFile(const FilePath& file, UInt8 sortOptions, bool isApp) { _file = file; _sortOptions = sortOptions; _isApp = isApp; }
+	void			writeFile(const FilePath& file, UInt8 sortOptions, bool isApp, const std::shared_ptr<HTTPFileCache>& pFileCache = nullptr, const std::shared_ptr<const HTTPFileCache::File>& pCachedFile = nullptr) {
+		_file = file; _sortOptions = sortOptions; _isApp = isApp; _pFileCache = pFileCache; _pCachedFile = pCachedFile;
+	}
 
 	const UInt8*	data() { return _pWriter ? _pWriter->packet.data() : NULL; }
 	UInt32			size() { return _pWriter ? _pWriter->packet.size() : 0; }
 
 	BinaryWriter&	writeRaw(const PoolBuffers& poolBuffers);
+	// payload sent without copy after what has been written with writeRaw
+	using SocketSender::share;
 private:
 	bool			run(Exception& ex);
 
 	DataWriter&		write(const std::string& code, HTTP::ContentType type = HTTP::CONTENT_TEXT, const std::string& subType = "html; charset=utf-8") { return writer(code, type, subType, NULL, 0); }
 
+	/// \brief Write a file of the cache, its content is shared rather than copied
+	void			writeCachedFile(const HTTPFileCache::File& file);
+	void			writeRangeNotSatisfiable(UInt64 size);
+	/// \brief true if "If-Range" is absent or matchs the file, etag can be empty
+	bool			matchIfRange(const std::string& etag, const Time& lastModified);
+
 	/// \brief  Write content file and replace the "<% key %>" field 
 	/// by relating parameters[key]
 	static void			ReplaceTemplateTags(PacketWriter& packet, std::ifstream& ifile, MapWriter<std::map<std::string,std::string>>& parameters);
 
+	/// \brief Parse a "Range" header value for a content of size bytes, just one range is supported
+	/// \return 1 with the range to send, 0 if the whole content has to be sent, -1 if the range is not satisfiable
+	static Int8			ParseRange(const std::string& value, UInt64 size, UInt64& offset, UInt64& length);
+
 	bool								_isApp;
 	FilePath							_file;
 	UInt8								_sortOptions;
 	const std::shared_ptr<HTTPPacket>	_pRequest;
 	UInt32								_sizePos;
+	UInt64								_fileLength; // body sent from the file or the cache after the packet
+	std::shared_ptr<HTTPFileCache>		_pFileCache;
+	std::shared_ptr<const HTTPFileCache::File>	_pCachedFile;
 	std::unique_ptr<DataWriter>			_pWriter;
 	std::string							_buffer;
 	SocketAddress						_address;
@@ -39,7 +39,7 @@ public:
 	
 private:
 	void			kill();
-	void			manage();
+	UInt32			manage();
 
 	bool								buildPacket(PoolBuffer& pBuffer,PacketReader& packet);
 	const std::shared_ptr<HTTPPacket>&	packet();
@@ -62,6 +62,7 @@ private:
 	std::shared_ptr<PoolBuffer>						_ppBuffer;
 
 	HTTPOptionsWriter								_options;
+	std::shared_ptr<HTTPFileCache>					_pFileCache;
 };
 
 
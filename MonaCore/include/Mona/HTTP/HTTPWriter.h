@@ -40,6 +40,9 @@ public:
 	virtual State			state(State value=GET,bool minimal=false);
 	virtual void			flush(bool full=false);
 
+	virtual UInt32			queueing() { return _tcpClient.queueing(); }
+	virtual bool			congested() { return _tcpClient.congested(); }
+
 	virtual DataWriter&		writeInvocation(const std::string& name) { DataWriter& writer = write("200 OK", contentType, contentSubType); writer.writeString(name); return writer; }
 	virtual DataWriter&		writeMessage() { return write("200 OK", contentType, contentSubType); }
 	virtual DataWriter&		writeResponse(UInt8 type);
@@ -52,7 +55,9 @@ public:
 	/// \param file path of the file
 	/// \param sortOptions Sort options for directory listing
 	/// \param isApp True if file is an application
-	void			writeFile(const FilePath& file, UInt8 sortOptions, bool isApp) { return createSender().writeFile(file,sortOptions,isApp);}	
+	/// \param pFileCache Cache to keep the file if it's small enough
+	/// \param pCachedFile File already in the cache
+	void			writeFile(const FilePath& file, UInt8 sortOptions, bool isApp, const std::shared_ptr<HTTPFileCache>& pFileCache = nullptr, const std::shared_ptr<const HTTPFileCache::File>& pCachedFile = nullptr) { return createSender().writeFile(file,sortOptions,isApp,pFileCache,pCachedFile);}	
 
 	void			close(const Exception& ex);
 	
@@ -61,15 +66,17 @@ public:
 	std::string							contentSubType; ///< Content sub type for pull response 
 private:
 	bool			writeMedia(MediaType type,UInt32 time,PacketReader& packet);
+	bool			writeMedia(MediaType type,UInt32 time,const SharedBuffer& payload);
+	bool			writeMedia(MediaType type,UInt32 time,const SharedBuffer& payload,MediaCache& cache);
 	
 	HTTPSender& createSender() {
-		_senders.emplace_back(new HTTPSender(_tcpClient.address(),pRequest));
+		_senders.emplace_back(PoolObjects::New<HTTPSender>(_tcpClient.address(),pRequest));
 		return *_senders.back();
 	}
 
 	std::unique_ptr<MediaContainer>				_pMedia;
 	TCPClient&									_tcpClient;
-	PoolThread*									_pThread;
+	PoolThreads::Queue							_sendingQueue;
 	std::vector<std::shared_ptr<HTTPSender>>	_senders;
 	bool										_isMain;
 	std::string									_buffer;
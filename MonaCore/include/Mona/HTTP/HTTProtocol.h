@@ -22,13 +22,26 @@ This file is a part of Mona.
 #include "Mona/Mona.h"
 #include "Mona/TCProtocol.h"
 #include "Mona/HTTP/HTTPSession.h"
+#include "Mona/HTTP/HTTPFileCache.h"
 
 namespace Mona {
 
 class HTTProtocol : public TCProtocol, virtual Object {
 public:
-	HTTProtocol(const char* name, Invoker& invoker, Sessions& sessions) : TCProtocol(name, invoker, sessions) {}
-	~HTTProtocol() { stop(); }
+	HTTProtocol(const char* name, Invoker& invoker, Sessions& sessions) : TCProtocol(name, invoker, sessions), pFileCache(new HTTPFileCache(invoker.poolBuffers)) {}
+	~HTTProtocol() { stop(); pFileCache->stop(); }
+
+	bool load(Exception& ex, const HTTPParams& params) {
+		if (!TCProtocol::load(ex, params))
+			return false;
+		Exception exCache;
+		if (!pFileCache->start(exCache, params.cacheSize, params.cacheFileSize) || exCache)
+			WARN("HTTP file cache, ", exCache.error());
+		return true;
+	}
+
+	// shared with the senders, which can run after the protocol deletion
+	const std::shared_ptr<HTTPFileCache>	pFileCache;
 private:
 	// Create session
 	void onClient(Exception& ex,const SocketAddress& address,SocketFile& file) {
@@ -43,6 +43,7 @@ public:
 
 	virtual bool			onPublish(Client& client,const Publication& publication,std::string& error){return true;}
 	virtual void			onUnpublish(Client& client,const Publication& publication){}
+	virtual bool			onRecord(Client& client,const Publication& publication,std::string& error){return true;}
 
 	virtual void			onDataPacket(Client& client,const Publication& publication,DataReader& packet){}
 	virtual void			onAudioPacket(Client& client,const Publication& publication,UInt32 time,PacketReader& packet){}
@@ -53,7 +54,7 @@ public:
 	virtual void			onUnsubscribe(Client& client,const Listener& listener){}
 
 protected:
-	Handler(UInt32 socketBufferSize, UInt16 threads) : _myself(*this), Invoker(socketBufferSize, threads) {
+	Handler(UInt32 socketBufferSize, UInt16 threads, UInt16 reactors) : _myself(*this), Invoker(socketBufferSize, threads, reactors) {
 		Util::Random(id, ID_SIZE); // Allow to publish in intern (Invoker is the publisher)
 		(bool&)_myself.connected=true;
 		std::memcpy((UInt8*)myself().id,id,ID_SIZE);
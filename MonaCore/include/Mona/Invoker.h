@@ -26,11 +26,15 @@ This file is a part of Mona.
 #include "Mona/Clients.h"
 #include "Mona/SocketManager.h"
 #include "Mona/TaskHandler.h"
+#include "Mona/DNSResolver.h"
 #include "Mona/PoolThreads.h"
 #include "Mona/PoolBuffers.h"
+#include "Mona/FileWriter.h"
+#include "Mona/Timer.h"
 #include "Mona/ServerParams.h"
 #include "Mona/FlashMainStream.h"
 #include "Mona/RelayServer.h"
+#include "Mona/VOD.h"
 
 namespace Mona {
 
@@ -43,8 +47,11 @@ public:
 	Publications			publications;
 	const SocketManager		sockets;
 	const RelayServer		relay;
+	DNSResolver				resolver; // results are delivered to the server thread
 	PoolThreads				poolThreads;
 	const PoolBuffers		poolBuffers;
+	FileWriter				fileWriter; // recordings
+	const Timer				timer; // raised by the server thread, to use just from it
 
 	std::shared_ptr<FlashStream>&	createFlashStream(Peer& peer);
 	FlashStream&					flashStream(UInt32 id, Peer& peer,std::shared_ptr<FlashStream>& pStream);
@@ -55,8 +62,13 @@ public:
 
 	Publication*			publish(Exception& ex,Peer& peer,const std::string& name);
 	void					unpublish(Peer& peer,const std::string& name);
+	/// Subscribe to the live publication, or to the FLV file name(.flv) of params.vodPath if name is not published
 	Listener*				subscribe(Exception& ex,Peer& peer,const std::string& name,Writer& writer,double start=-2000);
 	void					unsubscribe(Peer& peer,const std::string& name);
+	/// Seek in the VOD played, false if peer doesn't play a VOD name
+	bool					seek(Peer& peer,const std::string& name,UInt32 time);
+	/// Record the publication in params.recordPath (fails if empty, recording disabled), continues the file if append
+	Recorder*				record(Exception& ex,Publication& publication,bool append=false);
 
 	void					addBanned(const IPAddress& ip) { _bannedList.insert(ip); }
 	void					removeBanned(const IPAddress& ip) { _bannedList.erase(ip); }
@@ -68,13 +80,14 @@ public:
 	std::string				buffer;
 
 protected:
-	Invoker(UInt32 socketBufferSize,UInt16 threads);
+	Invoker(UInt32 socketBufferSize,UInt16 threads,UInt16 reactors);
 	virtual ~Invoker();
 
 private:
 	virtual Peer&			myself()=0;
 
 	std::map<std::string,Publication>				_publications;
+	std::map<std::string,VOD>						_vods;
 	std::set<IPAddress>								_bannedList;
 	UInt32											_nextId;
 	std::map<UInt32,std::shared_ptr<FlashStream> >	_streams;
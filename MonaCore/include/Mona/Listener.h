@@ -35,8 +35,8 @@ public:
 	void startPublishing();
 	void stopPublishing(); 
 
-	void pushAudioPacket(PacketReader& packet,UInt32 time=0); 
-	void pushVideoPacket(PacketReader& packet,UInt32 time=0);
+	void pushAudioPacket(const SharedBuffer& payload,MediaCache& cache,UInt32 time=0); 
+	void pushVideoPacket(const SharedBuffer& payload,MediaCache& cache,UInt32 time=0);
 	void pushDataPacket(DataReader& reader);
 
 	void flush();
@@ -48,12 +48,21 @@ public:
 	Client&				client;
 
 	UInt32					droppedFrames() const { return _droppedFrames; }
+	// video frames dropped while the writer was congested (included in droppedFrames), and the greatest queue observed
+	UInt32					congestedFrames() const { return _congestedFrames; }
+	UInt32					peakQueueing() const { return _peakQueueing; }
+	// true while the writers of the listener are congested
+	bool					congested() { return (_pVideoWriter && _pVideoWriter->congested()) || (_pAudioWriter && _pAudioWriter->congested()); }
+	// ms between the subscription and the first video frame sent (0 while no frame has been sent)
+	UInt32					firstFrameTime() const { return _firstFrameTime; }
 	const QualityOfService&	videoQOS() const;
 	const QualityOfService&	audioQOS() const;
 	const QualityOfService&	dataQOS() const;
 
 	
 	void setBufferTime(UInt32 ms) { _bufferTime = ms; }
+	/// Next frames restart from a key frame of time (seek in a VOD), their time is relative to it
+	void seek(UInt32 time);
 
 private:
 	bool	init();
@@ -81,6 +90,11 @@ private:
 	Writer*					_pVideoWriter;
 	Writer*					_pDataWriter;
 	UInt32					_droppedFrames;
+	UInt32					_congestedFrames;
+	UInt32					_peakQueueing;
+	Time					_subscribing;
+	UInt32					_firstFrameTime;
+	bool					_firstFrameSent;
 	PacketReader			_publicationNamePacket;
 };
 
@@ -21,6 +21,7 @@ This file is a part of Mona.
 
 #include "Mona/Mona.h"
 #include "Mona/BinaryWriter.h"
+#include "Mona/SharedBuffer.h"
 
 
 namespace Mona {
@@ -55,6 +56,10 @@ public:
 	virtual void write(BinaryWriter& writer,UInt8 track=BOTH);
 	// To write audio or video packet
 	virtual void write(BinaryWriter& writer, UInt8 track, UInt32 time, const UInt8* data, UInt32 size);
+
+	// To write a packet around a payload written elsewhere (header, then payload, then footer)
+	static void	WriteTagHeader(BinaryWriter& writer, UInt8 track, UInt32 time, UInt32 size);
+	static void	WriteTagFooter(BinaryWriter& writer, UInt32 size) { writer.write32(11+size); }
 };
 
 class MPEGTS : public MediaContainer {
@@ -65,6 +70,8 @@ public:
 	virtual void write(BinaryWriter& writer,UInt8 track=BOTH);
 	// To write audio or video packet
 	virtual void write(BinaryWriter& writer, UInt8 track, UInt32 time, const UInt8* data, UInt32 size);
+	// To rewrite with the time and the continuity counters of this stream a packet written by an other MPEGTS
+	void patch(UInt8* data, UInt32 size, UInt8 track, UInt32 time);
 private:
 	
 	/// \brief Write recursively data of subReader in TS format
@@ -89,6 +96,10 @@ private:
 	/// \return false if format error detected
 	static bool			WritePES(BinaryWriter& writer, Track type, SubstreamMap& subReader, UInt8& toWrite);
 
+	/// \brief Format the 6 bytes of the PCR and the 5 bytes of the PTS
+	static void			FormatPCR(UInt64 pts, UInt8* data);
+	static void			FormatPTS(UInt64 pts, UInt8* data);
+
 	/// \brief Determine CRC32 value of input data
 	//static UInt32	CalcCrc32(UInt8 * data, UInt32 datalen);
 	//static UInt32					CrcTab[];
@@ -96,6 +107,22 @@ private:
 	std::map<Track, UInt32>	_counterRow;			///< Counter for each program/track
 };
 
+/// Serializations of the current media frame of a publication, by container format:
+/// the first writer of a format serializes the frame, the next ones copy these bytes and patch just their own fields
+class MediaCache : virtual Object {
+public:
+	enum Format {
+		FORMAT_MPEGTS = 0,
+		FORMATS
+	};
+
+	SharedBuffer&	operator[](Format format) { return _frames[format]; }
+	void			clear() { for (SharedBuffer& frame : _frames) frame = SharedBuffer(); }
+
+private:
+	SharedBuffer	_frames[FORMATS];
+};
+
 
 
 } // namespace Mona
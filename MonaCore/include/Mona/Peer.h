@@ -70,6 +70,7 @@ public:
 
 	bool onPublish(const Publication& publication,std::string& error);
 	void onUnpublish(const Publication& publication);
+	bool onRecord(const Publication& publication,std::string& error);
 
 	void onDataPacket(const Publication& publication,DataReader& packet);
 	void onAudioPacket(const Publication& publication,UInt32 time,PacketReader& packet);
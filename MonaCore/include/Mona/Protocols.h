@@ -35,6 +35,11 @@ public:
 	void unload() { _protocols.clear(); }
 	void manage() { for (std::unique_ptr<Protocol>& pProtocol : _protocols) pProtocol->manage(); }
 
+	typedef std::vector<std::unique_ptr<Protocol>>::const_iterator Iterator;
+	Iterator	begin() const { return _protocols.begin(); }
+	Iterator	end() const { return _protocols.end(); }
+	UInt32		count() const { return _protocols.size(); }
+
 private:
 	template<class ProtocolType, class ParamsType,typename ...Args >
 	void loadProtocol(const char* name, const ParamsType& params, Sessions& sessions, Args&&... args) {
@@ -23,12 +23,15 @@ This file is a part of Mona.
 #include "Mona/Exceptions.h"
 #include "Mona/Listeners.h"
 #include "Mona/Peer.h"
+#include "Mona/TimeShift.h"
+#include "Mona/Recorder.h"
+#include <deque>
 
 namespace Mona {
 
 class Publication : virtual Object {
 public:
-	Publication(const std::string& name);
+	Publication(const std::string& name,const PoolBuffers& poolBuffers);
 	virtual ~Publication();
 
 	const std::string&		name() const { return _name; }
@@ -45,6 +48,24 @@ public:
 
 	void					setBufferTime(UInt32 ms);
 
+	/// Keep the frames since the last key frame (and the last metadata) to burst them to a new listener,
+	/// rather than it waits the next key frame. The cache is limited in bytes and in ms, size=0 disables it
+	void					setGOPCache(UInt32 size, UInt32 duration);
+	UInt32					gopCacheSize() const { return _gopCacheSize; }
+	UInt32					gopCacheDuration() const { return _gopCacheDuration; }
+	// bytes currently cached
+	UInt32					gopCached() const { return _gopCached; }
+
+	/// Keep the frames of the last window ms (in memory, or in a file of size bytes if path is not empty),
+	/// then a listener can start at a time of this window and catch up the live, window=0 disables it
+	bool					setTimeShift(Exception& ex, UInt32 window, UInt32 size, const std::string& path = "");
+	const TimeShift&		timeShift() const { return _timeShift; }
+
+	/// Record the publication in path.flv (see Recorder) if its publisher is allowed (see Handler::onRecord), the returned recorder can be configured before the next frame
+	Recorder*				startRecording(Exception& ex, FileWriter& fileWriter, const std::string& path, bool append = false);
+	void					stopRecording();
+	const Recorder*			recorder() const { return _pRecorder.get(); }
+
 	void					start(Exception& ex, Peer& peer);
 	void					stop(Peer& peer);
 
@@ -52,7 +73,8 @@ public:
 	void					pushVideo(PacketReader& packet,UInt32 time=0,UInt32 numberLostFragments=0);
 	void					pushData(DataReader& reader,UInt32 numberLostFragments=0);
 
-	Listener*				addListener(Exception& ex, Peer& peer,Writer& writer,bool unbuffered);
+	/// start>=0 is the time where the listener starts in the time-shift buffer, otherwise it starts on the live
+	Listener*				addListener(Exception& ex, Peer& peer,Writer& writer,bool unbuffered,double start=-2000);
 	void					removeListener(Peer& peer);
 
 	void					flush();
@@ -60,6 +82,26 @@ public:
 	const Buffer&			audioCodecBuffer() const { return _audioCodecBuffer; }
 	const Buffer&			videoCodecBuffer() const { return _videoCodecBuffer; }
 private:
+	void								clearGOPCache();
+	void								cacheFrame(Writer::MediaType type, UInt32 time, const SharedBuffer& payload);
+	void								pushMetaData(Listener& listener);
+	void								replay();
+	void								replay(Client* pClient);
+
+	struct Frame {
+		Frame(Writer::MediaType type, UInt32 time, const SharedBuffer& payload) : type(type), time(time), payload(payload) {}
+		Writer::MediaType	type;
+		UInt32				time;
+		SharedBuffer		payload;
+	};
+
+	struct TimeShifted {
+		TimeShifted(UInt64 sequence, UInt32 time) : sequence(sequence), time(time) {}
+		UInt64				sequence; // next frame to send
+		UInt32				time; // time of the first frame sent
+		Time				clock; // when the first frame has been sent
+	};
+
 	Peer*								_pPublisher;
 	bool								_firstKeyFrame;
 	std::string							_name;
@@ -68,12 +110,24 @@ private:
 	Buffer								_audioCodecBuffer;
 	Buffer								_videoCodecBuffer;
 
+	UInt32								_gopCacheSize;
+	UInt32								_gopCacheDuration;
+	UInt32								_gopCached;
+	std::deque<Frame>					_gopFrames; // empty while no key frame starts the cache
+	SharedBuffer						_metaData;
+
+	TimeShift							_timeShift;
+	std::map<Client*,TimeShifted>		_timeShifted; // listeners which play the time-shift buffer
+
+	std::unique_ptr<Recorder>			_pRecorder;
+
 	QualityOfService					_videoQOS;
 	QualityOfService					_audioQOS;
 	QualityOfService					_dataQOS;
 
 	UInt32						_droppedFrames;
 	bool						_new;
+	const PoolBuffers&			_poolBuffers;
 };
 
 
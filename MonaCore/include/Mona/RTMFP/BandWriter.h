@@ -37,6 +37,8 @@ public:
 	virtual UInt32						availableToWrite()=0;
 	virtual BinaryWriter&				writeMessage(UInt8 type,UInt16 length,RTMFPWriter* pWriter=NULL)=0;
 	virtual void						flush(bool full=true)=0;
+	// the writers have to be managed before timeout ms (to flush queued messages, or repeat ones)
+	virtual void						manageIn(UInt32 timeout)=0;
 	
 };
 
@@ -34,6 +34,7 @@ namespace Mona {
 #define RTMFP_HEADER_SIZE		11
 #define RTMFP_MIN_PACKET_SIZE	(RTMFP_HEADER_SIZE+1)
 #define RTMFP_MAX_PACKET_SIZE	1192
+#define RTMFP_RECEPTION_BATCH	32
 #define RTMFP_TIMESTAMP_SCALE	4.0
 
 
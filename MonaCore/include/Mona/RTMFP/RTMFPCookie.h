@@ -36,7 +36,7 @@ public:
 
 	const std::shared_ptr<Peer> pPeer;
 
-	bool					run(Exception& ex) { _pComputingThread = _invoker.poolThreads.enqueue<RTMFPCookieComputing>(ex, _pCookieComputing, _pComputingThread); return !ex; }
+	bool					run(Exception& ex) { return _invoker.poolThreads.enqueue<RTMFPCookieComputing>(ex, _pCookieComputing, &_computingQueue); }
 
 	const UInt8*			value() { return _pCookieComputing->value; }
 	const UInt8*			decryptKey()  { return _pCookieComputing->decryptKey; }
@@ -49,7 +49,7 @@ public:
 	UInt16					length() { return _pCookieComputing->packet.size() + 4; }
 	void					read(PacketWriter& packet) {packet.write32(id).writeRaw(_pCookieComputing->packet.data(),_pCookieComputing->packet.size());}
 private:
-	PoolThread*								_pComputingThread;
+	PoolThreads::Queue						_computingQueue;
 	std::shared_ptr<RTMFPCookieComputing>	_pCookieComputing;
 	Time									_createdTimestamp;
 	Invoker&								_invoker;
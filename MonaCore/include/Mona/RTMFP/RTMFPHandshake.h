@@ -42,7 +42,7 @@ public:
 	virtual ~RTMFPHandshake();
 
 	void			commitCookie(const UInt8* value);
-	void			manage();
+	UInt32			manage();
 	void			clear();
 	RTMFPSession*	createSession(const UInt8* cookieValue);
 
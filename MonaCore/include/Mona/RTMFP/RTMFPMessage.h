@@ -21,6 +21,7 @@ This file is a part of Mona.
 
 #include "Mona/Mona.h"
 #include "Mona/AMFWriter.h"
+#include "Mona/SharedBuffer.h"
 
 
 namespace Mona {
@@ -34,6 +35,9 @@ public:
 	virtual const UInt8*	data()=0;
 	virtual UInt32			size()=0;
 
+	// writes the fragment [offset, offset+size[ of the message
+	virtual void			write(BinaryWriter& writer, UInt32 offset, UInt32 size) { writer.writeRaw(data()+offset, size); }
+
 	std::map<UInt32,UInt64>	fragments;
 	const bool				repeatable;
 
@@ -55,7 +59,7 @@ private:
 
 
 
-class RTMFPMessageBuffered: public RTMFPMessage, virtual NullableObject {
+class RTMFPMessageBuffered: public RTMFPMessage, public PoolObject<RTMFPMessageBuffered>, virtual NullableObject {
 public:
 	RTMFPMessageBuffered(const PoolBuffers& poolBuffers,bool repeatable) : _pWriter(new AMFWriter(poolBuffers)),RTMFPMessage(repeatable) {}
 	RTMFPMessageBuffered() : _pWriter(&AMFWriter::Null),RTMFPMessage(false) {}
@@ -66,12 +70,28 @@ public:
 
 	operator bool() const { return *_pWriter; }
 
+	// payload following the writer content, kept without copy until the fragments are written
+	void			share(const SharedBuffer& payload) { _payload = payload; }
+
 private:
 
 	const UInt8*	data() { return _pWriter->packet.data(); }
-	UInt32			size() { return _pWriter->packet.size(); }
+	UInt32			size() { return _pWriter->packet.size() + _payload.size(); }
+
+	void			write(BinaryWriter& writer, UInt32 offset, UInt32 size) {
+		UInt32 available(_pWriter->packet.size());
+		if (offset < available) {
+			UInt32 count(size < (available - offset) ? size : (available - offset));
+			writer.writeRaw(_pWriter->packet.data() + offset, count);
+			offset += count;
+			size -= count;
+		}
+		if (size > 0)
+			writer.writeRaw(_payload.data() + offset - available, size);
+	}
 
 	AMFWriter*		_pWriter;
+	SharedBuffer	_payload;
 
 };
 
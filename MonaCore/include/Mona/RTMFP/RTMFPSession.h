@@ -35,6 +35,7 @@ class RTMFPSession : public BandWriter,public Session, virtual Object {
 public:
 
 	RTMFPSession(RTMFProtocol& protocol,
+			UInt8 shard,
 			Invoker& invoker,
 			UInt32 farId,
 			const UInt8* decryptKey,
@@ -51,8 +52,12 @@ public:
 
 	bool				failed() const { return _failed; }
 
+	// RTMFP socket used to send the packets of this session (see RTMFPParams::shards)
+	const UInt8			shard;
+
 protected:
 	RTMFPSession(RTMFProtocol& protocol,
+			UInt8 shard,
 			Invoker& invoker,
 			UInt32 farId,
 			const UInt8* decryptKey,
@@ -92,7 +97,7 @@ protected:
 private:
 	
 
-	void							manage();
+	UInt32							manage();
 	void							packetHandler(PacketReader& packet);
 
 	// Implementation of BandWriter
@@ -102,6 +107,7 @@ private:
 	bool							canWriteFollowing(RTMFPWriter& writer) { return _pLastWriter == &writer; }
 	void							close() { failSignal(); }
 	UInt32							availableToWrite() { return RTMFP_MAX_PACKET_SIZE - (_pSender ? _pSender->packet.size() : RTMFP_HEADER_SIZE); }
+	void							manageIn(UInt32 timeout) { Session::manageIn(timeout); }
 
 	BinaryWriter&					writeMessage(UInt8 type,UInt16 length,RTMFPWriter* pWriter=NULL);
 
@@ -136,7 +142,7 @@ private:
 
 	const std::shared_ptr<RTMFPKey>					_pDecryptKey;
 	const std::shared_ptr<RTMFPKey>					_pEncryptKey;
-	PoolThread*										_pThread;
+	PoolThreads::Queue								_sendingQueue;
 };
 
 
@@ -54,6 +54,8 @@ public:
 
 	void				acknowledgment(PacketReader& packet);
 	void				manage(Exception& ex, Invoker& invoker);
+	// time before the next repetition of messages (in ms), 0 if nothing to repeat
+	UInt32				timeout() const { return _trigger.timeout(); }
 
 	template <typename ...Args>
 	void fail(Args&&... args) {
@@ -77,6 +79,7 @@ public:
 	State				state(State value=GET,bool minimal=false);
 
 	bool				writeMedia(MediaType type,UInt32 time,PacketReader& packet);
+	bool				writeMedia(MediaType type,UInt32 time,const SharedBuffer& payload);
 	void				writeRaw(const UInt8* data,UInt32 size);
 	bool				writeMember(const Client& client);
 
@@ -84,11 +87,12 @@ private:
 	RTMFPWriter(RTMFPWriter& writer);
 	
 	UInt32					headerSize(UInt64 stage);
-	void					flush(BinaryWriter& writer,UInt64 stage,UInt8 flags,bool header,const UInt8* data,UInt16 size);
+	void					flush(BinaryWriter& writer,UInt64 stage,UInt8 flags,bool header,RTMFPMessage& message,UInt32 offset,UInt16 size);
 
 	void					raiseMessage();
 	RTMFPMessageBuffered&	createBufferedMessage();
 	AMFWriter&				write(AMF::ContentType type,UInt32 time=0,PacketReader* pPacket=NULL);
+	AMFWriter&				write(AMF::ContentType type,UInt32 time,const SharedBuffer& payload);
 
 	void					createReader(PacketReader& packet, std::shared_ptr<DataReader>& pReader) { pReader.reset(new AMFReader(packet)); }
 	void					createWriter(std::shared_ptr<DataWriter>& pWriter) { pWriter.reset(new AMFWriter(_band.poolBuffers()));pWriter->packet.next(6); }
@@ -26,19 +26,52 @@ This file is a part of Mona.
 
 namespace Mona {
 
+class RTMFProtocol;
+// Additional socket bound on the RTMFP port (SO_REUSEPORT), the system dispatches datagrams between the shards.
+// It spreads just the reception (and the sending) on several reactors, sessions stay handled by the server thread
+class RTMFPShard : public UDPSocket, virtual Object {
+public:
+	RTMFPShard(RTMFProtocol& protocol, UInt8 index);
+	~RTMFPShard() { close(); }
+
+	const UInt8	index;
+private:
+	void		onReception(PoolBuffer& pBuffer, const SocketAddress& address);
+	void		onError(const Exception& ex);
+
+	RTMFProtocol&	_protocol;
+};
+
 class RTMFProtocol : public UDProtocol, virtual Object  {
+	friend class RTMFPShard;
 public:
-	RTMFProtocol(const char* name, Invoker& invoker, Sessions& sessions) : UDProtocol(name, invoker, sessions) {}
-	~RTMFProtocol() { close(); }
+	RTMFProtocol(const char* name, Invoker& invoker, Sessions& sessions) : UDProtocol(name, invoker, sessions), _nextShard(0), _sentDatagrams(0), _sendCalls(0), _sendLatency(0) {}
+	~RTMFProtocol() { _shards.clear(); close(); }
 	
 	bool		load(Exception& ex, const RTMFPParams& params);
 
+	UInt8		shards() const { return _shards.size()+1; }
+	// socket of the shard, 0 is this protocol socket
+	UDPSocket&	socket(UInt8 shard) { return shard == 0 || shard>_shards.size() ? (UDPSocket&)*this : *_shards[shard - 1]; }
+	// shard to send the packets of a new session, given in turn
+	// sending statistics of all the shards cumulated since the start (updated on manage), sendLatency is the sum of the latencies in us
+	UInt64		sentDatagrams() const { return _sentDatagrams; }
+	UInt64		sendCalls() const { return _sendCalls; }
+	UInt64		sendLatency() const { return _sendLatency; }
+
+	UInt8		nextShard() { UInt8 shard(_nextShard); _nextShard = (_nextShard + 1) % shards(); return shard; }
+
 private:
-	void		manage() { if (_pHandshake) _pHandshake->manage(); }
+	void		manage();
 	
 	void		onPacket(PoolBuffer& pBuffer, const SocketAddress& address);
 
-	std::unique_ptr<RTMFPHandshake>	_pHandshake;
+	std::unique_ptr<RTMFPHandshake>				_pHandshake;
+	std::vector<std::unique_ptr<RTMFPShard>>	_shards;
+	UInt8										_nextShard;
+	UInt64										_sentDatagrams;
+	UInt64										_sendCalls;
+	UInt64										_sendLatency;
 };
 
 
@@ -30,7 +30,7 @@ namespace Mona {
 
 class RTMPSender : public TCPSender, virtual Object {
 public:
-	RTMPSender(const PoolBuffers& poolBuffers) : _writer(poolBuffers),sizePos(0),headerSize(0),TCPSender("RTMPSender") {}
+	RTMPSender(const PoolBuffers& poolBuffers) : _writer(poolBuffers),sizePos(0),headerSize(0),_sharedSize(0),TCPSender("RTMPSender") {}
 
 	UInt32				sizePos;
 	UInt8				headerSize;
@@ -42,10 +42,13 @@ public:
 	void				dump(RTMPChannel& channel,const SocketAddress& address) { pack(channel); Writer::DumpResponse(data(), size(), address); }
 
 	AMFWriter&			writer(RTMPChannel& channel) { pack(channel); return _writer; }
+	// payload of the current message, sent after what has been written without copy
+	void				share(const SharedBuffer& payload) { SocketSender::share(payload); _sharedSize += payload.size(); }
 private:
 	void				pack(RTMPChannel& channel);
 
 	AMFWriter			_writer;
+	UInt32				_sharedSize;
 };
 
 
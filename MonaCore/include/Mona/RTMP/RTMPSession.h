@@ -36,7 +36,7 @@ public:
 private:
 	bool			buildPacket(PoolBuffer& pBuffer,PacketReader& packet);
 	void			packetHandler(PacketReader& packet);
-	void			manage();
+	UInt32			manage();
 	void			flush() { Session::flush(); if (_pStream) _pStream->flush(); }
 
 	void			kill();
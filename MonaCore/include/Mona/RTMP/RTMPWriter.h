@@ -41,6 +41,9 @@ public:
 
 	void			flush(bool full=false);
 
+	UInt32			queueing() { return _client.queueing(); }
+	bool			congested() { return _client.congested(); }
+
 	void			writeAck(UInt32 count) {write(AMF::ACK).packet.write32(count);}
 	void			writeWinAckSize(UInt32 value) {write(AMF::WIN_ACKSIZE).packet.write32(value);}
 	void			writeProtocolSettings();
@@ -48,6 +51,8 @@ private:
 	RTMPWriter(const RTMPWriter& other) = delete; // require by gcc 4.8 to build _writers of RTMPSession
 
 	AMFWriter&		write(AMF::ContentType type,UInt32 time=0,PacketReader* pData=NULL);
+	AMFWriter&		write(AMF::ContentType type,UInt32 time,const SharedBuffer& payload);
+	AMFWriter&		writeHeader(AMF::ContentType type,UInt32 time,UInt32 bodySize);
 
 	RTMPChannel						_channel;
 	std::shared_ptr<RTMPSender>&	_pSender;
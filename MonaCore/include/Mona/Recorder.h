@@ -0,0 +1,96 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/FileWriter.h"
+#include "Mona/Writer.h"
+#include "Mona/String.h"
+
+namespace Mona {
+
+/// Records a publication in FLV files: tags are serialized in a large buffer handed to the FileWriter thread
+/// when it is full or every second, so the publication never waits the disk.
+/// If the FileWriter queue is full the buffer is dropped and the video restarts on the next key frame
+class Recorder : virtual Object {
+public:
+	Recorder(FileWriter& fileWriter, const PoolBuffers& poolBuffers);
+	virtual ~Recorder() { stop(); }
+
+	/// Record in path.flv (path without extension), or at its end if append (times continue after its last tag).
+	/// With a rotation, files are named path-YYYYMMDD-HHMMSS.flv and append is ignored
+	bool				start(Exception& ex, const std::string& path, bool append = false);
+	void				stop();
+	bool				recording() const { return _pFile ? true : false; }
+
+	// current file
+	const std::string&	file() const { return _pFile ? _pFile->path : String::Empty; }
+	// buffers dropped because the FileWriter queue was full
+	UInt32				dropped() const { return _dropped; }
+
+	/// bytes written in memory before to be handed to the FileWriter
+	void				setBufferSize(UInt32 size) { _bufferSize = size; }
+	/// A new file starts on the key frame following fileSize bytes or fileDuration ms (0 to disable)
+	void				setRotation(UInt32 fileSize, UInt32 fileDuration) { _fileSize = fileSize; _fileDuration = fileDuration; }
+
+	void				writeAudio(UInt32 time, const UInt8* data, UInt32 size);
+	void				writeVideo(UInt32 time, const UInt8* data, UInt32 size);
+	/// AMF0 value of a "onMetaData" script tag, written at the beginning of every file
+	void				writeMetaData(const UInt8* data, UInt32 size);
+
+private:
+	bool				open(Exception& ex, bool append);
+	void				begin(UInt32 time);
+	bool				mustRotate(UInt32 time) const;
+	bool				rotate();
+	UInt8*				reserve(UInt32 size);
+	void				write(UInt8 type, UInt32 time, const UInt8* data, UInt32 size);
+	void				flush();
+
+	FileWriter&							_fileWriter;
+	const PoolBuffers&					_poolBuffers;
+	std::shared_ptr<FileWriter::File>	_pFile;
+	std::string							_path;
+	std::string							_name; // name of the last rotated file
+	UInt8								_sameName; // files rotated in the same second
+	PoolBuffer							_pBuffer;
+	Time								_flushed;
+
+	UInt32								_bufferSize;
+	UInt32								_fileSize;
+	UInt32								_fileDuration;
+
+	Buffer								_audioCodec;
+	Buffer								_videoCodec;
+	Buffer								_metaData;
+
+	bool								_header; // FLV header to write at the beginning of the file
+	bool								_begun; // first tag of the file written
+	UInt32								_startTime; // publication time of the first tag of the file
+	UInt32								_lastTime;
+	UInt32								_offset; // file time of the first tag (after the last tag on append)
+	UInt32								_written; // bytes of the file
+	bool								_hasVideo;
+	bool								_waitKeyFrame;
+	UInt32								_dropped;
+};
+
+
+} // namespace Mona
@@ -62,6 +62,8 @@ public:
 
 	bool start(Exception& ex) { return _manager.start(ex); }
 	void stop();
+	// to call before start
+	void setAffinity(const std::vector<UInt16>& processors) { _manager.setAffinity(processors); }
 
 private:
 	void releaseRelay(Relay& relay) const;
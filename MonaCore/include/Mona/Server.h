@@ -39,7 +39,7 @@ private:
 class Server : protected Handler,private Startable {
 	friend class ServerManager;
 public:
-	Server(UInt32 socketBufferSize=0,UInt16 threads=0);
+	Server(UInt32 socketBufferSize=0,UInt16 threads=0,UInt16 reactors=1);
 	virtual ~Server();
 
 	bool	start() { return start(params); }
@@ -47,6 +47,9 @@ public:
 	void	stop() { Startable::stop(); }
 	bool	running() { return Startable::running(); }
 
+	// protocols loaded, to use just from the server thread
+	const Protocols&	protocols() const { return _protocols; }
+
 protected:
 	virtual void		manage();
 
@@ -61,6 +64,12 @@ private:
 	std::unique_ptr<Sessions>	_pSessions;	
 	ServerManager				_manager;
 	UInt32						_countClients;
+
+	// rates of PoolObjects
+	Time						_poolObjectsTime;
+	UInt64						_allocations;
+	UInt64						_recyclings;
+	UInt64						_deferrals; // of the server queue
 };
 
 
@@ -21,17 +21,24 @@ This file is a part of Mona.
 
 #include "Mona/Mona.h"
 #include "Mona/Startable.h"
+#include <vector>
 
 namespace Mona {
 
 struct ProtocolParams {
-	ProtocolParams(UInt16 port) : host("0.0.0.0"),port(port) {}
+	ProtocolParams(UInt16 port) : host("0.0.0.0"),port(port),backlog(64),sendHighWatermark(4194304),sendLowWatermark(1048576) {}
 	UInt16		port;
 	std::string host;
+	UInt32		backlog; // accept queue size (TCP protocols)
+	UInt32		sendHighWatermark; // queued bytes by connection from which media writers are congested (TCP protocols, 0 to disable)
+	UInt32		sendLowWatermark; // queued bytes by connection to which the congestion ends (TCP protocols)
 };
 
 struct HTTPParams : ProtocolParams {
-	HTTPParams() : ProtocolParams(80) {}
+	HTTPParams() : ProtocolParams(80),cacheSize(67108864),cacheFileSize(1048576) {}
+
+	UInt32				cacheSize; // memory of the static file cache
+	UInt32				cacheFileSize; // size limit of a file to cache (0 to disable the cache)
 };
 
 struct RTMPParams : ProtocolParams {
@@ -40,17 +47,40 @@ struct RTMPParams : ProtocolParams {
 
 
 struct RTMFPParams : ProtocolParams {
-	RTMFPParams() : ProtocolParams(1935),keepAlivePeer(10),keepAliveServer(15) {}
+	RTMFPParams() : ProtocolParams(1935),keepAlivePeer(10),keepAliveServer(15),shards(1) {}
 
 	UInt16				keepAlivePeer;
 	UInt16				keepAliveServer;
+	UInt8				shards; // 255 at most, limited on loading
 };
 
 
 
 struct ServerParams {
-	ServerParams() : threadPriority(Startable::PRIORITY_HIGH) {}
+	ServerParams() : threadPriority(Startable::PRIORITY_HIGH),buffersTrimDelay(120),buffersTrimMaximum(0),dnsTTL(60),dnsNegativeTTL(10),gopCacheSize(0),gopCacheDuration(10000),timeShiftWindow(0),timeShiftSize(268435456),recordBufferSize(1048576),recordQueueing(67108864),recordSync(1),recordFileSize(0),recordFileDuration(0) {}
 	Startable::Priority			threadPriority;
+	UInt32						buffersTrimDelay; // sec after which idle buffers not used meanwhile are freed (0 to never free)
+	UInt32						buffersTrimMaximum; // idle buffers kept by size class (0 for no limit)
+	UInt32						dnsTTL; // sec of cache of resolved host names
+	UInt32						dnsNegativeTTL; // sec of cache of host names unresolved
+	std::string					dnsHosts; // hosts file answered before the system resolver
+	UInt32						gopCacheSize; // bytes of the last GOP kept by publication for the new listeners (0 to disable)
+	UInt32						gopCacheDuration; // ms limit of the GOP cached
+	UInt32						timeShiftWindow; // minutes kept by publication to start a subscription in the past (0 to disable)
+	UInt32						timeShiftSize; // bytes limit of the time-shift buffer of one publication
+	std::string					timeShiftPath; // directory of the time-shift files (empty to keep the buffers in memory)
+	std::string					recordPath; // directory of the recordings (empty to disable the recording)
+	UInt32						recordBufferSize; // bytes of recording buffered before to be written
+	UInt32						recordQueueing; // bytes of recordings waiting the disk beyond which buffers are dropped (0 for no limit)
+	UInt8						recordSync; // fsync policy of the recordings, see FileWriter::Sync
+	UInt32						recordFileSize; // bytes from which a recording continues in a new file (0 to disable)
+	UInt32						recordFileDuration; // sec from which a recording continues in a new file (0 to disable)
+	std::string					vodPath; // directory of the FLV files played when their name is not published (empty to disable)
+	// processors on which threads run (empty for any), reactors and workers are bound each one to one processor in turn
+	std::vector<UInt16>			serverAffinity;
+	std::vector<UInt16>			reactorsAffinity;
+	std::vector<UInt16>			workersAffinity;
+	std::vector<UInt16>			backgroundAffinity; // manager, DNS resolver, database and recording threads
 	RTMFPParams					RTMFP;
 	RTMPParams					RTMP;
 	HTTPParams					HTTP;
@@ -55,9 +55,9 @@ public:
 	template<typename DecodingType>
 	void decode(const std::shared_ptr<DecodingType>& pDecoding) {
 		shareThis(pDecoding->_expirableSession);
+		pDecoding->_pThis = pDecoding;
 		Exception ex;
-		_pDecodingThread = invoker.poolThreads.enqueue<DecodingType>(ex, pDecoding, _pDecodingThread);
-		if (ex)
+		if (!invoker.poolThreads.enqueue<DecodingType>(ex, pDecoding, &_decodingQueue))
 			ERROR("Impossible to decode packet of protocol ", protocolName(), " on session ", name(), ", ", ex.error());
 	}
 
@@ -70,7 +70,14 @@ public:
 	virtual void		receive(PacketReader& packet) { receiveWithoutFlush(packet); flush(); }
 	virtual void		receive(PacketReader& packet, const SocketAddress& address);
 
-	virtual void		manage() {}
+	enum {
+		MANAGE_TIMEOUT = 2000 // default interval of management (in ms)
+	};
+
+	// Called on its management deadline (if managed by Sessions), returns the time before the next one (in ms), 0 to stop it
+	virtual UInt32		manage() { return MANAGE_TIMEOUT; }
+	// Brings forward the next management, if it's expected after timeout ms
+	void				manageIn(UInt32 timeout);
 	virtual void		kill();
 	virtual void		flush() { peer.writer().flush(); }
 
@@ -83,13 +90,15 @@ protected:
 
 private:
 	const std::string&  protocolName();
+	UInt32				onManage();
 
-	PoolThread*					_pDecodingThread;
+	PoolThreads::Queue			_decodingQueue;
 	mutable std::string			_name;
 	UInt32						_id;
 	Sessions*					_pSessions; // !NULL if managed by Sessions!
 	UInt8						_sessionsOptions;
 	Protocol&					_protocol;
+	Timer::OnTimer				_onManage;
 };
 
 
@@ -25,11 +25,13 @@ This file is a part of Mona.
 #include "Mona/SocketAddress.h"
 #include "Mona/Logs.h"
 #include <cstddef>
+#include <vector>
 
 namespace Mona {
 
 class Session;
 class Sessions {
+	friend class Session;
 public:
 	enum {
 		BYID = 0,
@@ -49,6 +51,7 @@ public:
 	Iterator begin() const { return _sessions.begin(); }
 	Iterator end() const { return _sessions.end(); }
 
+	// deletes the sessions died, every session is managed on its own deadline (see Session::manage)
 	void	 manage();
 
 	template<typename SessionType=Session>
@@ -88,6 +91,7 @@ public:
 		if (options&BYADDRESS)
 			_sessionsByAddress[pSession->peer.address] = pSession;
 		pSession->_sessionsOptions = options;
+		pSession->invoker.timer.set(pSession->_onManage, SessionType::MANAGE_TIMEOUT);
 		DEBUG("Session ", _nextId, " created");
 		do {
 			++_nextId;
@@ -103,6 +107,7 @@ private:
 	std::map<UInt32,Session*>						_sessions;
 	std::map<const UInt8*,Session*,CompareEntity>	_sessionsByPeerId;
 	std::map<SocketAddress,Session*>				_sessionsByAddress;
+	std::vector<UInt32>								_killeds;
 };
 
 
@@ -23,6 +23,7 @@ This file is a part of Mona.
 #include "Mona/Protocol.h"
 #include "Mona/TCPServer.h"
 #include "Mona/Logs.h"
+#include "Mona/Time.h"
 
 namespace Mona {
 
@@ -31,15 +32,30 @@ class TCProtocol :public Protocol, protected TCPServer , virtual Object {
 public:
 	bool load(Exception& ex, const ProtocolParams& params);
 
+	UInt32	sendHighWatermark() const { return _sendHighWatermark; }
+	UInt32	sendLowWatermark() const { return _sendLowWatermark; }
+
+	// Cumulated since the start, see TCPServer
+	UInt64	accepted() const { return TCPServer::accepted(); }
+	UInt64	dropped() const { return TCPServer::dropped(); }
+
 protected:
-	TCProtocol(const char* name, Invoker& invoker, Sessions& sessions) : TCPServer(invoker.sockets), Protocol(name, invoker, sessions) {}
+	TCProtocol(const char* name, Invoker& invoker, Sessions& sessions) : TCPServer(invoker.sockets), Protocol(name, invoker, sessions), _backlog(0), _sendHighWatermark(0), _sendLowWatermark(0), _accepted(0), _dropped(0) {}
 
 private:
 
 	void	onError(const Exception& ex) { WARN("Protocol ", name, ", ", ex.error()); }
 	void	onConnection(Exception& ex, const SocketAddress& address, SocketFile& file);
+	void	manage();
 
 	virtual void onClient(Exception& ex,const SocketAddress& address,SocketFile& file) = 0;
+
+	UInt32	_backlog;
+	UInt32	_sendHighWatermark;
+	UInt32	_sendLowWatermark;
+	Time	_statsTime;
+	UInt64	_accepted; // at the previous manage
+	UInt64	_dropped; // at the previous manage
 };
 
 inline void	TCProtocol::onConnection(Exception& ex,const SocketAddress& address,SocketFile& file) {
@@ -52,7 +68,25 @@ inline bool TCProtocol::load(Exception& ex, const ProtocolParams& params) {
 	SocketAddress address;
 	if (!address.setWithDNS(ex, params.host, params.port))
 		return false;
-	return start(ex, address);
+	_backlog = params.backlog;
+	_sendHighWatermark = params.sendHighWatermark;
+	_sendLowWatermark = params.sendLowWatermark;
+	_statsTime.update();
+	return start(ex, address, params.backlog);
+}
+
+inline void TCProtocol::manage() {
+	UInt64 accepted(this->accepted()), dropped(this->dropped());
+	accepted -= _accepted;
+	_accepted += accepted;
+	dropped -= _dropped;
+	_dropped += dropped;
+	Int64 elapsed(_statsTime.elapsed());
+	_statsTime.update();
+	if (dropped)
+		WARN("Protocol ", name, ", ", dropped, " connections dropped on a full accept queue, increase ", name, ".backlog (", _backlog, ")");
+	if (accepted)
+		DEBUG("Protocol ", name, ", ", accepted, " connections accepted (", elapsed>0 ? (accepted*1000/elapsed) : accepted, "/s)");
 }
 
 
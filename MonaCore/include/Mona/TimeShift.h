@@ -0,0 +1,80 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/Writer.h"
+#include "Mona/MappedFile.h"
+#include <deque>
+
+namespace Mona {
+
+/// Time-shift buffer of a publication: audio and video frames of the last minutes indexed by time and key frame,
+/// kept in memory or in a ring file mapped in memory
+class TimeShift : virtual Object {
+public:
+	TimeShift(const PoolBuffers& poolBuffers);
+	virtual ~TimeShift() { close(); }
+
+	/// window in ms and size in bytes, frames are kept in memory if path is empty, otherwise in a file of size bytes (removed on close)
+	bool				open(Exception& ex, UInt32 window, UInt32 size, const std::string& path = "");
+	void				close();
+	bool				opened() const { return _window>0; }
+
+	void				add(Writer::MediaType type, UInt32 time, const SharedBuffer& payload);
+
+	/// Sequence of the last key frame at or before time (the first key frame kept if time is older), false if no key frame is kept
+	bool				seek(UInt32 time, UInt64& sequence) const;
+	/// Read the frame of sequence, sequence moves to the next key frame if its frame has been removed, false if there is no more frame
+	bool				read(UInt64& sequence, Writer::MediaType& type, UInt32& time, SharedBuffer& payload) const;
+
+	// sequence of the next frame to add
+	UInt64				end() const { return _first + _frames.size(); }
+	UInt32				duration() const { return (_frames.empty() || _frames.front().time > _frames.back().time) ? 0 : (_frames.back().time - _frames.front().time); }
+	// bytes kept
+	UInt32				size() const { return _size; }
+
+private:
+	void				removeFront();
+
+	struct Frame {
+		Frame(Writer::MediaType type, UInt32 time, bool isKeyFrame, UInt32 offset, UInt32 size) : type(type), time(time), isKeyFrame(isKeyFrame), offset(offset), size(size) {}
+		Writer::MediaType	type;
+		UInt32				time;
+		bool				isKeyFrame;
+		UInt32				offset; // position in the file
+		UInt32				size;
+		SharedBuffer		payload; // without file
+		mutable std::weak_ptr<PoolBuffer>	pCopy; // with file, copy shared by the readers of this frame (the ring file is overwritten in place)
+	};
+
+	const PoolBuffers&	_poolBuffers;
+	UInt32				_window;
+	UInt32				_capacity;
+	UInt32				_size;
+	MappedFile			_file;
+	UInt32				_writing; // position of the next frame in the file
+	std::deque<Frame>	_frames;
+	std::deque<UInt64>	_keyFrames; // sequences of the key frames
+	UInt64				_first; // sequence of _frames.front()
+};
+
+
+} // namespace Mona
@@ -0,0 +1,72 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/VODFile.h"
+#include "Mona/Publication.h"
+#include "Mona/Timer.h"
+
+namespace Mona {
+
+/// Plays a FLV file to its listeners, each one from its own position and at the real-time pace.
+/// The file is mapped once in memory for all the listeners, and frames are pushed on the timer of the server thread
+class VOD : virtual Object {
+public:
+	VOD(const std::string& name, const Timer& timer, const PoolBuffers& poolBuffers);
+	virtual ~VOD();
+
+	bool				open(Exception& ex, const std::string& path) { return _file.open(ex, path); }
+	const VODFile&		file() const { return _file; }
+	/// Never published, it holds the listeners
+	const Publication&	publication() const { return _publication; }
+
+	/// start>=0 is the time where the listener starts in the file (on the key frame at or before), otherwise it starts at the beginning
+	Listener*			addListener(Exception& ex, Peer& peer, Writer& writer, bool unbuffered, double start = -2000);
+	/// false if peer doesn't play this VOD
+	bool				removeListener(Peer& peer);
+	/// Restart on the key frame at or before time, false if peer doesn't play this VOD
+	bool				seek(Peer& peer, UInt32 time);
+
+	UInt32				count() const { return _players.size(); }
+
+private:
+	struct Player : virtual Object {
+		Player(VOD& vod, Client* pClient) : pListener(NULL), header(false), offset(0), time(0), onTimer([&vod, pClient](UInt32) { return vod.play(pClient); }) {}
+		Listener*			pListener;
+		bool				header; // metadata and codecs to send before the next frame
+		UInt32				offset; // next tag
+		UInt32				time; // file time on clock
+		Time				clock;
+		Timer::OnTimer		onTimer;
+	};
+
+	void				start(Player& player, UInt32 time);
+	/// Push the frames due, returns the ms to wait before the next one (0 if the listener is removed or at the end)
+	UInt32				play(Client* pClient);
+
+	Publication			_publication;
+	const Timer&		_timer;
+	VODFile				_file;
+	std::map<Client*, Player>	_players;
+};
+
+
+} // namespace Mona
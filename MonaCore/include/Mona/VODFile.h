@@ -0,0 +1,79 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#pragma once
+
+#include "Mona/Mona.h"
+#include "Mona/MappedFile.h"
+#include "Mona/SharedBuffer.h"
+#include <vector>
+
+namespace Mona {
+
+/// FLV file mapped in memory in read-only, with the index of its key frames to seek in it.
+/// The index is cached on disk in path.index, and built again if the file has changed
+class VODFile : virtual Object {
+public:
+	VODFile();
+
+	bool				open(Exception& ex, const std::string& path);
+	void				close();
+	bool				opened() const { return _pFile->opened(); }
+	const std::string&	path() const { return _pFile->path(); }
+
+	// time of the last tag
+	UInt32				duration() const { return _duration; }
+	UInt32				keyFrames() const { return _keyFrames.size(); }
+
+	/// Offset of the last key frame at or before time (the first tag if there is no key frame before), keyTime gets its time
+	UInt32				seek(UInt32 time, UInt32& keyTime) const;
+	/// Read the tag at offset and moves offset to the next tag, false at the end of the file (or on a truncated tag)
+	bool				read(UInt32& offset, UInt8& type, UInt32& time, const UInt8*& data, UInt32& size) const;
+
+	/// Tags to send before to play from any offset (size=0 if missing)
+	const UInt8*		metaData(UInt32& size) const { return tag(_metaData, size); }
+	const UInt8*		audioCodec(UInt32& size) const { return tag(_audioCodec, size); }
+	const UInt8*		videoCodec(UInt32& size) const { return tag(_videoCodec, size); }
+
+	/// Part of the mapped file (data returned by the methods above) shared without copy, the mapping lives as long as a slice refers to it
+	SharedBuffer		slice(const UInt8* data, UInt32 size) const { return SharedBuffer(_pFile, data, size); }
+
+private:
+	bool				loadIndex(const std::string& path, UInt32 size, Int64 lastModified);
+	void				buildIndex();
+	void				saveIndex(const std::string& path, UInt32 size, Int64 lastModified) const;
+	const UInt8*		tag(UInt32 offset, UInt32& size) const;
+
+	struct KeyFrame {
+		KeyFrame(UInt32 time, UInt32 offset) : time(time), offset(offset) {}
+		UInt32	time;
+		UInt32	offset;
+	};
+
+	std::shared_ptr<MappedFile>	_pFile; // replaced on close, the slices keep the previous mapping
+	UInt32					_first; // offset of the first tag
+	UInt32					_duration;
+	UInt32					_metaData; // offsets of the first tags of metadata and codecs (0 if missing)
+	UInt32					_audioCodec;
+	UInt32					_videoCodec;
+	std::vector<KeyFrame>	_keyFrames; // video key frames, or one audio frame by second without video
+};
+
+
+} // namespace Mona
@@ -38,7 +38,7 @@ public:
 	bool			buildPacket(PoolBuffer& pBuffer,PacketReader& packet);
 	void			packetHandler(PacketReader& packet);
 	void			flush() { if (_pPublication) _pPublication->flush(); Session::flush(); }
-	void			manage();
+	UInt32			manage();
 
 	/// \brief Read message and call method if needed
 	/// \param packet Content message to read
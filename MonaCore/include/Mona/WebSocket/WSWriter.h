@@ -39,6 +39,9 @@ public:
 	State			state(State value=GET,bool minimal=false);
 	void			flush(bool full=false);
 
+	UInt32			queueing() { return _client.queueing(); }
+	bool			congested() { return _client.congested(); }
+
 	DataWriter&		writeInvocation(const std::string& name);
 	DataWriter&		writeMessage();
 	DataWriter&		writeResponse(UInt8 type);
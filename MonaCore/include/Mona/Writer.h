@@ -23,6 +23,7 @@ This file is a part of Mona.
 #include "Mona/DataReader.h"
 #include "Mona/QualityOfService.h"
 #include "Mona/PacketReader.h"
+#include "Mona/SharedBuffer.h"
 #include <set>
 
 namespace Mona {
@@ -35,6 +36,7 @@ public:
 };
 
 class Client;
+class MediaCache;
 class Writer : virtual NullableObject {
 public:
 	enum MediaType {
@@ -81,6 +83,10 @@ public:
 		and always publication name in packet.
 		Finally, every media data are passed (AUDIO, VIDEO and DATA), if the methods returns false, the cycle restart since the beginning */
 	virtual bool			writeMedia(MediaType type,UInt32 time,PacketReader& packet);
+	// payload shared between several writers, the writer keeps a reference rather than a copy when it can
+	virtual bool			writeMedia(MediaType type,UInt32 time,const SharedBuffer& payload);
+	// same payload written to all the listeners of a publication, cache keeps the frame already serialized by a previous writer
+	virtual bool			writeMedia(MediaType type,UInt32 time,const SharedBuffer& payload,MediaCache& cache) { return writeMedia(type,time,payload); }
 	virtual bool			writeMember(const Client& client);
 
     virtual DataWriter&		writeInvocation(const std::string& name){return DataWriter::Null;}
@@ -90,6 +96,10 @@ public:
 
 	virtual void			flush(bool full=false){}
 
+	// bytes waiting to be sent by the transport, congested() is true while they exceed its high watermark (see Socket::setWatermarks)
+	virtual UInt32			queueing() { return 0; }
+	virtual bool			congested() { return false; }
+
 	virtual void			createReader(PacketReader& packet,std::shared_ptr<DataReader>& pReader) {}
 	virtual void			createWriter(std::shared_ptr<DataWriter>& pWriter) {}
 	virtual bool			hasToConvert(DataReader& reader) {return false;}
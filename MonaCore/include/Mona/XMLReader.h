@@ -20,6 +20,7 @@
 #include "Mona/Mona.h"
 #include "Mona/DataReader.h"
 #include "Mona/Date.h"
+#include <deque>
 
 
 namespace Mona {
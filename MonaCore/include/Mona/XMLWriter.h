@@ -19,6 +19,7 @@
 
 #include "Mona/Mona.h"
 #include "Mona/DataWriter.h"
+#include <deque>
 
 namespace Mona {
 
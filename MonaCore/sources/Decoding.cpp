@@ -25,14 +25,44 @@ using namespace std;
 
 namespace Mona {
 
+static void Receive(Expirable<Session>& expirableSession, const SocketAddress& address, const UInt8* data, UInt32 size) {
+	Expirable<Session>::Lock lock;
+	Session* pSession = expirableSession.safeThis(lock);
+	if (!pSession)
+		return;
+	PacketReader packet(data, size);
+	if (address.host().isWildcard())
+		pSession->receive(packet);
+	else
+		pSession->receive(packet, address);
+}
+
+// Copy of a packet when a decoding gives several packets, to let the decoding buffer go on
+class DecodedPacket : public Task, virtual Object {
+public:
+	DecodedPacket(Invoker& invoker, Expirable<Session>& expirableSession, const SocketAddress& address, const UInt8* data, UInt32 size) : Task(invoker), _pBuffer(invoker.poolBuffers, size) {
+		memcpy(_pBuffer->data(), data, size);
+		expirableSession.shareThis(_expirableSession);
+		_address.set(address);
+	}
+
+private:
+	void handle(Exception& ex) { Receive(_expirableSession, _address, _pBuffer->data(), _pBuffer->size()); }
+
+	PoolBuffer				_pBuffer;
+	Expirable<Session>		_expirableSession;
+	SocketAddress			_address;
+};
+
+
 Decoding::Decoding(const char* name,Invoker& invoker,const UInt8* data,UInt32 size) :
-	_size(size),WorkThread(name),Task(invoker), _pBuffer(invoker.poolBuffers,size) {
+	_size(size),WorkThread(name),Task(invoker),_invoker(invoker), _pBuffer(invoker.poolBuffers,size) {
 	memcpy(_pBuffer->data(), data,size);
 	_current = _pBuffer->data();
 }
 
 Decoding::Decoding(const char* name,Invoker& invoker,PoolBuffer& pBuffer) :
-	_pBuffer(invoker.poolBuffers),WorkThread(name),Task(invoker),_size(pBuffer->size()),_current(pBuffer->data()) {
+	_pBuffer(invoker.poolBuffers),WorkThread(name),Task(invoker),_invoker(invoker),_size(pBuffer->size()),_current(pBuffer->data()) {
 	_pBuffer.swap(pBuffer);
 }
 
@@ -57,26 +87,31 @@ bool Decoding::run(Exception& exc) {
 		}
 		if (ex)
 			WARN(name,", ",ex.error())
-		waitHandle();
-
-		_current += _size;
 		size -= _size;
+		if (size == 0) {
+			// last packet, handled directly from the decoding buffer
+			shared_ptr<Decoding> pThis(_pThis.lock());
+			if (pThis)
+				post(shared_ptr<Task>(pThis, static_cast<Task*>(this))); // Task is a private base
+			else
+				waitHandle();
+			break;
+		}
+		post(make_shared<DecodedPacket>(_invoker, _expirableSession, _address, _current, _size));
+		_current += _size;
 		_size = size;
 	}
 	return true;
 }
 
-void Decoding::handle(Exception& ex) {
-	unique_lock<mutex> lock;
-	Session* pSession = _expirableSession.safeThis(lock);
-	if (!pSession)
-		return;
-	PacketReader packet(_current, _size);
-	if (_address.host().isWildcard())
-		pSession->receive(packet);
-	else
-		pSession->receive(packet, _address);
+void Decoding::post(const shared_ptr<Task>& pTask) {
+	// never blocks, on a full queue the packet is deferred and counted (ex is set just if the invoker is stopped)
+	Exception ex;
+	_invoker.postHandle(ex, pTask, true);
 }
 
+void Decoding::handle(Exception& ex) {
+	Receive(_expirableSession, _address, _current, _size);
+}
 
 } // namespace Mona
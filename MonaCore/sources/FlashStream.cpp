@@ -143,7 +143,7 @@ void FlashStream::messageHandler(Exception& ex,const string& name,AMFReader& mes
 		if (query != string::npos)
 			publication = publication.substr(0, query); // TODO use query in Util::UnpackQuery for publication options?
 		if(message.available())
-			message.readString(type); // TODO recording publication feature!
+			message.readString(type); // "live", "record" or "append"
 
 		Exception ex;
 		_pPublication = invoker.publish(ex, peer,publication);
@@ -153,7 +153,25 @@ void FlashStream::messageHandler(Exception& ex,const string& name,AMFReader& mes
 			if(_bufferTime>0)
 				_pPublication->setBufferTime(_bufferTime);
 			writer.writeAMFStatus("NetStream.Publish.Start",publication +" is now published");
+			if (type == "record" || type == "append") {
+				Exception exRecord;
+				if (invoker.record(exRecord, *_pPublication, type == "append"))
+					writer.writeAMFStatus("NetStream.Record.Start", publication + " is now recorded");
+				else {
+					WARN("Publication ", publication, " not recorded, ", exRecord.error());
+					writer.writeAMFStatus("NetStream.Record.Failed", exRecord.error());
+				}
+			}
 		}
+	} else if(_pListener && name=="seek") {
+		UInt32 time = (UInt32)message.readNumber();
+		string publication(_pListener->publication.name());
+		if (invoker.seek(peer, publication, time)) {
+			string description;
+			writer.writeAMFStatus("NetStream.Seek.Notify", String::Format(description, "Seeking ", time, "ms in ", publication));
+			writer.writeAMFStatus("NetStream.Play.Start", "Started playing " + publication);
+		} else
+			writer.writeAMFStatus("NetStream.Seek.Failed", publication + " is not a VOD");
 	} else if(_pListener && name=="receiveAudio") {
 		_pListener->receiveAudio = message.readBoolean();
 	} else if(_pListener && name=="receiveVideo") {
@@ -86,4 +86,22 @@ bool FlashWriter::writeMedia(MediaType type,UInt32 time,PacketReader& packet) {
 	return true;
 }
 
+bool FlashWriter::writeMedia(MediaType type,UInt32 time,const SharedBuffer& payload) {
+	switch(type) {
+		case AUDIO:
+			write(AMF::AUDIO,time,payload);
+			return true;
+		case VIDEO:
+			write(AMF::VIDEO,time,payload);
+			return true;
+		default:
+			return Writer::writeMedia(type,time,payload);
+	}
+}
+
+AMFWriter& FlashWriter::write(AMF::ContentType type,UInt32 time,const SharedBuffer& payload) {
+	PacketReader packet(payload.data(),payload.size());
+	return write(type,time,&packet);
+}
+
 } // namespace Mona
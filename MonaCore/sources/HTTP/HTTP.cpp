@@ -240,6 +240,30 @@ UInt8 HTTP::ParseConnection(Exception& ex,const char* value) {
 }
 
 
+UInt8 HTTP::ParseAcceptEncoding(const char* value) {
+	vector<string> fields;
+	UInt8 type(ENCODING_IDENTITY);
+	for (string& field : String::Split(value, ",", fields, String::SPLIT_IGNORE_EMPTY | String::SPLIT_TRIM)) {
+		// gzip;q=0 refuses it
+		size_t parameters(field.find(';'));
+		if (parameters != string::npos) {
+			size_t quality(field.find("q=", parameters));
+			double value(1);
+			if (quality != string::npos && String::ToNumber<double>(field.substr(quality + 2), value) && value <= 0)
+				continue;
+			field.erase(field.find_last_not_of(" \t", parameters - 1) + 1);
+		}
+		if (String::ICompare(field, "gzip") == 0)
+			type |= ENCODING_GZIP;
+		else if (String::ICompare(field, "br") == 0)
+			type |= ENCODING_BROTLI;
+		else if (field == "*")
+			type |= ENCODING_GZIP | ENCODING_BROTLI;
+	}
+	return type;
+}
+
+
 HTTP::ContentType HTTP::ParseContentType(const char* value, string& subType) {
 	
 	// subtype
@@ -0,0 +1,265 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#include "Mona/HTTP/HTTPFileCache.h"
+#include "Mona/Util.h"
+#include "Mona/Date.h"
+#include "Mona/Logs.h"
+#include <fstream>
+#if _OS == _OS_LINUX
+#include <sys/inotify.h>
+#include <poll.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+
+namespace Mona {
+
+static bool ReadFile(const PoolBuffers& poolBuffers, const string& path, SharedBuffer& buffer) {
+	ifstream ifile(path, ios::in | ios::binary | ios::ate);
+	if (!ifile.good())
+		return false;
+	UInt32 size = (UInt32)ifile.tellg();
+	PoolBuffer pBuffer(poolBuffers, size);
+	ifile.seekg(0);
+	if (size && !ifile.read((char*)pBuffer->data(), size))
+		return false;
+	buffer = SharedBuffer(pBuffer);
+	return true;
+}
+
+
+HTTPFileCache::HTTPFileCache(const PoolBuffers& poolBuffers) : Startable("HTTPFileCache"), _poolBuffers(poolBuffers), _maxSize(0), _maxFileSize(0), _size(0), _inotify(-1), _invalidations(0) {
+}
+
+HTTPFileCache::~HTTPFileCache() {
+	stop();
+}
+
+bool HTTPFileCache::start(Exception& ex, UInt32 size, UInt32 fileSize) {
+	stop();
+	_maxSize = size;
+	_maxFileSize = fileSize < size ? fileSize : size;
+	if (!_maxFileSize)
+		return true; // disabled
+#if _OS == _OS_LINUX
+	_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (_inotify < 0) {
+		WARN("HTTP file cache without inotify, files are checked every second");
+		return true;
+	}
+	return Startable::start(ex, Startable::PRIORITY_LOWEST);
+#else
+	return true;
+#endif
+}
+
+void HTTPFileCache::stop() {
+	Startable::stop();
+	lock_guard<mutex> lock(_mutex);
+#if _OS == _OS_LINUX
+	if (_inotify >= 0)
+		::close(_inotify);
+#endif
+	_inotify = -1;
+	_watches.clear();
+	_directories.clear();
+	_files.clear();
+	_index.clear();
+	_size = 0;
+	_maxFileSize = 0;
+}
+
+UInt32 HTTPFileCache::count() {
+	lock_guard<mutex> lock(_mutex);
+	return _index.size();
+}
+
+UInt32 HTTPFileCache::size() {
+	lock_guard<mutex> lock(_mutex);
+	return _size;
+}
+
+shared_ptr<const HTTPFileCache::File> HTTPFileCache::find(const string& path) {
+	lock_guard<mutex> lock(_mutex);
+	auto found = _index.find(path);
+	if (found == _index.end())
+		return nullptr;
+	File& file(**found->second);
+	if (_inotify < 0 && file._checked.isElapsed(1000)) {
+		// no invalidation by notification, checks the modification date
+		Exception ex;
+		Time lastModified(0);
+		FileSystem::GetLastModified(ex, path, lastModified);
+		if (ex || lastModified != file.lastModified) {
+			remove(found->second);
+			return nullptr;
+		}
+		file._checked.update();
+	}
+	// most recently used
+	_files.splice(_files.begin(), _files, found->second);
+	return *found->second;
+}
+
+shared_ptr<const HTTPFileCache::File> HTTPFileCache::load(const FilePath& file) {
+	UInt32 invalidations;
+	{
+		lock_guard<mutex> lock(_mutex);
+		if (file.size() > _maxFileSize || file.isDirectory())
+			return nullptr;
+		// watch before reading, so a modification during the reading invalidates it
+		const string& path(file.fullPath());
+		if (!watch(path.substr(0, path.find_last_of("/\\") + 1)))
+			return nullptr;
+		invalidations = _invalidations;
+	}
+
+	shared_ptr<File> pFile(new File(file.fullPath(), file.lastModified()));
+	if (!ReadFile(_poolBuffers, pFile->path, pFile->content))
+		return nullptr;
+	bool variants(ReadFile(_poolBuffers, pFile->path + ".gz", pFile->gzip));
+	if (ReadFile(_poolBuffers, pFile->path + ".br", pFile->brotli))
+		variants = true;
+
+	pFile->type = HTTP::ExtensionToMIMEType(file.extension(), pFile->subType);
+
+	// strong ETag, FNV-1a hash of the content
+	UInt64 hash(14695981039346656037ULL);
+	for (UInt32 i = 0; i < pFile->content.size(); ++i)
+		hash = (hash ^ pFile->content.data()[i]) * 1099511628211ULL;
+	UInt8 bytes[8];
+	for (UInt8 i = 0; i < 8; ++i)
+		bytes[i] = UInt8(hash >> (56 - i * 8));
+	pFile->etag.assign("\"");
+	Util::FormatHex(bytes, sizeof(bytes), pFile->etag, Util::HEX_APPEND);
+	pFile->etag.append("\"");
+
+	string buffer;
+	String::Append(pFile->headers, "Last-Modified: ", Date(pFile->lastModified).toString(Date::HTTP_FORMAT, buffer), "\r\nETag: ", pFile->etag, "\r\nAccept-Ranges: bytes\r\n");
+	if (variants)
+		pFile->headers.append("Vary: Accept-Encoding\r\n");
+
+	pFile->size = pFile->content.size() + pFile->gzip.size() + pFile->brotli.size() + pFile->path.size() + pFile->headers.size();
+
+	lock_guard<mutex> lock(_mutex);
+	if (!_maxFileSize || pFile->size > _maxSize || invalidations != _invalidations)
+		return pFile; // not cachable, or possibly modified during the reading
+	auto found = _index.find(pFile->path);
+	if (found != _index.end())
+		remove(found->second);
+	_files.emplace_front(pFile);
+	_index[pFile->path] = _files.begin();
+	_size += pFile->size;
+	// least recently used out
+	while (_size > _maxSize)
+		remove(--_files.end());
+	return pFile;
+}
+
+void HTTPFileCache::remove(list<shared_ptr<File>>::iterator it) {
+	_size -= (*it)->size;
+	_index.erase((*it)->path);
+	_files.erase(it);
+}
+
+void HTTPFileCache::invalidate(const string& path) {
+	++_invalidations;
+	auto found = _index.find(path);
+	if (found != _index.end())
+		remove(found->second);
+	// precompressed variant
+	if (path.size() > 3 && (String::ICompare(path.c_str() + path.size() - 3, ".gz") == 0 || String::ICompare(path.c_str() + path.size() - 3, ".br") == 0)) {
+		found = _index.find(path.substr(0, path.size() - 3));
+		if (found != _index.end())
+			remove(found->second);
+	}
+}
+
+bool HTTPFileCache::watch(const string& directory) {
+#if _OS == _OS_LINUX
+	if (_inotify < 0 || _directories.count(directory))
+		return true;
+	int wd = inotify_add_watch(_inotify, directory.c_str(), IN_MODIFY | IN_ATTRIB | IN_CLOSE_WRITE | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_MOVE_SELF);
+	if (wd < 0) {
+		WARN("HTTP file cache, impossible to watch ", directory);
+		return false;
+	}
+	_watches[wd] = directory;
+	_directories[directory] = wd;
+#endif
+	return true;
+}
+
+void HTTPFileCache::run(Exception& ex) {
+#if _OS == _OS_LINUX
+	alignas(struct inotify_event) char buffer[4096];
+	while (running()) {
+		pollfd fd;
+		fd.fd = _inotify;
+		fd.events = POLLIN;
+		fd.revents = 0;
+		if (::poll(&fd, 1, 500) <= 0)
+			continue; // timeout to check stop
+		ssize_t size = ::read(_inotify, buffer, sizeof(buffer));
+		if (size <= 0)
+			continue;
+		lock_guard<mutex> lock(_mutex);
+		for (char* current = buffer; current < buffer + size; current += sizeof(struct inotify_event) + ((struct inotify_event*)current)->len) {
+			const struct inotify_event& event(*(struct inotify_event*)current);
+			if (event.mask & IN_Q_OVERFLOW) {
+				// events lost, everything can have changed
+				++_invalidations;
+				_files.clear();
+				_index.clear();
+				_size = 0;
+				continue;
+			}
+			auto found = _watches.find(event.wd);
+			if (found == _watches.end())
+				continue;
+			if (event.len) {
+				invalidate(found->second + event.name);
+				continue;
+			}
+			if (!(event.mask & (IN_DELETE_SELF | IN_MOVE_SELF | IN_IGNORED)))
+				continue;
+			// directory removed or moved, its files too
+			++_invalidations;
+			auto it = _files.begin();
+			while (it != _files.end()) {
+				if ((*it)->path.compare(0, found->second.size(), found->second) == 0)
+					remove(it++);
+				else
+					++it;
+			}
+			if (event.mask & IN_IGNORED) {
+				_directories.erase(found->second);
+				_watches.erase(found);
+			} else
+				inotify_rm_watch(_inotify, event.wd);
+		}
+	}
+#endif
+}
+
+
+} // namespace Mona
@@ -34,6 +34,7 @@ HTTPPacket::HTTPPacket(PoolBuffer& pBuffer) : filePos(string::npos), _pBuffer(pB
 	version(0),
 	connection(HTTP::CONNECTION_ABSENT),
 	ifModifiedSince(0),
+	acceptEncoding(HTTP::ENCODING_IDENTITY),
 	accessControlRequestMethod(0) {
 
 }
@@ -55,6 +56,14 @@ void HTTPPacket::parseHeader(Exception& ex,const char* key, const char* value) {
 		secWebsocketAccept.assign(value);
 	} else if (String::ICompare(key,"if-modified-since")==0) {
 		ifModifiedSince.update(ex,value,Date::HTTP_FORMAT);
+	} else if (String::ICompare(key,"range")==0) {
+		range.assign(value);
+	} else if (String::ICompare(key,"if-range")==0) {
+		ifRange.assign(value);
+	} else if (String::ICompare(key,"if-none-match")==0) {
+		ifNoneMatch.assign(value);
+	} else if (String::ICompare(key,"accept-encoding")==0) {
+		acceptEncoding = HTTP::ParseAcceptEncoding(value);
 	} else if (String::ICompare(key,"access-control-request-method")==0) {
 		vector<string> values;
 		for (string& value : String::Split(value, ",", values, String::SPLIT_IGNORE_EMPTY | String::SPLIT_TRIM))
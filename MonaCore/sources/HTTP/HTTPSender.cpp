@@ -33,7 +33,7 @@ namespace Mona {
 
 
 
-HTTPSender::HTTPSender(const SocketAddress& address,const shared_ptr<HTTPPacket>& pRequest) : _pRequest(pRequest),_address(address),_sizePos(0),TCPSender("TCPSender"),_sortOptions(0), _isApp(false) {
+HTTPSender::HTTPSender(const SocketAddress& address,const shared_ptr<HTTPPacket>& pRequest) : _pRequest(pRequest),_address(address),_sizePos(0),_fileLength(0),TCPSender("TCPSender"),_sortOptions(0), _isApp(false) {
 	
 }
 
@@ -60,7 +60,9 @@ bool HTTPSender::run(Exception& ex) {
 		return false;
 	}
 
-	if (!_pWriter) {
+	if (!_pWriter && _pCachedFile)
+		writeCachedFile(*_pCachedFile);
+	else if (!_pWriter) {
 
 		//// GET FILE
 		Date date;
@@ -100,31 +102,46 @@ bool HTTPSender::run(Exception& ex) {
 				} 
 				// File
 				else {
-					ifstream ifile(_file.fullPath(), ios::in | ios::binary | ios::ate);
-					if (!ifile.good()) {
-						exIgnore.set(Exception::NIL, "Impossible to open ", _file.path(), " file");
-						writeError(423,  exIgnore.error());
-					} else {
-						// determine the content-type
-						string subType;
-						HTTP::ContentType type = HTTP::ExtensionToMIMEType(_file.extension(), subType);	
-
-						DataWriter& response = write("200 OK", type,subType);
-						PacketWriter& packet = response.packet;
-						HTTP_BEGIN_HEADER(packet)
-							HTTP_ADD_HEADER(packet,"Last-Modified", date.toString(Date::HTTP_FORMAT, _buffer))
-						HTTP_END_HEADER(packet)
-
-						// TODO see if filter is correct
-						if (type == HTTP::CONTENT_TEXT && _pRequest->parameters.count())
+					// determine the content-type
+					string subType;
+					HTTP::ContentType type = HTTP::ExtensionToMIMEType(_file.extension(), subType);	
+
+					// TODO see if filter is correct
+					if (type == HTTP::CONTENT_TEXT && _pRequest->parameters.count()) {
+						ifstream ifile(_file.fullPath(), ios::in | ios::binary | ios::ate);
+						if (!ifile.good()) {
+							exIgnore.set(Exception::NIL, "Impossible to open ", _file.path(), " file");
+							writeError(423,  exIgnore.error());
+						} else {
+							DataWriter& response = write("200 OK", type,subType);
+							PacketWriter& packet = response.packet;
+							HTTP_BEGIN_HEADER(packet)
+								HTTP_ADD_HEADER(packet,"Last-Modified", date.toString(Date::HTTP_FORMAT, _buffer))
+							HTTP_END_HEADER(packet)
 							ReplaceTemplateTags(packet, ifile, _pRequest->parameters);
-						else {
-
-							// push the entire file content to memory
-							UInt32 size = (UInt32)ifile.tellg();
-							ifile.seekg(0);
-							char* current = (char*)packet.buffer(size); // reserve memory for file
-							ifile.read(current, size);
+						}
+					} else {
+						// a small file is cached, the others are sent from the disk after the header without loading them in memory
+						UInt64 size(_file.size()), offset(0), length(size);
+						Int8 range(0);
+						if (!_pRequest->range.empty() && matchIfRange(String::Empty, _file.lastModified()))
+							range = ParseRange(_pRequest->range, size, offset, length);
+						if (_pFileCache && (_pCachedFile = _pFileCache->load(_file)))
+							writeCachedFile(*_pCachedFile);
+						else if (range < 0)
+							writeRangeNotSatisfiable(size);
+						else if (!shareFile(exIgnore, _file.fullPath(), offset, _pRequest->command == HTTP::COMMAND_HEAD ? 0 : length)) {
+							writeError(423, String::Format(_buffer, "Impossible to open ", _file.path(), " file"));
+						} else {
+							_fileLength = length;
+							DataWriter& response = write(range ? "206 Partial Content" : "200 OK", type,subType);
+							PacketWriter& packet = response.packet;
+							HTTP_BEGIN_HEADER(packet)
+								HTTP_ADD_HEADER(packet,"Last-Modified", date.toString(Date::HTTP_FORMAT, _buffer))
+								HTTP_ADD_HEADER(packet,"Accept-Ranges", "bytes")
+								if (range)
+									HTTP_ADD_HEADER(packet,"Content-Range", String::Format(_buffer, "bytes ", offset, '-', offset + length - 1, '/', size))
+							HTTP_END_HEADER(packet)
 						}
 					}
 				}
@@ -151,7 +168,7 @@ bool HTTPSender::run(Exception& ex) {
 		}
 
 		// write content-length
-		String::Format(_buffer, end + 4 - content);
+		String::Format(_buffer, end + 4 - content + _fileLength);
 		memcpy((UInt8*)packet.data()+_sizePos,_buffer.c_str(),_buffer.size());
 
 		if (_pRequest->command == HTTP::COMMAND_HEAD)
@@ -247,6 +264,108 @@ BinaryWriter& HTTPSender::writeRaw(const PoolBuffers& poolBuffers) {
 	return _pWriter->packet;
 }
 
+void HTTPSender::writeCachedFile(const HTTPFileCache::File& file) {
+	// Not Modified, If-None-Match has priority on If-Modified-Since
+	if (_pRequest->ifNoneMatch.empty() ? (file.lastModified>0 && _pRequest->ifModifiedSince >= file.lastModified) : (_pRequest->ifNoneMatch == "*" || _pRequest->ifNoneMatch.find(file.etag) != string::npos)) {
+		DataWriter& response = write("304 Not Modified", HTTP::CONTENT_ABSENT);
+		BinaryWriter& writer = response.packet;
+		HTTP_BEGIN_HEADER(writer)
+			HTTP_ADD_HEADER(writer, "ETag", file.etag)
+		HTTP_END_HEADER(writer)
+		return;
+	}
+
+	const SharedBuffer* pContent(&file.content);
+	const char* encoding(NULL);
+	UInt64 offset(0), length(file.content.size());
+	Int8 range(0);
+	if (!_pRequest->range.empty() && matchIfRange(file.etag, file.lastModified))
+		range = ParseRange(_pRequest->range, length, offset, length);
+	if (range < 0) {
+		writeRangeNotSatisfiable(file.content.size());
+		return;
+	}
+	// precompressed variant, just for a whole content
+	if (!range) {
+		if ((_pRequest->acceptEncoding&HTTP::ENCODING_BROTLI) && file.brotli) {
+			pContent = &file.brotli;
+			encoding = "br";
+		} else if ((_pRequest->acceptEncoding&HTTP::ENCODING_GZIP) && file.gzip) {
+			pContent = &file.gzip;
+			encoding = "gzip";
+		}
+		length = pContent->size();
+	}
+
+	DataWriter& response = write(range ? "206 Partial Content" : "200 OK", file.type, file.subType);
+	PacketWriter& packet = response.packet;
+	HTTP_BEGIN_HEADER(packet)
+		packet.writeRaw(file.headers);
+		if (encoding)
+			HTTP_ADD_HEADER(packet, "Content-Encoding", encoding)
+		if (range)
+			HTTP_ADD_HEADER(packet, "Content-Range", String::Format(_buffer, "bytes ", offset, '-', offset + length - 1, '/', file.content.size()))
+	HTTP_END_HEADER(packet)
+
+	_fileLength = length;
+	if (_pRequest->command != HTTP::COMMAND_HEAD && length)
+		share(pContent->slice((UInt32)offset, (UInt32)length));
+}
+
+void HTTPSender::writeRangeNotSatisfiable(UInt64 size) {
+	DataWriter& response = write("416 Requested Range Not Satisfiable");
+	BinaryWriter& writer = response.packet;
+	HTTP_BEGIN_HEADER(writer)
+		HTTP_ADD_HEADER(writer, "Content-Range", String::Format(_buffer, "bytes */", size))
+	HTTP_END_HEADER(writer)
+}
+
+bool HTTPSender::matchIfRange(const string& etag, const Time& lastModified) {
+	if (_pRequest->ifRange.empty())
+		return true;
+	// an entity tag or a date, the range is valid just if the file has not been modified since
+	if (_pRequest->ifRange[0] == '"' || _pRequest->ifRange.compare(0, 2, "W/") == 0)
+		return !etag.empty() && _pRequest->ifRange == etag;
+	Exception ex;
+	Date date(0);
+	return date.update(ex, _pRequest->ifRange, Date::HTTP_FORMAT) && !ex && date >= lastModified;
+}
+
+Int8 HTTPSender::ParseRange(const string& value, UInt64 size, UInt64& offset, UInt64& length) {
+	// bytes=first-last, bytes=first- or bytes=-suffix
+	if (String::ICompare(value, "bytes=", 6) != 0 || value.find(',') != string::npos)
+		return 0; // unknown unit or several ranges, the whole content is sent
+	size_t separator(value.find('-', 6));
+	if (separator == string::npos)
+		return 0;
+	UInt64 first(0), last(0);
+	bool hasFirst(String::ToNumber<UInt64>(value.substr(6, separator - 6), first));
+	bool hasLast(String::ToNumber<UInt64>(value.substr(separator + 1), last));
+	if (!hasFirst) {
+		if (!hasLast || separator != 6)
+			return 0;
+		// suffix
+		if (last == 0 || size == 0)
+			return -1;
+		if (last > size)
+			last = size;
+		offset = size - last;
+		length = last;
+		return 1;
+	}
+	if (first >= size)
+		return -1;
+	if (!hasLast)
+		last = size - 1;
+	else if (last < first)
+		return 0;
+	else if (last >= size)
+		last = size - 1;
+	offset = first;
+	length = last - first + 1;
+	return 1;
+}
+
 void HTTPSender::ReplaceTemplateTags(PacketWriter& packet, ifstream& ifile, MapWriter<std::map<std::string,std::string>>& parameters) {
 
 	UInt32 pos = packet.size();
@@ -18,6 +18,7 @@ This file is a part of Mona.
 */
 
 #include "Mona/HTTP/HTTPSession.h"
+#include "Mona/HTTP/HTTProtocol.h"
 #include "Mona/HTTP/HTTP.h"
 #include "Mona/HTTPHeaderReader.h"
 #include "Mona/SOAPReader.h"
@@ -35,7 +36,9 @@ namespace Mona {
 
 
 HTTPSession::HTTPSession(const SocketAddress& peerAddress, SocketFile& file, Protocol& protocol, Invoker& invoker) : WSSession(peerAddress, file, protocol, invoker), _isWS(false), _writer(*this),_ppBuffer(new PoolBuffer(invoker.poolBuffers)), _pListener(NULL) {
-
+	HTTProtocol* pProtocol(dynamic_cast<HTTProtocol*>(&protocol));
+	if (pProtocol)
+		_pFileCache = pProtocol->pFileCache;
 }
 
 
@@ -164,9 +167,13 @@ void HTTPSession::packetHandler(PacketReader& reader) {
 				if (!methodCalled && !ex) {
 					parameters.reset();
 					if (peer.onRead(ex, filePath, parameters, pPacket->parameters) && !ex) {
+						// a cached file exists, without disk access (not for a template file which has to be filled with parameters)
+						shared_ptr<const HTTPFileCache::File> pCachedFile;
+						if (_pFileCache && !pPacket->parameters.count())
+							pCachedFile = _pFileCache->find(filePath.fullPath());
 						// If onRead has been authorised, and that the file is a multimedia file, and it doesn't exists (no VOD, filePath.lastModified()==0 means "doesn't exists")
 						// Subscribe for a live stream with the basename file as stream name
-						if (filePath.lastModified() == 0) {
+						if (!pCachedFile && filePath.lastModified() == 0) {
 							if (pPacket->contentType == HTTP::CONTENT_ABSENT)
 								pPacket->contentType = HTTP::ExtensionToMIMEType(filePath.extension(),pPacket->contentSubType);
 							if ((pPacket->contentType == HTTP::CONTENT_VIDEO || pPacket->contentType == HTTP::CONTENT_AUDIO) && filePath.lastModified() == 0)
@@ -184,7 +191,7 @@ void HTTPSession::packetHandler(PacketReader& reader) {
 							 if (invoker.buffer == "D")
 								 sortOptions |= HTTP::SORT_DESC;
 							 // HTTP get
-							_writer.writeFile(filePath, sortOptions, pPacket->filePos==string::npos);
+							_writer.writeFile(filePath, sortOptions, pPacket->filePos==string::npos, pPacket->parameters.count() ? nullptr : _pFileCache, pCachedFile);
 						}
 					}
 				}
@@ -226,14 +233,19 @@ void HTTPSession::packetHandler(PacketReader& reader) {
 	}
 }
 
-void HTTPSession::manage() {
-	if(_isWS) {
-		WSSession::manage();
-		return;
-	}
+UInt32 HTTPSession::manage() {
+	if(_isWS)
+		return WSSession::manage();
 	// timeout http session
-	if (peer.connected && _options.timeout > 0 && !_pListener && _writer.timeout.isElapsed(_options.timeout))
+	if (!peer.connected || !_options.timeout || _pListener)
+		return MANAGE_TIMEOUT;
+	Int64 elapsed(_writer.timeout.elapsed());
+	if (elapsed > _options.timeout) {
 		kill();
+		return 0;
+	}
+	// precisely on the timeout if it comes before the next default management
+	return _options.timeout - elapsed < UInt32(MANAGE_TIMEOUT) ? UInt32(_options.timeout - elapsed + 1) : UInt32(MANAGE_TIMEOUT);
 }
 
 void HTTPSession::processOptions(Exception& ex,const shared_ptr<HTTPPacket>& pPacket) {
@@ -25,7 +25,7 @@ using namespace std;
 
 namespace Mona {
 
-HTTPWriter::HTTPWriter(TCPClient& tcpClient) : _tcpClient(tcpClient),_pThread(NULL),contentType(HTTP::CONTENT_TEXT),contentSubType("html; charset=utf-8") {
+HTTPWriter::HTTPWriter(TCPClient& tcpClient) : _tcpClient(tcpClient),contentType(HTTP::CONTENT_TEXT),contentSubType("html; charset=utf-8") {
 	
 }
 
@@ -70,8 +70,7 @@ void HTTPWriter::flush(bool full) {
 
 	Exception ex;
 	for (shared_ptr<HTTPSender>& pSender : _senders) {
-		_pThread = _tcpClient.send<HTTPSender>(ex, pSender,_pThread);
-		if (ex)
+		if (!_tcpClient.send<HTTPSender>(ex, pSender, &_sendingQueue))
 			ERROR("HTTPSender flush, ", ex.error())
 	}
 	_senders.clear();
@@ -149,5 +148,37 @@ bool HTTPWriter::writeMedia(MediaType type,UInt32 time,PacketReader& packet) {
 	return true;
 }
 
+bool HTTPWriter::writeMedia(MediaType type,UInt32 time,const SharedBuffer& payload) {
+	// FLV tags can wrap the payload without copy, MPEGTS has to split it in TS packets
+	if (state()==CLOSED || (type!=AUDIO && type!=VIDEO) || !dynamic_cast<FLV*>(_pMedia.get()))
+		return Writer::writeMedia(type,time,payload);
+	HTTPSender& sender(createSender());
+	BinaryWriter& writer(sender.writeRaw(_tcpClient.manager().poolBuffers));
+	FLV::WriteTagHeader(writer,type,time,payload.size());
+	sender.share(payload);
+	FLV::WriteTagFooter(writer,payload.size());
+	return true;
+}
+
+bool HTTPWriter::writeMedia(MediaType type,UInt32 time,const SharedBuffer& payload,MediaCache& cache) {
+	// MPEGTS packets of a frame differ between listeners just by continuity counters and times,
+	// so the frame is splitted one time and the next listeners patch a copy of it
+	MPEGTS* pTS(dynamic_cast<MPEGTS*>(_pMedia.get()));
+	if (state()==CLOSED || (type!=AUDIO && type!=VIDEO) || !pTS)
+		return writeMedia(type,time,payload);
+	const PoolBuffers& poolBuffers(_tcpClient.manager().poolBuffers);
+	BinaryWriter& writer(createSender().writeRaw(poolBuffers));
+	UInt32 pos(writer.size());
+	SharedBuffer& frame(cache[MediaCache::FORMAT_MPEGTS]);
+	if (frame.empty()) {
+		pTS->write(writer,type,time,payload.data(),payload.size());
+		frame = SharedBuffer(poolBuffers,writer.data()+pos,writer.size()-pos);
+	} else {
+		writer.writeRaw(frame.data(),frame.size());
+		pTS->patch((UInt8*)writer.data()+pos,frame.size(),type,time);
+	}
+	return true;
+}
+
 
 } // namespace Mona
@@ -18,6 +18,7 @@ This file is a part of Mona.
 */
 
 #include "Mona/Invoker.h"
+#include "Mona/FileSystem.h"
 #include "Mona/Logs.h"
 
 using namespace std;
@@ -25,9 +26,22 @@ using namespace std;
 
 namespace Mona {
 
+// file of a publication in directory, with a name cleaned of the characters not allowed in a file name
+static string& MakePath(const string& directory, const string& name, string& path) {
+	FileSystem::MakeDirectory(path.assign(directory));
+	size_t size(path.size());
+	path.append(name);
+	for (size_t i = size; i < path.size(); ++i) {
+		if (!isalnum(path[i]) && path[i] != '.' && path[i] != '-')
+			path[i] = '_';
+	}
+	return path;
+}
 
-Invoker::Invoker(UInt32 socketBufferSize,UInt16 threads) : poolThreads(threads),relay(poolBuffers,poolThreads,socketBufferSize),sockets(*this,poolBuffers,poolThreads,socketBufferSize),publications(_publications),_nextId(0) {
+
+Invoker::Invoker(UInt32 socketBufferSize,UInt16 threads,UInt16 reactors) : TaskHandler(16384),poolThreads(threads),relay(poolBuffers,poolThreads,socketBufferSize),sockets(*this,poolBuffers,poolThreads,socketBufferSize,"SocketManager",reactors),resolver(*this),fileWriter(poolBuffers),publications(_publications),_nextId(0) {
 	DEBUG(poolThreads.threadsAvailable()," threads available in the server poolthreads");
+	DEBUG(sockets.reactors()," reactors to manage the server sockets");
 		
 }
 
@@ -76,15 +90,25 @@ FlashStream& Invoker::flashStream(UInt32 id,Peer& peer,shared_ptr<FlashStream>&
 }
 
 Publication* Invoker::publish(Exception& ex, Peer& peer,const string& name) {
-	auto it(_publications.emplace(piecewise_construct,forward_as_tuple(name),forward_as_tuple(name)).first);
+	auto it(_publications.emplace(piecewise_construct,forward_as_tuple(name),forward_as_tuple(name,poolBuffers)).first);
 	Publication* pPublication = &it->second;
 	
+	pPublication->setGOPCache(params.gopCacheSize, params.gopCacheDuration);
 	pPublication->start(ex, peer);
 	if (ex) {
 		if (!pPublication->publisher() && pPublication->listeners.count() == 0)
 			_publications.erase(it);
 		return NULL;
 	}
+	if (!params.timeShiftWindow)
+		return pPublication;
+	// time-shift buffer, in a file named as the publication if a directory is configured
+	string path;
+	if (!params.timeShiftPath.empty())
+		MakePath(params.timeShiftPath, name, path).append(".timeshift");
+	Exception exTimeShift;
+	if (!pPublication->setTimeShift(exTimeShift, params.timeShiftWindow * 60000, params.timeShiftSize, path))
+		WARN("Publication ", name, " without time-shift, ", exTimeShift.error());
 	return pPublication;
 }
 
@@ -101,9 +125,35 @@ void Invoker::unpublish(Peer& peer,const string& name) {
 }
 
 Listener* Invoker::subscribe(Exception& ex, Peer& peer,const string& name,Writer& writer,double start) {
-	auto it(_publications.emplace(piecewise_construct,forward_as_tuple(name),forward_as_tuple(name)).first);
+	auto itLive(_publications.find(name));
+	if (!params.vodPath.empty() && (itLive == _publications.end() || !itLive->second.publisher())) {
+		// not published, VOD if a file has this name
+		auto itVOD(_vods.find(name));
+		if (itVOD == _vods.end()) {
+			string path;
+			MakePath(params.vodPath, name, path);
+			if (path.size() < 4 || String::ICompare(path.c_str() + path.size() - 4, ".flv") != 0)
+				path.append(".flv");
+			if (FileSystem::Exists(path)) {
+				itVOD = _vods.emplace(piecewise_construct, forward_as_tuple(name), forward_as_tuple(name, timer, poolBuffers)).first;
+				if (!itVOD->second.open(ex, path)) {
+					_vods.erase(itVOD);
+					return NULL;
+				}
+			}
+		}
+		if (itVOD != _vods.end()) {
+			VOD& vod(itVOD->second);
+			Listener* pListener = vod.addListener(ex, peer, writer, start == -3000 ? true : false, start);
+			if (!vod.count())
+				_vods.erase(itVOD);
+			return pListener;
+		}
+	}
+
+	auto it(_publications.emplace(piecewise_construct,forward_as_tuple(name),forward_as_tuple(name,poolBuffers)).first);
 	Publication& publication(it->second);
-	Listener* pListener = publication.addListener(ex, peer,writer,start==-3000 ? true : false);
+	Listener* pListener = publication.addListener(ex, peer,writer,start==-3000 ? true : false,start);
 	if (ex) {
 		if(!publication.publisher() && publication.listeners.count()==0)
 			_publications.erase(it);
@@ -111,7 +161,32 @@ Listener* Invoker::subscribe(Exception& ex, Peer& peer,const string& name,Writer
 	return pListener;
 }
 
+Recorder* Invoker::record(Exception& ex, Publication& publication, bool append) {
+	if (params.recordPath.empty()) {
+		ex.set(Exception::PERMISSION, "Recording is disabled, no recordPath configured");
+		return NULL;
+	}
+	string path;
+	Recorder* pRecorder(publication.startRecording(ex, fileWriter, MakePath(params.recordPath, publication.name(), path), append));
+	if (!pRecorder)
+		return NULL;
+	pRecorder->setBufferSize(params.recordBufferSize);
+	pRecorder->setRotation(params.recordFileSize, params.recordFileDuration * 1000);
+	return pRecorder;
+}
+
+bool Invoker::seek(Peer& peer, const string& name, UInt32 time) {
+	auto it = _vods.find(name);
+	return it != _vods.end() && it->second.seek(peer, time);
+}
+
 void Invoker::unsubscribe(Peer& peer,const string& name) {
+	auto itVOD = _vods.find(name);
+	if (itVOD != _vods.end() && itVOD->second.removeListener(peer)) {
+		if (!itVOD->second.count())
+			_vods.erase(itVOD);
+		return;
+	}
 	auto it = _publications.find(name);
 	if(it == _publications.end()) {
 		DEBUG("The publication '",name,"' doesn't exists, unsubscribe useless");
@@ -27,7 +27,7 @@ using namespace std;
 
 namespace Mona {
 
-Listener::Listener(Publication& publication,Client& client,Writer& writer,bool unbuffered) : _droppedFrames(0),_unbuffered(unbuffered),
+Listener::Listener(Publication& publication,Client& client,Writer& writer,bool unbuffered) : _droppedFrames(0),_congestedFrames(0),_peakQueueing(0),_firstFrameTime(0),_firstFrameSent(false),_unbuffered(unbuffered),
 	_writer(writer),publication(publication),_firstKeyFrame(false),receiveAudio(true),receiveVideo(true),client(client),
 	_pAudioWriter(NULL),_pVideoWriter(NULL),_pDataWriter(NULL),_publicationNamePacket((const UInt8*)publication.name().c_str(),publication.name().size()),
 	_time(0),_deltaTime(0),_addingTime(0),_bufferTime(0),_firstAudio(true),_firstVideo(true),_firstTime(true) {
@@ -127,10 +127,20 @@ void Listener::startPublishing() {
 	_ts.update();
 }
 
+void Listener::seek(UInt32 time) {
+	if (!_pVideoWriter && !init())
+		return;
+	_firstTime = true;
+	_addingTime = time;
+	_firstKeyFrame = false;
+	_firstAudio = _firstVideo = true;
+}
+
 void Listener::stopPublishing() {
 	_deltaTime=0;
 	_addingTime = _time;
 	_droppedFrames = 0;
+	_congestedFrames = 0;
 	_writer.writeMedia(Writer::STOP,0,publicationNamePacket());
 }
 
@@ -167,7 +177,7 @@ void Listener::pushDataPacket(DataReader& reader) {
 		init();
 }
 
-void Listener::pushVideoPacket(PacketReader& packet,UInt32 time) {
+void Listener::pushVideoPacket(const SharedBuffer& payload,MediaCache& cache,UInt32 time) {
 	if(!receiveVideo) {
 		_firstKeyFrame=false;
 		_firstVideo=true;
@@ -176,9 +186,22 @@ void Listener::pushVideoPacket(PacketReader& packet,UInt32 time) {
 	if (!_pVideoWriter && !init())
 		return;
 
+	UInt32 queueing(_pVideoWriter->queueing());
+	if (queueing > _peakQueueing)
+		_peakQueueing = queueing;
+
 	// key frame ?
-	if(MediaCodec::IsKeyFrame(packet.current(),packet.available()))
+	if(MediaCodec::IsKeyFrame(payload.data(),payload.size()))
 		_firstKeyFrame=true;
+	else if (_pVideoWriter->congested()) {
+		// subscriber too slow, drops the video until a key frame once its queue drained
+		if (_firstKeyFrame)
+			DEBUG("Video frames dropped on a congested writer (",queueing," bytes queued)");
+		_firstKeyFrame = false;
+		++_droppedFrames;
+		++_congestedFrames;
+		return;
+	}
 
 	if(!_firstKeyFrame) {
 		DEBUG("Video frame dropped to wait first key frame");
@@ -191,7 +214,7 @@ void Listener::pushVideoPacket(PacketReader& packet,UInt32 time) {
 	if(_firstVideo) {
 		_firstVideo=false;
 		UInt32 size(0);
-		if(!MediaCodec::H264::IsCodecInfos(packet.current(),packet.available()) && (size=publication.videoCodecBuffer().size())>0) {
+		if(!MediaCodec::H264::IsCodecInfos(payload.data(),payload.size()) && (size=publication.videoCodecBuffer().size())>0) {
 			PacketReader videoCodecPacket(publication.videoCodecBuffer().data(),size);
 			// Reliable way for video codec packet!
 			bool reliable = _pVideoWriter->reliable;
@@ -202,12 +225,19 @@ void Listener::pushVideoPacket(PacketReader& packet,UInt32 time) {
 		}
 	}
 
-	if(!_pVideoWriter->writeMedia(Writer::VIDEO,time,packet))
+	if(!_pVideoWriter->writeMedia(Writer::VIDEO,time,payload,cache)) {
 		init();
+		return;
+	}
+	if (_firstFrameSent)
+		return;
+	_firstFrameSent = true;
+	_firstFrameTime = (UInt32)_subscribing.elapsed();
+	DEBUG("First video frame of ", publication.name(), " sent to the subscriber after ", _firstFrameTime, "ms");
 }
 
 
-void Listener::pushAudioPacket(PacketReader& packet,UInt32 time) {
+void Listener::pushAudioPacket(const SharedBuffer& payload,MediaCache& cache,UInt32 time) {
 	if(!receiveAudio) {
 		_firstAudio=true;
 		return;
@@ -220,7 +250,7 @@ void Listener::pushAudioPacket(PacketReader& packet,UInt32 time) {
 	if(_firstAudio) {
 		_firstAudio=false;
 		UInt32 size(0);
-		if(!MediaCodec::AAC::IsCodecInfos(packet.current(),packet.available()) && (size=publication.audioCodecBuffer().size())>0) {
+		if(!MediaCodec::AAC::IsCodecInfos(payload.data(),payload.size()) && (size=publication.audioCodecBuffer().size())>0) {
 			PacketReader audioCodecPacket(publication.audioCodecBuffer().data(),size);
 			// Reliable way for audio codec packet!
 			bool reliable = _pAudioWriter->reliable;
@@ -231,7 +261,7 @@ void Listener::pushAudioPacket(PacketReader& packet,UInt32 time) {
 		}
 	}
 
-	if(!_pAudioWriter->writeMedia(Writer::AUDIO,time,packet))
+	if(!_pAudioWriter->writeMedia(Writer::AUDIO,time,payload,cache))
 		init();
 }
 
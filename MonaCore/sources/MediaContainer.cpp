@@ -44,6 +44,13 @@ void FLV::write(BinaryWriter& writer,UInt8 track) {
 
 // Writer audio or video packet
 void FLV::write(BinaryWriter& writer,UInt8 track,UInt32 time,const UInt8* data,UInt32 size) {
+	WriteTagHeader(writer, track, time, size);
+	/// playload
+	writer.writeRaw(data, size);
+	WriteTagFooter(writer, size);
+}
+
+void FLV::WriteTagHeader(BinaryWriter& writer,UInt8 track,UInt32 time,UInt32 size) {
 	/// 11 bytes of header
 	writer.write8(track&AUDIO ? AMF::AUDIO : AMF::VIDEO);
 	// size on 3 bytes
@@ -52,10 +59,6 @@ void FLV::write(BinaryWriter& writer,UInt8 track,UInt32 time,const UInt8* data,U
 	writer.write24(time);
 	// unknown 4 bytes set to 0
 	writer.write32(0);
-	/// playload
-	writer.writeRaw(data, size);
-	/// footer
-	writer.write32(11+size);
 }
 
 ////////////////////  MPEG_TS  /////////////////////////////	
@@ -253,13 +256,9 @@ void MPEGTS::writeTS(BinaryWriter& writer, UInt32& available, UInt32 time, Subst
 					// Adaptive timecode flag on
 					writer.write8(isMetadata? 0x50 : 0x10);
 
-					UInt64 pcr = pts << 9;
-					writer.write8(( pcr >> 34 ) & 0xff);
-					writer.write8(( pcr >> 26 ) & 0xff);
-					writer.write8(( pcr >> 18 ) & 0xff);
-					writer.write8(( pcr >> 10 ) & 0xff);
-					writer.write8(0x7e | ((pcr & (1<<9)) >> 2) & 0xFF | ((pcr & (1<<8)) >> 8 ) & 0xFF);
-					writer.write8(pcr & 0xff);
+					UInt8 pcr[6];
+					FormatPCR(pts, pcr);
+					writer.writeRaw(pcr, sizeof(pcr));
 				}
 				else
 					writer.write8(0x00); // Adaptive timecode flag off
@@ -289,11 +288,9 @@ void MPEGTS::writeTS(BinaryWriter& writer, UInt32& available, UInt32 time, Subst
 			writer.write8(0x05);
 
 			// Calcul of PTS time 
-			writer.write8(((pts >> 29) & 0x06) + 0x21);
-			writer.write8((pts >> 22) & 0xFF);
-			writer.write8(((pts >> 14) & 0xFE) + 0x01);
-			writer.write8((pts >> 7) & 0xFF);
-			writer.write8(((pts << 1) & 0xFE) + 0x01);
+			UInt8 ptsBytes[5];
+			FormatPTS(pts, ptsBytes);
+			writer.writeRaw(ptsBytes, sizeof(ptsBytes));
 
 			// End of header
 			if (type == VIDEO) {
@@ -316,6 +313,43 @@ void MPEGTS::writeTS(BinaryWriter& writer, UInt32& available, UInt32 time, Subst
 		writeTS(writer, available, time, subReader, isMetadata, type, false);
 }
 
+void MPEGTS::patch(UInt8* data, UInt32 size, UInt8 track, UInt32 time) {
+	Track type(track&VIDEO ? VIDEO : AUDIO);
+	UInt64 pts = time*90; // PTS is 90KHz time
+	for (UInt8* packet = data; (packet + MPEGTS_PACKET_SIZE) <= (data + size); packet += MPEGTS_PACKET_SIZE) {
+		packet[3] = (packet[3] & 0xF0) | (_counterRow[type]++ & 0x0F);
+		if (!(packet[1] & 0x40))
+			continue; // not the first row of the frame
+		UInt8* pes(packet + 4);
+		if (packet[3] & 0x20) {
+			// adaptive field, with PCR time?
+			if (packet[4] && (packet[5] & 0x10))
+				FormatPCR(pts, packet + 6);
+			pes += 1 + packet[4];
+		}
+		// PTS after packet start code prefix, stream id, PES size, flags and PES header length
+		FormatPTS(pts, pes + 9);
+	}
+}
+
+void MPEGTS::FormatPCR(UInt64 pts, UInt8* data) {
+	UInt64 pcr = pts << 9;
+	data[0] = ( pcr >> 34 ) & 0xff;
+	data[1] = ( pcr >> 26 ) & 0xff;
+	data[2] = ( pcr >> 18 ) & 0xff;
+	data[3] = ( pcr >> 10 ) & 0xff;
+	data[4] = 0x7e | ((pcr & (1<<9)) >> 2) & 0xFF | ((pcr & (1<<8)) >> 8 ) & 0xFF;
+	data[5] = pcr & 0xff;
+}
+
+void MPEGTS::FormatPTS(UInt64 pts, UInt8* data) {
+	data[0] = ((pts >> 29) & 0x06) + 0x21;
+	data[1] = (pts >> 22) & 0xFF;
+	data[2] = ((pts >> 14) & 0xFE) + 0x01;
+	data[3] = (pts >> 7) & 0xFF;
+	data[4] = ((pts << 1) & 0xFE) + 0x01;
+}
+
 UInt8 MPEGTS::GetAdaptiveSize(bool time, UInt32 available, bool first, bool& adaptiveField, Track type) {
 	
 	UInt8 size = 0;
@@ -225,6 +225,14 @@ void Peer::onUnpublish(const Publication& publication) {
 	WARN("Unpublication client before connection")
 }
 
+bool Peer::onRecord(const Publication& publication,string& error) {
+	if(connected)
+		return _handler.onRecord(*this,publication,error);
+	WARN("Recording client before connection")
+	error = "Client must be connected before recording";
+	return false;
+}
+
 bool Peer::onSubscribe(const Listener& listener,string& error) {
 	if(connected)
 		return _handler.onSubscribe(*this,listener,error);
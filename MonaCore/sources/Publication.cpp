@@ -19,15 +19,20 @@ This file is a part of Mona.
 
 #include "Mona/Publication.h"
 #include "Mona/MediaCodec.h"
+#include "Mona/MediaContainer.h"
+#include "Mona/AMFReader.h"
 #include "Mona/Logs.h"
 
 using namespace std;
 
+// time-shifted listeners receive the buffer twice faster than the real time to catch up the live
+#define TIMESHIFT_CATCHUP_SPEED	2
+
 
 
 namespace Mona {
 
-Publication::Publication(const string& name):_new(false),_name(name),_droppedFrames(0),_firstKeyFrame(false),listeners(_listeners),_pPublisher(NULL) {
+Publication::Publication(const string& name,const PoolBuffers& poolBuffers):_poolBuffers(poolBuffers),_new(false),_name(name),_droppedFrames(0),_firstKeyFrame(false),listeners(_listeners),_pPublisher(NULL),_gopCacheSize(0),_gopCacheDuration(0),_gopCached(0),_timeShift(poolBuffers) {
 	DEBUG("New publication ",_name);
 }
 
@@ -44,7 +49,123 @@ void Publication::setBufferTime(UInt32 ms) {
 	// TODO?
 }
 
-Listener* Publication::addListener(Exception& ex, Peer& peer,Writer& writer,bool unbuffered) {
+void Publication::setGOPCache(UInt32 size, UInt32 duration) {
+	_gopCacheSize = size;
+	_gopCacheDuration = duration;
+	if (size)
+		return;
+	clearGOPCache();
+	_metaData = SharedBuffer();
+}
+
+void Publication::clearGOPCache() {
+	_gopFrames.clear();
+	_gopCached = 0;
+}
+
+void Publication::cacheFrame(Writer::MediaType type, UInt32 time, const SharedBuffer& payload) {
+	if (type == Writer::VIDEO && MediaCodec::IsKeyFrame(payload.data(), payload.size()))
+		clearGOPCache(); // new GOP
+	else if (_gopFrames.empty())
+		return; // wait a key frame to start the cache
+	if ((_gopCached + payload.size()) > _gopCacheSize || (!_gopFrames.empty() && time > _gopFrames.front().time && (time - _gopFrames.front().time) > _gopCacheDuration)) {
+		// a part of GOP is useless for a new listener, cache again from the next key frame
+		DEBUG("GOP of ", _name, " exceeds the cache limits, it will be cached again from the next key frame");
+		clearGOPCache();
+		return;
+	}
+	_gopCached += payload.size();
+	_gopFrames.emplace_back(type, time, payload);
+}
+
+bool Publication::setTimeShift(Exception& ex, UInt32 window, UInt32 size, const string& path) {
+	_timeShifted.clear();
+	return _timeShift.open(ex, window, size, path);
+}
+
+Recorder* Publication::startRecording(Exception& ex, FileWriter& fileWriter, const string& path, bool append) {
+	if (!_pPublisher) {
+		ex.set(Exception::APPLICATION, _name, " is not published");
+		return NULL;
+	}
+	string error;
+	if (!_pPublisher->onRecord(*this, error)) {
+		if (error.empty())
+			error = "Not allowed to record " + _name;
+		ex.set(Exception::PERMISSION, error);
+		return NULL;
+	}
+	if (!_pRecorder)
+		_pRecorder.reset(new Recorder(fileWriter, _poolBuffers));
+	if (!_pRecorder->start(ex, path, append)) {
+		_pRecorder.reset();
+		return NULL;
+	}
+	// codecs already received
+	if (_audioCodecBuffer.size())
+		_pRecorder->writeAudio(0, _audioCodecBuffer.data(), _audioCodecBuffer.size());
+	if (_videoCodecBuffer.size())
+		_pRecorder->writeVideo(0, _videoCodecBuffer.data(), _videoCodecBuffer.size());
+	return _pRecorder.get();
+}
+
+void Publication::stopRecording() {
+	if (!_pRecorder)
+		return;
+	_pRecorder->stop();
+	_pRecorder.reset();
+}
+
+void Publication::pushMetaData(Listener& listener) {
+	if (!_metaData)
+		return;
+	PacketReader packet(_metaData.data(), _metaData.size());
+	shared_ptr<DataReader> pReader;
+	_pPublisher->writer().createReader(packet, pReader);
+	if (pReader)
+		listener.pushDataPacket(*pReader);
+}
+
+void Publication::replay() {
+	auto it = _timeShifted.begin();
+	while (it != _timeShifted.end()) {
+		Client* pClient(it->first);
+		replay(pClient);
+		it = _timeShifted.upper_bound(pClient); // listener can be removed in this call
+	}
+}
+
+void Publication::replay(Client* pClient) {
+	auto it = _timeShifted.find(pClient);
+	Listener& listener(*_listeners[pClient]);
+	UInt64 sequence(it->second.sequence);
+	Writer::MediaType type;
+	UInt32 time;
+	SharedBuffer payload;
+	while (!listener.congested() && _timeShift.read(sequence, type, time, payload)) {
+		TimeShifted& timeShifted(it->second);
+		if (time > timeShifted.time && (time - timeShifted.time) > timeShifted.clock.elapsed()*TIMESHIFT_CATCHUP_SPEED)
+			break; // wait, not to exceed the catch up speed
+		timeShifted.sequence = ++sequence;
+		MediaCache cache;
+		if (type == Writer::AUDIO)
+			listener.pushAudioPacket(payload, cache, time);
+		else
+			listener.pushVideoPacket(payload, cache, time);
+		it = _timeShifted.find(pClient);
+		if (it == _timeShifted.end())
+			return; // listener removed in this call
+		sequence = it->second.sequence;
+	}
+	if (sequence < _timeShift.end()) {
+		it->second.sequence = sequence;
+		return;
+	}
+	DEBUG("Time-shifted subscription to ", _name, " catches up the live");
+	_timeShifted.erase(it);
+}
+
+Listener* Publication::addListener(Exception& ex, Peer& peer,Writer& writer,bool unbuffered,double start) {
 	map<Client*,Listener*>::iterator it = _listeners.lower_bound(&peer);
 	if(it!=_listeners.end() && it->first==&peer) {
 		WARN("Already subscribed for publication ",_name);
@@ -56,8 +177,44 @@ Listener* Publication::addListener(Exception& ex, Peer& peer,Writer& writer,bool
 	string error;
 	if(peer.onSubscribe(*pListener,error)) {
 		_listeners.insert(it,pair<Client*,Listener*>(&peer,pListener));
-		if(_pPublisher)
-			pListener->startPublishing();
+		if(!_pPublisher)
+			return pListener;
+		pListener->startPublishing();
+		UInt64 sequence;
+		if (start >= 0 && _timeShift.seek((UInt32)start, sequence)) {
+			// starts on a key frame of the time-shift buffer, and catches up the live
+			Writer::MediaType type;
+			UInt32 time;
+			SharedBuffer payload;
+			_timeShift.read(sequence, type, time, payload);
+			pushMetaData(*pListener);
+			_timeShifted.emplace(piecewise_construct, forward_as_tuple(&peer), forward_as_tuple(sequence, time));
+			replay(&peer);
+			it = _listeners.find(&peer);  // listener can be removed in this call
+			if (it == _listeners.end() || it->second != pListener) {
+				ex.set(Exception::NETWORK, "Subscription to ", _name, " closed on start");
+				return NULL;
+			}
+			pListener->flush();
+			return pListener;
+		}
+		if (_gopFrames.empty())
+			return pListener;
+		// burst the GOP cache, the listener starts on its key frame rather than waiting the next one
+		pushMetaData(*pListener);
+		for (const Frame& frame : _gopFrames) {
+			MediaCache cache;
+			if (frame.type == Writer::AUDIO)
+				pListener->pushAudioPacket(frame.payload, cache, frame.time);
+			else
+				pListener->pushVideoPacket(frame.payload, cache, frame.time);
+			it = _listeners.find(&peer);  // listener can be removed in this call
+			if (it == _listeners.end() || it->second != pListener) {
+				ex.set(Exception::NETWORK, "Subscription to ", _name, " closed on start");
+				return NULL;
+			}
+		}
+		pListener->flush();
 		return pListener;
 	}
 	if(error.empty())
@@ -76,6 +233,7 @@ void Publication::removeListener(Peer& peer) {
 	Listener* pListener = it->second;
 	peer.onUnsubscribe(*pListener);
 	_listeners.erase(it);
+	_timeShifted.erase(&peer);
 	delete pListener;
 }
 
@@ -116,6 +274,11 @@ void Publication::stop(Peer& peer) {
 	_dataQOS.reset();
 	_videoCodecBuffer.clear();
 	_audioCodecBuffer.clear();
+	clearGOPCache();
+	_metaData = SharedBuffer();
+	_timeShifted.clear();
+	_timeShift.close();
+	stopRecording();
 	_droppedFrames=0;
 	_pPublisher=NULL;
 	return;
@@ -137,6 +300,24 @@ void Publication::pushData(DataReader& reader,UInt32 numberLostFragments) {
 	}
 
 	_new = true;
+	// only AMF metadata can be recorded in a FLV file
+	bool recording(_pRecorder && _pRecorder->recording() && dynamic_cast<AMFReader*>(&reader));
+	if ((_gopCacheSize || _timeShift.opened() || recording) && reader.followingType() == DataReader::STRING) {
+		// keep metadata to send it before the GOP cache or the time-shift buffer
+		const UInt8* data(reader.packet.current());
+		UInt32 size(reader.packet.available());
+		string name;
+		reader.readString(name);
+		if (name == "@setDataFrame" || name == "onMetaData") {
+			if (_gopCacheSize || _timeShift.opened())
+				_metaData = SharedBuffer(_poolBuffers, data, size);
+			if (recording && name == "@setDataFrame" && reader.followingType() == DataReader::STRING)
+				reader.readString(name);
+			if (recording && name == "onMetaData")
+				_pRecorder->writeMetaData(reader.packet.current(), reader.packet.available());
+		}
+		reader.reset();
+	}
 	int pos = reader.packet.position();
 	_dataQOS.add(_pPublisher->ping,reader.available()+4,reader.packet.fragments,numberLostFragments); // 4 for time encoded
 	auto it = _listeners.begin();
@@ -154,7 +335,6 @@ void Publication::pushAudio(PacketReader& packet,UInt32 time,UInt32 numberLostFr
 		return;
 	}
 
-	int pos = packet.position();
 	if(numberLostFragments>0)
 		INFO(numberLostFragments," audio fragments lost on publication ",_name);
 	_audioQOS.add(_pPublisher->ping,packet.available()+4,packet.fragments,numberLostFragments); // 4 for time encoded
@@ -167,10 +347,26 @@ void Publication::pushAudio(PacketReader& packet,UInt32 time,UInt32 numberLostFr
 	}
 
 	_new = true;
-	auto it = _listeners.begin();
-	while(it!=_listeners.end()) {
-		(it++)->second->pushAudioPacket(packet,time);  // listener can be removed in this call
-		packet.reset(pos);
+	if (_pRecorder)
+		_pRecorder->writeAudio(time, packet.current(), packet.available());
+	if (!_listeners.empty() || _gopCacheSize || _timeShift.opened()) {
+		// one copy shared by all the listeners (and the GOP cache or the time-shift buffer), and one serialization by container format
+		SharedBuffer payload(_poolBuffers,packet.current(),packet.available());
+		if (!MediaCodec::AAC::IsCodecInfos(packet.current(),packet.available())) {
+			if (_gopCacheSize)
+				cacheFrame(Writer::AUDIO, time, payload);
+			_timeShift.add(Writer::AUDIO, time, payload);
+		}
+		MediaCache cache;
+		auto it = _listeners.begin();
+		while(it!=_listeners.end()) {
+			if (!_timeShifted.empty() && _timeShifted.count(it->first)) {
+				++it; // receives the time-shift buffer rather than the live
+				continue;
+			}
+			(it++)->second->pushAudioPacket(payload,cache,time);  // listener can be removed in this call
+		}
+		replay();
 	}
 	_pPublisher->onAudioPacket(*this,time,packet);
 }
@@ -207,11 +403,26 @@ void Publication::pushVideo(PacketReader& packet,UInt32 time,UInt32 numberLostFr
 	}
 
 	_new = true;
-	int pos = packet.position();
-	auto it = _listeners.begin();
-	while(it!=_listeners.end()) {
-		(it++)->second->pushVideoPacket(packet,time); // listener can be removed in this call
-		packet.reset(pos);
+	if (_pRecorder)
+		_pRecorder->writeVideo(time, packet.current(), packet.available());
+	if (!_listeners.empty() || _gopCacheSize || _timeShift.opened()) {
+		// one copy shared by all the listeners (and the GOP cache or the time-shift buffer), and one serialization by container format
+		SharedBuffer payload(_poolBuffers,packet.current(),packet.available());
+		if (!MediaCodec::H264::IsCodecInfos(packet.current(), packet.available())) {
+			if (_gopCacheSize)
+				cacheFrame(Writer::VIDEO, time, payload);
+			_timeShift.add(Writer::VIDEO, time, payload);
+		}
+		MediaCache cache;
+		auto it = _listeners.begin();
+		while(it!=_listeners.end()) {
+			if (!_timeShifted.empty() && _timeShifted.count(it->first)) {
+				++it; // receives the time-shift buffer rather than the live
+				continue;
+			}
+			(it++)->second->pushVideoPacket(payload,cache,time); // listener can be removed in this call
+		}
+		replay();
 	}
 	_pPublisher->onVideoPacket(*this,time,packet);
 }
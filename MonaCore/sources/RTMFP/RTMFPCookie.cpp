@@ -26,7 +26,7 @@ using namespace std;
 
 namespace Mona {
 
-RTMFPCookie::RTMFPCookie(RTMFPHandshake& handshake,Invoker& invoker,const string& tag,const shared_ptr<Peer>& pPeer) : _invoker(invoker), _pComputingThread(NULL),_pCookieComputing(new RTMFPCookieComputing(handshake,invoker)),tag(tag),id(0),farId(0),pPeer(pPeer) {
+RTMFPCookie::RTMFPCookie(RTMFPHandshake& handshake,Invoker& invoker,const string& tag,const shared_ptr<Peer>& pPeer) : _invoker(invoker), _pCookieComputing(new RTMFPCookieComputing(handshake,invoker)),tag(tag),id(0),farId(0),pPeer(pPeer) {
 	
 }
 
@@ -36,8 +36,7 @@ bool RTMFPCookie::computeSecret(Exception& ex, const UInt8* initiatorKey,UInt32
 	_pCookieComputing->initiatorNonce.resize(sizeNonce,false);
 	memcpy(_pCookieComputing->initiatorNonce.data(),initiatorNonce,sizeNonce);
 	_pCookieComputing->weak = _pCookieComputing;
-	_pComputingThread = _invoker.poolThreads.enqueue<RTMFPCookieComputing>(ex,_pCookieComputing, _pComputingThread);
-	return !ex;
+	return _invoker.poolThreads.enqueue<RTMFPCookieComputing>(ex,_pCookieComputing, &_computingQueue);
 }
 
 
@@ -28,7 +28,7 @@ using namespace std;
 
 namespace Mona {
 
-RTMFPHandshake::RTMFPHandshake(RTMFProtocol& protocol, Sessions& sessions, Invoker& invoker) : RTMFPSession(protocol, invoker, 0, RTMFP_DEFAULT_KEY, RTMFP_DEFAULT_KEY, "RTMFPHandshake"),
+RTMFPHandshake::RTMFPHandshake(RTMFProtocol& protocol, Sessions& sessions, Invoker& invoker) : RTMFPSession(protocol, 0, invoker, 0, RTMFP_DEFAULT_KEY, RTMFP_DEFAULT_KEY, "RTMFPHandshake"),
 	_sessions(sessions),_pPeer(new Peer((Handler&)invoker)) {
 	
 	memcpy(_certificat,"\x01\x0A\x41\x0E",4);
@@ -42,7 +42,7 @@ RTMFPHandshake::~RTMFPHandshake() {
 	clear();
 }
 
-void RTMFPHandshake::manage() {
+UInt32 RTMFPHandshake::manage() {
 	AttemptCounter::manage();
 
 	// delete obsolete cookie
@@ -56,6 +56,7 @@ void RTMFPHandshake::manage() {
 		} else
 			++it;
 	}
+	return MANAGE_TIMEOUT;
 }
 
 void RTMFPHandshake::commitCookie(const UInt8* value) {
@@ -114,7 +115,7 @@ RTMFPSession* RTMFPHandshake::createSession(const UInt8* cookieValue) {
 	(UInt32&)farId = cookie.farId;
 
 	// Create session
-	RTMFPSession* pSession = &_sessions.create<RTMFPSession,Sessions::BYPEER | Sessions::BYADDRESS>(protocol<RTMFProtocol>(), invoker, farId, cookie.decryptKey(), cookie.encryptKey(),cookie.pPeer);
+	RTMFPSession* pSession = &_sessions.create<RTMFPSession,Sessions::BYPEER | Sessions::BYADDRESS>(protocol<RTMFProtocol>(), protocol<RTMFProtocol>().nextShard(), invoker, farId, cookie.decryptKey(), cookie.encryptKey(),cookie.pPeer);
 	(UInt32&)cookie.id = pSession->id();
 
 	// response!
@@ -31,20 +31,22 @@ using namespace std;
 namespace Mona {
 
 RTMFPSession::RTMFPSession(RTMFProtocol& protocol,
+				UInt8 shard,
 				Invoker& invoker,
 				UInt32 farId,
 				const UInt8* decryptKey,
 				const UInt8* encryptKey,
-				const shared_ptr<Peer>& pPeer) : _failed(false),_pThread(NULL), _socket(protocol), farId(farId), Session(protocol, invoker, pPeer), _pDecryptKey(new RTMFPKey(decryptKey)), _pEncryptKey(new RTMFPKey(encryptKey)), _timesFailed(0), _timeSent(0), _nextRTMFPWriterId(0), _timesKeepalive(0), _pLastWriter(NULL), _prevEngineType(RTMFPEngine::NORMAL) {
+				const shared_ptr<Peer>& pPeer) : _failed(false),shard(shard), _socket(protocol.socket(shard)), farId(farId), Session(protocol, invoker, pPeer), _pDecryptKey(new RTMFPKey(decryptKey)), _pEncryptKey(new RTMFPKey(encryptKey)), _timesFailed(0), _timeSent(0), _nextRTMFPWriterId(0), _timesKeepalive(0), _pLastWriter(NULL), _prevEngineType(RTMFPEngine::NORMAL) {
 	_pFlowNull = new RTMFPFlow(0,"",peer,invoker,*this);
 }
 
 RTMFPSession::RTMFPSession(RTMFProtocol& protocol,
+				UInt8 shard,
 				Invoker& invoker,
 				UInt32 farId,
 				const UInt8* decryptKey,
 				const UInt8* encryptKey,
-				const char* name) : _failed(false),_pThread(NULL), _socket(protocol), farId(farId), Session(protocol, invoker,name), _pDecryptKey(new RTMFPKey(decryptKey)), _pEncryptKey(new RTMFPKey(encryptKey)), _timesFailed(0), _timeSent(0), _nextRTMFPWriterId(0), _timesKeepalive(0), _pLastWriter(NULL), _prevEngineType(RTMFPEngine::NORMAL) {
+				const char* name) : _failed(false),shard(shard), _socket(protocol.socket(shard)), farId(farId), Session(protocol, invoker,name), _pDecryptKey(new RTMFPKey(decryptKey)), _pEncryptKey(new RTMFPKey(encryptKey)), _timesFailed(0), _timeSent(0), _nextRTMFPWriterId(0), _timesKeepalive(0), _pLastWriter(NULL), _prevEngineType(RTMFPEngine::NORMAL) {
 	_pFlowNull = new RTMFPFlow(0,"",peer,invoker,*this);
 }
 
@@ -92,26 +94,28 @@ void RTMFPSession::kill() {
 	_flowWriters.clear();
 }
 
-void RTMFPSession::manage() {
+UInt32 RTMFPSession::manage() {
 	if(died)
-		return;
-
-	Session::manage();
+		return 0;
 
 	if (_failed) {
 		failSignal();
-		return;
+		return MANAGE_TIMEOUT;
 	}
 
 	// After 6 mn we considerate than the session has failed
 	if(_recvTimestamp.isElapsed(360000)) {
 		fail("Timeout no client message");
-		return;
+		return MANAGE_TIMEOUT;
 	}
 
 	// To accelerate the deletion of peer ghost (mainly for netgroup efficient), starts a keepalive server after 2 mn
-	if(_recvTimestamp.isElapsed(120000) && !keepAlive()) // TODO check it!
-		return;
+	UInt32 timeout(MANAGE_TIMEOUT);
+	if(_recvTimestamp.isElapsed(120000)) {
+		if (!keepAlive()) // TODO check it!
+			return MANAGE_TIMEOUT;
+	} else // idle session: next management on the keepalive deadline (receptions, queued messages and repetitions bring it forward)
+		timeout = UInt32(120000 - _recvTimestamp.elapsed()) + 1;
 
 	// Raise RTMFPWriter
 	auto it=_flowWriters.begin();
@@ -129,10 +133,15 @@ void RTMFPSession::manage() {
 			_flowWriters.erase(it++);
 			continue;
 		}
+		// precisely on the next repetition
+		UInt32 writerTimeout(it->second->timeout());
+		if (writerTimeout && writerTimeout < timeout)
+			timeout = writerTimeout;
 		++it;
 	}
 
 	flush();
+	return timeout;
 }
 
 bool RTMFPSession::keepAlive() {
@@ -187,7 +196,7 @@ void RTMFPSession::p2pHandshake(const string& tag,const SocketAddress& address,U
 
 void RTMFPSession::decode(PoolBuffer& poolBuffer, const SocketAddress& address) {
 	_prevEngineType = farId == 0 ? RTMFPEngine::DEFAULT : RTMFPEngine::NORMAL;
-	shared_ptr<RTMFPDecoding> pRTMFPDecoding(new RTMFPDecoding(invoker, poolBuffer,_pDecryptKey,_prevEngineType));
+	shared_ptr<RTMFPDecoding> pRTMFPDecoding(PoolObjects::New<RTMFPDecoding>(invoker, poolBuffer,_pDecryptKey,_prevEngineType));
 	Session::decode<RTMFPDecoding>(pRTMFPDecoding,address);
 }
 
@@ -222,8 +231,7 @@ void RTMFPSession::flush(UInt8 marker,bool echoTime,RTMFPEngine::Type type) {
 		dumpResponse(packet.data() + 6, packet.size() - 6);
 
 		Exception ex;
-		_pThread = _socket.send<RTMFPSender>(ex, _pSender,_pThread);
-		if (ex)
+		if (!_socket.send<RTMFPSender>(ex, _pSender, &_sendingQueue))
 			ERROR("RTMFP flush, ", ex.error());
 	}
 	_pSender.reset();
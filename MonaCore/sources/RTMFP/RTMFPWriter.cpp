@@ -19,6 +19,7 @@ This file is a part of Mona.
 
 #include "Mona/RTMFP/RTMFPWriter.h"
 #include "Mona/Peer.h"
+#include "Mona/Session.h"
 #include "Mona/Util.h"
 #include "Mona/RTMFP/RTMFP.h"
 
@@ -251,7 +252,7 @@ void RTMFPWriter::acknowledgment(PacketReader& packet) {
 			// Write packet
 			size-=3;  // type + timestamp removed, before the "writeMessage"
 			flush(_band.writeMessage(header ? 0x10 : 0x11,(UInt16)size)
-				,stage,flags,header,message.data()+fragment,contentSize);
+				,stage,flags,header,message,fragment,contentSize);
 			header=false;
 			--lostCount;
 			++lostStage;
@@ -312,7 +313,7 @@ UInt32 RTMFPWriter::headerSize(UInt64 stage) { // max size header = 50
 }
 
 
-void RTMFPWriter::flush(BinaryWriter& writer,UInt64 stage,UInt8 flags,bool header,const UInt8* data,UInt16 size) {
+void RTMFPWriter::flush(BinaryWriter& writer,UInt64 stage,UInt8 flags,bool header,RTMFPMessage& message,UInt32 offset,UInt16 size) {
 	if(_stageAck==0 && header)
 		flags |= MESSAGE_HEADER;
 	if(size==0)
@@ -344,7 +345,7 @@ void RTMFPWriter::flush(BinaryWriter& writer,UInt64 stage,UInt8 flags,bool heade
 	}
 
 	if (size > 0)
-		writer.writeRaw(data, size);
+		message.write(writer, offset, size);
 }
 
 void RTMFPWriter::raiseMessage() {
@@ -407,7 +408,7 @@ void RTMFPWriter::raiseMessage() {
 			// Write packet
 			size-=3;  // type + timestamp removed, before the "writeMessage"
 			flush(_band.writeMessage(header ? 0x10 : 0x11,(UInt16)size)
-				,stage++,flags,header,message.data()+fragment,contentSize);
+				,stage++,flags,header,message,fragment,contentSize);
 			available -= contentSize;
 			header=false;
 		}
@@ -435,7 +436,10 @@ void RTMFPWriter::flush(bool full) {
 
 		if(message.repeatable) {
 			++_repeatable;
-			_trigger.start();
+			if (!_trigger.running()) {
+				_trigger.start();
+				_band.manageIn(_trigger.timeout());
+			}
 		}
 
 		UInt32 fragments= 0;
@@ -477,7 +481,7 @@ void RTMFPWriter::flush(bool full) {
 
 			// Write packet
 			size-=3; // type + timestamp removed, before the "writeMessage"
-			flush(_band.writeMessage(head ? 0x10 : 0x11,(UInt16)size,this),_stage,flags,head,message.data()+fragments,contentSize);
+			flush(_band.writeMessage(head ? 0x10 : 0x11,(UInt16)size,this),_stage,flags,head,message,fragments,contentSize);
 
 			
 			message.fragments[fragments] = _stage;
@@ -519,6 +523,7 @@ RTMFPMessageBuffered& RTMFPWriter::createBufferedMessage() {
 	}
 	RTMFPMessageBuffered* pMessage = new RTMFPMessageBuffered(_band.poolBuffers(),reliable);
 	_messages.emplace_back(pMessage);
+	_band.manageIn(Session::MANAGE_TIMEOUT); // flushed at the latest on the next management
 	return *pMessage;
 }
 
@@ -549,6 +554,20 @@ AMFWriter& RTMFPWriter::write(AMF::ContentType type,UInt32 time,PacketReader* pP
 	return amf;
 }
 
+AMFWriter& RTMFPWriter::write(AMF::ContentType type,UInt32 time,const SharedBuffer& payload) {
+	// always buffered, the payload is shared with the other listeners and can't receive the header in place
+	RTMFPMessageBuffered& message(createBufferedMessage());
+	if (!message)
+		return AMFWriter::Null;
+	BinaryWriter& packet = message.writer().packet;
+	packet.write8(type);
+	packet.write32(time);
+	if(type==AMF::DATA)
+		packet.write8(0);
+	message.share(payload);
+	return AMFWriter::Null;
+}
+
 bool RTMFPWriter::writeMember(const Client& client) {
 	RTMFPMessageBuffered& message(createBufferedMessage());
 	message.writer().packet.write8(0x0b); // unknown
@@ -582,5 +601,10 @@ bool RTMFPWriter::writeMedia(MediaType type,UInt32 time,PacketReader& packet) {
 	return _reseted ? false : result;
 }
 
+bool RTMFPWriter::writeMedia(MediaType type,UInt32 time,const SharedBuffer& payload) {
+	bool result = FlashWriter::writeMedia(type,time,payload);
+	return _reseted ? false : result;
+}
+
 
 } // namespace Mona
@@ -25,18 +25,69 @@ using namespace std;
 
 namespace Mona {
 
+RTMFPShard::RTMFPShard(RTMFProtocol& protocol, UInt8 index) : UDPSocket(protocol.invoker.sockets), index(index), _protocol(protocol) {
+	setBatchReception(RTMFP_RECEPTION_BATCH);
+	setBatchSending(true);
+}
+
+void RTMFPShard::onReception(PoolBuffer& pBuffer, const SocketAddress& address) {
+	if (_protocol.auth(address))
+		_protocol.onPacket(pBuffer, address);
+}
+
+void RTMFPShard::onError(const Exception& ex) {
+	WARN("Protocol ", _protocol.name, " (shard ", index, "), ", ex.error());
+}
+
 
 bool RTMFProtocol::load(Exception& ex, const RTMFPParams& params) {
+	setBatchReception(RTMFP_RECEPTION_BATCH);
+	setBatchSending(true);
 	if (!UDProtocol::load(ex, params))
 		return false;
 	(UInt16&)params.keepAliveServer *= 1000;
 	(UInt16&)params.keepAlivePeer *= 1000;
+
+	// sockets bound are SO_REUSEPORT, so others sockets can share the RTMFP port
+	if (params.shards > 1) {
+		SocketAddress address;
+		this->address(address);
+		for (UInt8 i = 1; i < params.shards; ++i) {
+			unique_ptr<RTMFPShard> pShard(new RTMFPShard(*this, i));
+			Exception exShard;
+			if (!pShard->bind(exShard, address)) {
+				WARN("RTMFP shard ", i, " impossible to bind, ", exShard.error());
+				break;
+			}
+			_shards.emplace_back(pShard.release());
+		}
+		DEBUG("RTMFP shared by ", shards(), " sockets");
+	}
+
 	_pHandshake.reset(new RTMFPHandshake(*this, sessions, invoker));
 	return true;
 }
 
-void RTMFProtocol::onPacket(PoolBuffer& pBuffer,const SocketAddress& address) {
+void RTMFProtocol::manage() {
+	if (_pHandshake)
+		_pHandshake->manage();
+
+	// egress statistics of all the shards
+	UInt64 datagrams(0), calls(0), latency(0);
+	batchSendingStats(datagrams, calls, latency);
+	for (unique_ptr<RTMFPShard>& pShard : _shards) {
+		UInt64 shardDatagrams, shardCalls, shardLatency;
+		pShard->batchSendingStats(shardDatagrams, shardCalls, shardLatency);
+		datagrams += shardDatagrams;
+		calls += shardCalls;
+		latency += shardLatency;
+	}
+	_sentDatagrams += datagrams;
+	_sendCalls += calls;
+	_sendLatency += latency;
+}
 
+void RTMFProtocol::onPacket(PoolBuffer& pBuffer,const SocketAddress& address) {
 	if (pBuffer->size()<RTMFP_MIN_PACKET_SIZE) {
 		ERROR("Invalid RTMFP packet");
 		return;
@@ -47,8 +98,8 @@ void RTMFProtocol::onPacket(PoolBuffer& pBuffer,const SocketAddress& address) {
 
 	// TRACE("RTMFP Session ",id);
 	
+	// A session is found by its id whatever the reception shard (address changing of the client), and keeps its own shard to send
 	RTMFPSession* pSession = id == 0 ? _pHandshake.get() : sessions.find<RTMFPSession>(id);
-
 	if (!pSession) {
 		WARN("Unknown RTMFP session ", id);
 		return;
@@ -58,9 +109,7 @@ void RTMFProtocol::onPacket(PoolBuffer& pBuffer,const SocketAddress& address) {
 		_pHandshake->commitCookie(pSession->pRTMFPCookieComputing->value);
 		pSession->pRTMFPCookieComputing.reset();
 	}
-
 	pSession->decode(pBuffer, address);
 }
 
-
 } // namespace Mona
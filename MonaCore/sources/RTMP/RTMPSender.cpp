@@ -25,10 +25,12 @@ using namespace std;
 namespace Mona {
 
 void RTMPSender::pack(RTMPChannel& channel) {
+	UInt32 sharedSize(_sharedSize);
+	_sharedSize = 0;
 	if (sizePos == 0)
 		return;
 	// writer the size of the precedent playload!
-	channel.bodySize = _writer.packet.size()-sizePos+4-headerSize;
+	channel.bodySize = _writer.packet.size()-sizePos+4-headerSize+sharedSize;
 	BinaryWriter(_writer.packet,sizePos).write24(channel.bodySize);
 	sizePos=0;
 }
@@ -224,11 +224,10 @@ void RTMPSession::packetHandler(PacketReader& packet) {
 	_pWriter = NULL;
 }
 
-void RTMPSession::manage() {
-	if (!_pHandshaker)
-		return;
-	if (_pHandshaker->failed)
+UInt32 RTMPSession::manage() {
+	if (_pHandshaker && _pHandshaker->failed)
 		kill();
+	return MANAGE_TIMEOUT;
 }
 
 
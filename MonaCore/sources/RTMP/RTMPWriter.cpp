@@ -90,7 +90,25 @@ void RTMPWriter::close(int code) {
 AMFWriter& RTMPWriter::write(AMF::ContentType type,UInt32 time,PacketReader* pData) {
 	if(state()==CLOSED)
         return AMFWriter::Null;
+	if(!pData)
+		return writeHeader(type,time,0);
+	writeHeader(type,time,pData->available()).packet.writeRaw(pData->current(),pData->available());
+	return AMFWriter::Null;
+}
+
+AMFWriter& RTMPWriter::write(AMF::ContentType type,UInt32 time,const SharedBuffer& payload) {
+	if(state()==CLOSED)
+        return AMFWriter::Null;
+	AMFWriter& writer(writeHeader(type,time,payload.size()));
+	if (_pEncryptKey) // RTMPE, payload has to be encrypted with the rest of the sender
+		writer.packet.writeRaw(payload.data(),payload.size());
+	else
+		_pSender->share(payload);
+	return AMFWriter::Null;
+}
 
+AMFWriter& RTMPWriter::writeHeader(AMF::ContentType type,UInt32 time,UInt32 bodySize) {
+	// bodySize==0 means unknown (written then by RTMPSender::pack)
 	if (time < _channel.absoluteTime)
 		_channel.absoluteTime = time;
 
@@ -100,7 +118,7 @@ AMFWriter& RTMPWriter::write(AMF::ContentType type,UInt32 time,PacketReader* pDa
 	if(_channel.streamId == channel.streamId) {
 		++headerFlag;
 		time -= _channel.absoluteTime; // relative time!
-		if (_channel.type == type && pData && _channel.bodySize == pData->available()) {
+		if (_channel.type == type && bodySize>0 && _channel.bodySize == bodySize) {
 			++headerFlag;
 			if (_channel.time==time)
 				++headerFlag;
@@ -113,7 +131,7 @@ AMFWriter& RTMPWriter::write(AMF::ContentType type,UInt32 time,PacketReader* pDa
 	_channel.type = type;
 
 	if (!_pSender)
-		_pSender.reset(new RTMPSender(_client.manager().poolBuffers));
+		_pSender = PoolObjects::New<RTMPSender>(_client.manager().poolBuffers);
 
 	AMFWriter& writer = _pSender->writer(_channel);
 	BinaryWriter& data = writer.packet;
@@ -145,11 +163,6 @@ AMFWriter& RTMPWriter::write(AMF::ContentType type,UInt32 time,PacketReader* pDa
 			}
 		}
 	}
-
-	if(pData) {
-		data.writeRaw(pData->current(),pData->available());
-        return AMFWriter::Null;
-	}
 	return writer;
 }
 
@@ -0,0 +1,250 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#include "Mona/Recorder.h"
+#include "Mona/MediaContainer.h"
+#include "Mona/MediaCodec.h"
+#include "Mona/AMF.h"
+#include "Mona/FileSystem.h"
+#include "Mona/Date.h"
+#include "Mona/Logs.h"
+#include <fstream>
+
+using namespace std;
+
+namespace Mona {
+
+Recorder::Recorder(FileWriter& fileWriter, const PoolBuffers& poolBuffers) : _fileWriter(fileWriter), _poolBuffers(poolBuffers), _pBuffer(poolBuffers), _sameName(0),
+	_bufferSize(1048576), _fileSize(0), _fileDuration(0), _header(false), _begun(false), _startTime(0), _lastTime(0), _offset(0), _written(0), _hasVideo(false), _waitKeyFrame(true), _dropped(0) {
+}
+
+bool Recorder::start(Exception& ex, const string& path, bool append) {
+	stop();
+	_path = path;
+	_hasVideo = false;
+	_dropped = 0;
+	if (!open(ex, append && !_fileSize && !_fileDuration))
+		return false;
+	NOTE("Recording in ", _pFile->path);
+	return true;
+}
+
+void Recorder::stop() {
+	if (!_pFile)
+		return;
+	flush();
+	if (_pFile)
+		_fileWriter.close(_pFile);
+	_pFile.reset();
+	_pBuffer.release();
+	_audioCodec.clear();
+	_videoCodec.clear();
+	_metaData.clear();
+}
+
+bool Recorder::open(Exception& ex, bool append) {
+	string path(_path);
+	if (_fileSize || _fileDuration) {
+		string name;
+		Date(Time::Now()).toString("-%Y%m%d-%H%M%S", name);
+		if (name == _name)
+			String::Append(name, "-", ++_sameName); // rotations in the same second
+		else {
+			_name = name;
+			_sameName = 0;
+		}
+		path.append(name);
+	}
+	path.append(".flv");
+
+	_header = true;
+	_offset = 0;
+	_written = 0;
+	if (append && FileSystem::Exists(path)) {
+		// times continue after the last tag
+		ifstream file(path, ios::in | ios::binary);
+		file.seekg(0, ios::end);
+		streamoff size(file.tellg());
+		if (size > 13) { // not just the header
+			UInt8 footer[4];
+			file.seekg(-4, ios::end);
+			file.read((char*)footer, sizeof(footer));
+			UInt32 tagSize((footer[0] << 24) | (footer[1] << 16) | (footer[2] << 8) | footer[3]);
+			UInt8 header[11];
+			if (file && tagSize >= 11 && (tagSize + 4) <= (size - 13)) {
+				file.seekg(-(streamoff)(tagSize + 4), ios::end);
+				file.read((char*)header, sizeof(header));
+			}
+			if (!file || tagSize < 11 || (tagSize + 4) > (size - 13) || (header[0] != AMF::AUDIO && header[0] != AMF::VIDEO && header[0] != AMF::DATA_AMF0)) {
+				ex.set(Exception::FILE, "Impossible to append to ", path, ", it doesn't end with a FLV tag");
+				return false;
+			}
+			_offset = ((header[7] << 24) | (header[4] << 16) | (header[5] << 8) | header[6]) + 1;
+			_header = false;
+		} else if (size > 0)
+			_header = false;
+		_written = (UInt32)size;
+	}
+
+	_pFile = _fileWriter.open(ex, path, append);
+	if (!_pFile)
+		return false;
+	_begun = false;
+	_waitKeyFrame = true;
+	_flushed.update();
+	return true;
+}
+
+void Recorder::begin(UInt32 time) {
+	_begun = true;
+	_lastTime = _startTime = time;
+	if (_header) {
+		BinaryWriter writer(reserve(13), 13);
+		FLV().write(writer);
+		_written += 13;
+		_header = false;
+	}
+	// metadata and codecs at the beginning of each file, to be readable alone
+	if (_metaData.size())
+		write(AMF::DATA_AMF0, time, _metaData.data(), _metaData.size());
+	if (_audioCodec.size())
+		write(AMF::AUDIO, time, _audioCodec.data(), _audioCodec.size());
+	if (_videoCodec.size())
+		write(AMF::VIDEO, time, _videoCodec.data(), _videoCodec.size());
+}
+
+void Recorder::writeAudio(UInt32 time, const UInt8* data, UInt32 size) {
+	if (!_pFile)
+		return;
+	if (MediaCodec::AAC::IsCodecInfos(data, size)) {
+		_audioCodec.resize(size, false);
+		memcpy(_audioCodec.data(), data, size);
+		if (!_begun)
+			return; // will be written by begin
+	} else if (!_begun) {
+		if (_hasVideo)
+			return; // wait the video key frame to start the file
+		begin(time);
+	} else if (!_hasVideo && mustRotate(time)) {
+		// audio only, every frame can start a new file
+		if (!rotate())
+			return;
+		begin(time);
+	}
+	write(AMF::AUDIO, time, data, size);
+}
+
+void Recorder::writeVideo(UInt32 time, const UInt8* data, UInt32 size) {
+	if (!_pFile)
+		return;
+	_hasVideo = true;
+	bool isKeyFrame(MediaCodec::IsKeyFrame(data, size));
+	if (isKeyFrame && MediaCodec::H264::IsCodecInfos(data, size)) {
+		_videoCodec.resize(size, false);
+		memcpy(_videoCodec.data(), data, size);
+		if (!_begun)
+			return; // will be written by begin
+	} else if (isKeyFrame) {
+		if (_begun && mustRotate(time) && !rotate())
+			return;
+		_waitKeyFrame = false;
+		if (!_begun)
+			begin(time);
+	} else if (_waitKeyFrame)
+		return;
+	write(AMF::VIDEO, time, data, size);
+}
+
+void Recorder::writeMetaData(const UInt8* data, UInt32 size) {
+	if (!_pFile)
+		return;
+	// "onMetaData" string, then the value
+	_metaData.resize(13 + size, false);
+	BinaryWriter writer(_metaData.data(), _metaData.size());
+	writer.write8(AMF_STRING).write16(10).writeRaw("onMetaData").writeRaw(data, size);
+	if (_begun)
+		write(AMF::DATA_AMF0, _lastTime, _metaData.data(), _metaData.size());
+}
+
+bool Recorder::mustRotate(UInt32 time) const {
+	return (_fileSize && _written >= _fileSize) || (_fileDuration && time > _startTime && (time - _startTime) >= _fileDuration);
+}
+
+bool Recorder::rotate() {
+	flush();
+	if (!_pFile)
+		return false;
+	_fileWriter.close(_pFile);
+	Exception ex;
+	if (!open(ex, false)) {
+		ERROR("Recording stopped, ", ex.error());
+		_pFile.reset();
+		return false;
+	}
+	NOTE("Recording in ", _pFile->path);
+	return true;
+}
+
+UInt8* Recorder::reserve(UInt32 size) {
+	if (_pBuffer.empty()) {
+		// preallocate a large buffer to append tags without reallocation
+		_pBuffer->resize(_bufferSize, false);
+		_pBuffer->clear();
+	}
+	UInt32 offset(_pBuffer->size());
+	_pBuffer->resize(offset + size, true);
+	return _pBuffer->data() + offset;
+}
+
+void Recorder::write(UInt8 type, UInt32 time, const UInt8* data, UInt32 size) {
+	_lastTime = time;
+	BinaryWriter writer(reserve(size + 15), size + 15);
+	// 11 bytes of header (time on 3 bytes + 1 byte of extension)
+	time = _offset + (time > _startTime ? (time - _startTime) : 0);
+	writer.write8(type).write24(size).write24(time).write8(time >> 24).write24(0);
+	writer.writeRaw(data, size);
+	FLV::WriteTagFooter(writer, size);
+	_written += size + 15;
+	if (_pBuffer->size() >= _bufferSize || _flushed.isElapsed(1000))
+		flush();
+}
+
+void Recorder::flush() {
+	_flushed.update();
+	if (_pBuffer.empty())
+		return;
+	if (!_pFile || _pFile->failed()) {
+		// error already logged by the FileWriter
+		if (_pFile)
+			ERROR("Recording in ", _pFile->path, " stopped");
+		_pFile.reset();
+		_pBuffer.release();
+		return;
+	}
+	if (_fileWriter.write(_pFile, _pBuffer))
+		return;
+	// queue full, the video restarts on the next key frame
+	if (!_dropped++)
+		WARN("Recording in ", _pFile->path, " too slow, data dropped");
+	_pBuffer.release();
+	_waitKeyFrame = true;
+}
+
+
+} // namespace Mona
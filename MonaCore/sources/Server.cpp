@@ -19,6 +19,8 @@ This file is a part of Mona.
 
 #include "Mona/Server.h"
 #include "Mona/Sessions.h"
+#include "Mona/Util.h"
+#include <algorithm>
 
 
 using namespace std;
@@ -27,6 +29,13 @@ using namespace std;
 namespace Mona {
 
 
+static string& Placement(const vector<UInt16>& processors, string& value) {
+	if (processors.empty())
+		return value.assign("any processor");
+	return Util::FormatProcessors(processors, value).insert(0, "processors ");
+}
+
+
 ServerManager::ServerManager(Server& server):_server(server),Task(server),Startable("ServerManager") {
 }
 
@@ -41,7 +50,7 @@ void ServerManager::handle(Exception& ex) {
 	_server.relay.manage();
 }
 
-Server::Server(UInt32 socketBufferSize,UInt16 threads) : Startable("Server"),Handler(socketBufferSize,threads),_countClients(0),_protocols(*this),_manager(*this) {
+Server::Server(UInt32 socketBufferSize,UInt16 threads,UInt16 reactors) : Startable("Server"),Handler(socketBufferSize,threads,reactors),_countClients(0),_protocols(*this),_manager(*this),_allocations(0),_recyclings(0),_deferrals(0) {
 	if (socketBufferSize>0)
 		DEBUG("Socket Buffer size of ",socketBufferSize," bytes")
 }
@@ -56,6 +65,7 @@ bool Server::start(const ServerParams& params) {
 		return false;
 	}
 	(ServerParams&)this->params = params;
+	Startable::setAffinity(params.serverAffinity);
 	Exception ex;
 	bool result;
 	EXCEPTION_TO_LOG(result = Startable::start(ex, params.threadPriority), "Server");
@@ -70,10 +80,34 @@ void Server::run(Exception& exc) {
 		TaskHandler::start();
 
 		Exception exWarn;
+		((PoolBuffers&)poolBuffers).setTrimming(params.buffersTrimDelay * 1000, params.buffersTrimMaximum);
+
+		// thread placement, the relay reactor follows the socket reactors
+		((SocketManager&)sockets).setAffinity(params.reactorsAffinity);
+		vector<UInt16> processors(params.reactorsAffinity);
+		if (!processors.empty())
+			rotate(processors.begin(), processors.begin() + (sockets.reactors() % processors.size()), processors.end());
+		((RelayServer&)relay).setAffinity(processors);
+		poolThreads.setAffinity(params.workersAffinity);
+		resolver.setAffinity(params.backgroundAffinity);
+		_manager.setAffinity(params.backgroundAffinity);
+		fileWriter.setAffinity(params.backgroundAffinity);
+		fileWriter.setQueueing(params.recordQueueing);
+		fileWriter.setSync((FileWriter::Sync)params.recordSync);
+		string server, reactors, workers, background;
+		NOTE("Placement on ", Util::NodeCount(), " NUMA node(s): server thread on ", Placement(params.serverAffinity, server), ", ", sockets.reactors(), " reactor(s) on ", Placement(params.reactorsAffinity, reactors),
+			", ", poolThreads.threadsAvailable(), " worker(s) on ", Placement(params.workersAffinity, workers), ", background threads on ", Placement(params.backgroundAffinity, background));
 		if (((SocketManager&)sockets).start(exWarn) && ((RelayServer&)relay).start(exWarn)) {
 			if (exWarn)
 				WARN(exWarn.error());
 
+			Exception exDNS;
+			resolver.setTTL(params.dnsTTL, params.dnsNegativeTTL);
+			if (!params.dnsHosts.empty() && !resolver.loadHosts(exDNS, params.dnsHosts))
+				WARN("DNS hosts file, ", exDNS.error());
+			if (!resolver.start(exDNS))
+				WARN("DNS resolver, ", exDNS.error());
+
 			_pSessions.reset(new Sessions());
 
 			_protocols.load(*_pSessions);
@@ -84,8 +118,12 @@ void Server::run(Exception& exc) {
 				ex.set(exWarn);
 			else if (exWarn)
 				WARN(exWarn.error());
-			while (!ex && sleep() != STOP)
+			// wakes up on tasks, or on the next expiration of timers (sessions management, etc.)
+			UInt32 timeout(0);
+			while (!ex && sleep(timeout) != STOP) {
 				giveHandle(ex);
+				timeout = ((Timer&)timer).raise();
+			}
 		} else
 			ex.set(exWarn);
 		if (ex)
@@ -100,6 +138,9 @@ void Server::run(Exception& exc) {
 	// terminate the tasks (forced to do immediatly, because no more "giveHandle" is called)
 	TaskHandler::stop();
 
+	// terminate DNS resolutions (their results can't be delivered anymore)
+	resolver.stop();
+
 	// terminate manager
 	_manager.stop();
 
@@ -116,11 +157,21 @@ void Server::run(Exception& exc) {
 	// stop event to unload children resource (before to release sockets, threads, and buffers)
 	onStop();
 
+	// write the end of the recordings
+	fileWriter.stop();
+	if (fileWriter.dropped())
+		WARN(fileWriter.dropped(), " recording buffers dropped because the disk was too slow");
+
 	// terminate sockets manager
 	((SocketManager&)sockets).stop();
 
 	// stop receiving and sending engine (it waits the end of sending last session messages)
 	poolThreads.join();
+	DEBUG(poolThreads.executed(), " works executed by the poolthreads, ", poolThreads.stolen(), " stolen by an idle thread");
+	DEBUG(PoolObjects::Allocations(), " heap allocations and ", PoolObjects::Recyclings(), " recyclings of pooled objects");
+
+	// release tasks posted meanwhile by sockets and decodings
+	TaskHandler::stop();
 
 	// release memory
 	((PoolBuffers&)poolBuffers).clear();
@@ -134,6 +185,24 @@ void Server::manage() {
 		_pSessions->manage();
 	if(clients.count() != _countClients)
 		INFO((_countClients=clients.count())," clients");
+
+	// per message objects, heap allocations have to disappear once the pools are warm
+	UInt64 allocations(PoolObjects::Allocations()), recyclings(PoolObjects::Recyclings());
+	Int64 elapsed(_poolObjectsTime.elapsed());
+	if (elapsed > 0 && (allocations != _allocations || recyclings != _recyclings)) {
+		DEBUG((allocations - _allocations) * 1000 / elapsed, " heap allocations/s and ", (recyclings - _recyclings) * 1000 / elapsed, " recyclings/s of pooled objects");
+		_allocations = allocations;
+		_recyclings = recyclings;
+	}
+	_poolObjectsTime.update();
+
+	UInt64 deferrals(this->deferrals());
+	if (deferrals != _deferrals)
+		WARN(deferrals - _deferrals, " decoded packets deferred on a full server queue, the server thread is overloaded");
+	_deferrals = deferrals;
+
+	// idle buffers beyond the recent needs
+	((PoolBuffers&)poolBuffers).trim();
 }
 
 
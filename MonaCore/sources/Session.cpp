@@ -29,7 +29,8 @@ using namespace std;
 namespace Mona {
 
 Session::Session(Protocol& protocol, Invoker& invoker, const shared_ptr<Peer>& pPeer, const char* name) : _sessionsOptions(0),_pPeer(pPeer),peer(*_pPeer),_pSessions(NULL), dumpJustInDebug(false),
-	Expirable(this), _protocol(protocol), _name(name ? name : ""), invoker(invoker), _pDecodingThread(NULL), died(false), _id(0) {
+	Expirable(this), _protocol(protocol), _name(name ? name : ""), invoker(invoker), died(false), _id(0),
+	_onManage([this](UInt32) { return onManage(); }) {
 	((string&)peer.protocol) = protocol.name;
 	if(memcmp(peer.id,"\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0",ID_SIZE)==0)
 		Util::Random(peer.id,ID_SIZE);
@@ -37,7 +38,8 @@ Session::Session(Protocol& protocol, Invoker& invoker, const shared_ptr<Peer>& p
 }
 	
 Session::Session(Protocol& protocol, Invoker& invoker, const char* name) : _sessionsOptions(0),dumpJustInDebug(false), _pSessions(NULL), _pPeer(new Peer((Handler&)invoker)),
-	Expirable(this),_protocol(protocol),_name(name ? name : ""), invoker(invoker), _pDecodingThread(NULL), died(false), _id(0), peer(*_pPeer) {
+	Expirable(this),_protocol(protocol),_name(name ? name : ""), invoker(invoker), died(false), _id(0), peer(*_pPeer),
+	_onManage([this](UInt32) { return onManage(); }) {
 	((string&)peer.protocol) = protocol.name;
 	if(memcmp(peer.id,"\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0\0",ID_SIZE)==0)
 		Util::Random(peer.id, ID_SIZE);
@@ -61,6 +63,27 @@ void Session::kill() {
 		return;
 	peer.onDisconnection();
 	(bool&)died=true;
+	if (_pSessions)
+		_pSessions->_killeds.emplace_back(_id); // deleted on the next Sessions::manage
+}
+
+UInt32 Session::onManage() {
+	UInt32 timeout(0);
+	if(!died)
+		timeout = manage();
+	if(!died)
+		flush();
+	return died ? 0 : timeout;
+}
+
+void Session::manageIn(UInt32 timeout) {
+	if (!_pSessions || died)
+		return; // not managed by Sessions
+	if (!timeout)
+		timeout = 1;
+	// if running and expiration is passed, it's in progress of raising and its manage() will return the next timeout
+	if (!_onManage.running() || (_onManage.expiration() - Timer::Now()) > timeout)
+		invoker.timer.set(_onManage, timeout);
 }
 
 void Session::receiveWithoutFlush(PacketReader& packet) {
@@ -63,18 +63,12 @@ void Sessions::updateAddress(Session& session, const SocketAddress& oldAddress)
 
 
 void Sessions::manage() {
-	auto it= _sessions.begin();
-	while(it!=_sessions.end()) {
-		if(!it->second->died)
-			it->second->manage();
-		if(!it->second->died)
-			it->second->flush();
-		if(it->second->died) {
-			remove(it++);
-			continue;
-		}
-		++it;
+	for (UInt32 id : _killeds) {
+		auto it = _sessions.find(id);
+		if (it != _sessions.end() && it->second->died)
+			remove(it);
 	}
+	_killeds.clear();
 }
 
 
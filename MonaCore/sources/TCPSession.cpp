@@ -18,7 +18,7 @@ This file is a part of Mona.
 */
 
 #include "Mona/TCPSession.h"
-#include "Mona/Protocol.h"
+#include "Mona/TCProtocol.h"
 
 using namespace std;
 
@@ -27,6 +27,9 @@ namespace Mona {
 
 TCPSession::TCPSession(const SocketAddress& peerAddress, SocketFile& file, Protocol& protocol, Invoker& invoker) : TCPClient(peerAddress,file,invoker.sockets), Session(protocol, invoker),_consumed(false),_decoding(false) {
 	((SocketAddress&)peer.address).set(peerAddress);
+	TCProtocol* pProtocol(dynamic_cast<TCProtocol*>(&protocol));
+	if (pProtocol)
+		setWatermarks(pProtocol->sendHighWatermark(), pProtocol->sendLowWatermark());
 }
 
 void TCPSession::onError(const Exception& ex) {
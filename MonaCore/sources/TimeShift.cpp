@@ -0,0 +1,136 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#include "Mona/TimeShift.h"
+#include "Mona/MediaCodec.h"
+#include "Mona/FileSystem.h"
+#include "Mona/Logs.h"
+#include <algorithm>
+
+using namespace std;
+
+namespace Mona {
+
+TimeShift::TimeShift(const PoolBuffers& poolBuffers) : _poolBuffers(poolBuffers), _window(0), _capacity(0), _size(0), _writing(0), _first(0) {
+}
+
+bool TimeShift::open(Exception& ex, UInt32 window, UInt32 size, const string& path) {
+	close();
+	if (!window || !size)
+		return true; // disabled
+	if (!path.empty() && !_file.open(ex, path, size))
+		return false;
+	_window = window;
+	_capacity = size;
+	return true;
+}
+
+void TimeShift::close() {
+	if (_file.opened()) {
+		string path(_file.path());
+		_file.close();
+		FileSystem::Remove(path);
+	}
+	_first = end(); // sequences keep increasing
+	_frames.clear();
+	_keyFrames.clear();
+	_size = _writing = _window = _capacity = 0;
+}
+
+void TimeShift::removeFront() {
+	_size -= _frames.front().size;
+	_frames.pop_front();
+	++_first;
+	while (!_keyFrames.empty() && _keyFrames.front() < _first)
+		_keyFrames.pop_front();
+}
+
+void TimeShift::add(Writer::MediaType type, UInt32 time, const SharedBuffer& payload) {
+	if (!opened())
+		return;
+	if (payload.size() > _capacity) {
+		WARN("Frame of ", payload.size(), " bytes exceeds the time-shift buffer size");
+		return;
+	}
+	bool isKeyFrame(type == Writer::VIDEO && MediaCodec::IsKeyFrame(payload.data(), payload.size()));
+	UInt32 offset(0);
+	if (_file.opened()) {
+		// ring file, frames stay contiguous
+		if ((_writing + payload.size()) > _capacity) {
+			// frames after the writing position are the oldest ones
+			while (!_frames.empty() && _frames.front().offset >= _writing)
+				removeFront();
+			_writing = 0;
+		}
+		while (!_frames.empty() && _frames.front().offset >= _writing && _frames.front().offset < (_writing + payload.size()))
+			removeFront();
+		offset = _writing;
+		memcpy(_file.data() + offset, payload.data(), payload.size());
+		_writing += payload.size();
+	} else {
+		while (!_frames.empty() && (_size + payload.size()) > _capacity)
+			removeFront();
+	}
+
+	_frames.emplace_back(type, time, isKeyFrame, offset, payload.size());
+	if (!_file.opened())
+		_frames.back().payload = payload; // shared, without copy
+	if (isKeyFrame)
+		_keyFrames.emplace_back(end() - 1);
+	_size += payload.size();
+
+	// time window
+	while (_frames.size()>1 && time > _frames.front().time && (time - _frames.front().time) > _window)
+		removeFront();
+}
+
+bool TimeShift::seek(UInt32 time, UInt64& sequence) const {
+	if (_keyFrames.empty())
+		return false;
+	// first key frame after time, and take the previous one
+	auto it = upper_bound(_keyFrames.begin(), _keyFrames.end(), time, [this](UInt32 time, UInt64 sequence) { return time < _frames[(size_t)(sequence - _first)].time; });
+	sequence = it == _keyFrames.begin() ? *it : *(--it);
+	return true;
+}
+
+bool TimeShift::read(UInt64& sequence, Writer::MediaType& type, UInt32& time, SharedBuffer& payload) const {
+	if (sequence < _first) {
+		// removed, reader too slow, continue on the next key frame
+		sequence = _keyFrames.empty() ? end() : _keyFrames.front();
+	}
+	if (sequence >= end())
+		return false;
+	const Frame& frame(_frames[(size_t)(sequence - _first)]);
+	type = frame.type;
+	time = frame.time;
+	if (_file.opened()) {
+		shared_ptr<PoolBuffer> pCopy(frame.pCopy.lock());
+		if (!pCopy) {
+			pCopy.reset(new PoolBuffer(_poolBuffers, frame.size));
+			memcpy((*pCopy)->data(), _file.data() + frame.offset, frame.size);
+			frame.pCopy = pCopy;
+		}
+		payload = SharedBuffer(pCopy, (*pCopy)->data(), frame.size);
+	} else
+		payload = frame.payload;
+	return true;
+}
+
+
+} // namespace Mona
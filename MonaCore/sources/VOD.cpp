@@ -0,0 +1,153 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#include "Mona/VOD.h"
+#include "Mona/AMFReader.h"
+#include "Mona/MediaContainer.h"
+#include "Mona/Logs.h"
+
+using namespace std;
+
+// ms of frames sent in advance of the real time, to absorb the network jitter
+#define VOD_AHEAD	500
+// ms between two checks of a congested listener
+#define VOD_CONGESTION_DELAY	20
+
+namespace Mona {
+
+VOD::VOD(const string& name, const Timer& timer, const PoolBuffers& poolBuffers) : _publication(name, poolBuffers), _timer(timer) {
+}
+
+VOD::~VOD() {
+	// stop the timers before that the publication deletes the listeners
+	_players.clear();
+}
+
+Listener* VOD::addListener(Exception& ex, Peer& peer, Writer& writer, bool unbuffered, double start) {
+	Listener* pListener(_publication.addListener(ex, peer, writer, unbuffered));
+	if (!pListener)
+		return NULL;
+	auto it = _players.lower_bound(&peer);
+	if (it != _players.end() && it->first == &peer)
+		return pListener; // already playing
+	it = _players.emplace_hint(it, piecewise_construct, forward_as_tuple(&peer), forward_as_tuple(*this, &peer));
+	it->second.pListener = pListener;
+	pListener->startPublishing();
+	this->start(it->second, start >= 0 ? (UInt32)start : 0);
+	return pListener;
+}
+
+bool VOD::removeListener(Peer& peer) {
+	auto it = _players.find(&peer);
+	if (it == _players.end())
+		return false;
+	_players.erase(it); // stops its timer
+	_publication.removeListener(peer);
+	return true;
+}
+
+bool VOD::seek(Peer& peer, UInt32 time) {
+	auto it = _players.find(&peer);
+	if (it == _players.end())
+		return false;
+	start(it->second, time);
+	return true;
+}
+
+void VOD::start(Player& player, UInt32 time) {
+	player.offset = _file.seek(time, player.time);
+	player.header = true;
+	player.clock.update();
+	player.pListener->seek(player.time);
+	// frames are sent from the timer, after the response to the play or seek request
+	_timer.set(player.onTimer, 1);
+}
+
+UInt32 VOD::play(Client* pClient) {
+	auto it = _players.find(pClient);
+	if (it == _players.end())
+		return 0;
+	UInt8 type;
+	UInt32 offset, time, size;
+	const UInt8* data;
+
+	if (it->second.header) {
+		it->second.header = false;
+		// metadata and codecs, to play from any key frame
+		if ((data = _file.metaData(size))) {
+			PacketReader packet(data, size);
+			AMFReader reader(packet);
+			it->second.pListener->pushDataPacket(reader);
+			if ((it = _players.find(pClient)) == _players.end())
+				return 0; // listener removed in this call
+		}
+		MediaCache cache;
+		if ((data = _file.audioCodec(size))) {
+			it->second.pListener->pushAudioPacket(_file.slice(data, size), cache, it->second.time + 1);
+			if ((it = _players.find(pClient)) == _players.end())
+				return 0; // listener removed in this call
+		}
+		if ((data = _file.videoCodec(size))) {
+			it->second.pListener->pushVideoPacket(_file.slice(data, size), cache, it->second.time + 1);
+			if ((it = _players.find(pClient)) == _players.end())
+				return 0; // listener removed in this call
+		}
+	}
+
+	for (;;) {
+		Player& player(it->second);
+		if (!_file.read(offset = player.offset, type, time, data, size)) {
+			DEBUG("End of ", _file.path(), " VOD for one listener");
+			player.pListener->stopPublishing();
+			player.pListener->flush();
+			return 0;
+		}
+		if (player.pListener->congested()) {
+			// pause without accumulating a delay to catch up
+			player.time = time;
+			player.clock.update();
+			player.pListener->flush();
+			return VOD_CONGESTION_DELAY;
+		}
+		Int64 elapsed(player.clock.elapsed() + VOD_AHEAD);
+		if (time > player.time && (time - player.time) > elapsed) {
+			player.pListener->flush();
+			return UInt32((time - player.time) - elapsed);
+		}
+		player.offset = offset;
+		// tags already sent with the header are skipped, and time+1 because the listener takes 0 as an absence of time
+		UInt32 headerSize;
+		MediaCache cache;
+		if (type == AMF::AUDIO && data != _file.audioCodec(headerSize))
+			player.pListener->pushAudioPacket(_file.slice(data, size), cache, time + 1);
+		else if (type == AMF::VIDEO && data != _file.videoCodec(headerSize))
+			player.pListener->pushVideoPacket(_file.slice(data, size), cache, time + 1);
+		else if (type == AMF::DATA_AMF0 && data != _file.metaData(headerSize)) {
+			PacketReader packet(data, size);
+			AMFReader reader(packet);
+			player.pListener->pushDataPacket(reader);
+		} else
+			continue;
+		if ((it = _players.find(pClient)) == _players.end())
+			return 0; // listener removed in this call
+	}
+}
+
+
+} // namespace Mona
@@ -0,0 +1,178 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#include "Mona/VODFile.h"
+#include "Mona/MediaCodec.h"
+#include "Mona/AMF.h"
+#include "Mona/FileSystem.h"
+#include "Mona/BinaryReader.h"
+#include "Mona/BinaryWriter.h"
+#include "Mona/Logs.h"
+#include <fstream>
+#include <algorithm>
+
+using namespace std;
+
+// to build again the indexes written by a previous format
+#define INDEX_VERSION	1
+
+namespace Mona {
+
+VODFile::VODFile() : _pFile(new MappedFile()), _first(0), _duration(0), _metaData(0), _audioCodec(0), _videoCodec(0) {
+}
+
+bool VODFile::open(Exception& ex, const string& path) {
+	close();
+	if (!_pFile->open(ex, path))
+		return false;
+	const UInt8* data(_pFile->data());
+	if (_pFile->size() < 13 || memcmp(data, EXPAND_DATA_SIZE("FLV")) != 0) {
+		ex.set(Exception::FORMATTING, path, " is not a FLV file");
+		close();
+		return false;
+	}
+	_first = ((data[5] << 24) | (data[6] << 16) | (data[7] << 8) | data[8]) + 4; // header size + first previous tag size
+	if (_first > _pFile->size())
+		_first = _pFile->size();
+
+	Time lastModified(0);
+	Exception ignore;
+	FileSystem::GetLastModified(ignore, path, lastModified);
+	string indexPath(path + ".index");
+	if (!loadIndex(indexPath, _pFile->size(), lastModified)) {
+		buildIndex();
+		saveIndex(indexPath, _pFile->size(), lastModified);
+	}
+	DEBUG("VOD ", path, " opened, ", _duration, "ms and ", _keyFrames.size(), " key frames");
+	return true;
+}
+
+void VODFile::close() {
+	if (_pFile->opened())
+		_pFile.reset(new MappedFile());
+	_first = _duration = _metaData = _audioCodec = _videoCodec = 0;
+	_keyFrames.clear();
+}
+
+bool VODFile::read(UInt32& offset, UInt8& type, UInt32& time, const UInt8*& data, UInt32& size) const {
+	if ((offset + 15) > _pFile->size())
+		return false;
+	const UInt8* tag(_pFile->data() + offset);
+	type = tag[0] & 0x1F;
+	size = (tag[1] << 16) | (tag[2] << 8) | tag[3];
+	if ((offset + 15 + size) > _pFile->size())
+		return false; // truncated
+	time = (tag[7] << 24) | (tag[4] << 16) | (tag[5] << 8) | tag[6];
+	data = tag + 11;
+	offset += 15 + size;
+	return true;
+}
+
+const UInt8* VODFile::tag(UInt32 offset, UInt32& size) const {
+	UInt8 type;
+	UInt32 time;
+	const UInt8* data(NULL);
+	if (!offset || !read(offset, type, time, data, size))
+		size = 0;
+	return data;
+}
+
+UInt32 VODFile::seek(UInt32 time, UInt32& keyTime) const {
+	// last key frame <= time
+	auto it = upper_bound(_keyFrames.begin(), _keyFrames.end(), time, [](UInt32 time, const KeyFrame& keyFrame) { return time < keyFrame.time; });
+	if (it == _keyFrames.begin()) {
+		keyTime = 0;
+		return _first;
+	}
+	--it;
+	keyTime = it->time;
+	return it->offset;
+}
+
+void VODFile::buildIndex() {
+	vector<KeyFrame> audioFrames;
+	UInt32 offset(_first), position, time, size;
+	UInt8 type;
+	const UInt8* data;
+	for (position = offset; read(offset, type, time, data, size); position = offset) {
+		_duration = time;
+		if (type == AMF::VIDEO) {
+			if (!MediaCodec::IsKeyFrame(data, size))
+				continue;
+			if (MediaCodec::H264::IsCodecInfos(data, size)) {
+				if (!_videoCodec)
+					_videoCodec = position;
+			} else
+				_keyFrames.emplace_back(time, position);
+		} else if (type == AMF::AUDIO) {
+			if (MediaCodec::AAC::IsCodecInfos(data, size)) {
+				if (!_audioCodec)
+					_audioCodec = position;
+			} else if (_keyFrames.empty() && (audioFrames.empty() || (time - audioFrames.back().time) >= 1000))
+				audioFrames.emplace_back(time, position);
+		} else if (type == AMF::DATA_AMF0 && !_metaData)
+			_metaData = position;
+	}
+	if (_keyFrames.empty())
+		_keyFrames = move(audioFrames);
+}
+
+bool VODFile::loadIndex(const string& path, UInt32 size, Int64 lastModified) {
+	ifstream file(path, ios::in | ios::binary);
+	if (!file.good())
+		return false;
+	string content((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+	BinaryReader reader((const UInt8*)content.data(), content.size());
+	if (reader.available() < 36 || reader.read32() != INDEX_VERSION || reader.read32() != size)
+		return false;
+	Int64 time((Int64)reader.read32() << 32);
+	if ((time | reader.read32()) != lastModified)
+		return false;
+	_duration = reader.read32();
+	_metaData = reader.read32();
+	_audioCodec = reader.read32();
+	_videoCodec = reader.read32();
+	UInt32 count(reader.read32());
+	if (reader.available() < count * 8)
+		return false;
+	_keyFrames.reserve(count);
+	while (count--) {
+		UInt32 time(reader.read32());
+		_keyFrames.emplace_back(time, reader.read32());
+	}
+	return true;
+}
+
+void VODFile::saveIndex(const string& path, UInt32 size, Int64 lastModified) const {
+	ofstream file(path, ios::out | ios::binary | ios::trunc);
+	if (!file.good()) {
+		DEBUG("Index of ", _pFile->path(), " not cached, impossible to write ", path);
+		return;
+	}
+	vector<UInt8> buffer(36 + _keyFrames.size() * 8);
+	BinaryWriter writer(buffer.data(), buffer.size());
+	writer.write32(INDEX_VERSION).write32(size).write32((UInt32)(lastModified >> 32)).write32((UInt32)lastModified);
+	writer.write32(_duration).write32(_metaData).write32(_audioCodec).write32(_videoCodec).write32(_keyFrames.size());
+	for (const KeyFrame& keyFrame : _keyFrames)
+		writer.write32(keyFrame.time).write32(keyFrame.offset);
+	file.write((const char*)buffer.data(), buffer.size());
+}
+
+
+} // namespace Mona
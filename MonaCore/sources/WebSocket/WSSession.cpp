@@ -141,11 +141,12 @@ void WSSession::packetHandler(PacketReader& packet) {
 }
 
 
-void WSSession::manage() {
+UInt32 WSSession::manage() {
 	if(peer.connected && _time.isElapsed(60000)) { // 1 mn
 		_writer.writePing();
 		_time.update();
 	}
+	return MANAGE_TIMEOUT;
 }
 
 
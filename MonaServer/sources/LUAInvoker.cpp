@@ -21,12 +21,15 @@ This file is a part of Mona.
 #include "LUAPublication.h"
 #include "LUAUDPSocket.h"
 #include "LUATCPClient.h"
+#include "LUATimer.h"
 #include "LUATCPServer.h"
 #include "LUAGroup.h"
 #include "LUAMember.h"
 #include "LUAFilePath.h"
 #include "Mona/Exceptions.h"
 #include "Mona/Files.h"
+#include "Mona/TCProtocol.h"
+#include "Mona/RTMFP/RTMFProtocol.h"
 #include "MonaServer.h"
 #include <openssl/evp.h>
 #include "Mona/JSONReader.h"
@@ -173,6 +176,21 @@ int	LUAInvoker::CreateTCPServer(lua_State *pState) {
 	SCRIPT_CALLBACK_RETURN
 }
 
+int	LUAInvoker::CreateTimer(lua_State *pState) {
+	SCRIPT_CALLBACK(Invoker,invoker)
+		if (SCRIPT_NEXT_TYPE != LUA_TFUNCTION)
+			SCRIPT_ERROR("Callback function argument missing")
+		else {
+			lua_pushvalue(pState, ++__args);
+			UInt32 timeout(SCRIPT_READ_UINT(0));
+			LUATimer* pTimer(new LUATimer(invoker.timer, pState));
+			SCRIPT_NEW_OBJECT(LUATimer, LUATimer, pTimer)
+			if (timeout)
+				pTimer->set(pState, -1, timeout);
+		}
+	SCRIPT_CALLBACK_RETURN
+}
+
 int	LUAInvoker::Md5(lua_State *pState) {
 	SCRIPT_CALLBACK(Invoker,invoker)
 		while(SCRIPT_CAN_READ) {
@@ -219,6 +237,37 @@ int	LUAInvoker::Sha256(lua_State *pState) {
 	SCRIPT_CALLBACK_RETURN
 }
 
+int	LUAInvoker::Resolve(lua_State *pState) {
+	SCRIPT_CALLBACK(Invoker,invoker)
+		const char* host = SCRIPT_READ_STRING(NULL);
+		if (!host)
+			SCRIPT_ERROR("Host name argument missing")
+		else if (SCRIPT_NEXT_TYPE != LUA_TFUNCTION)
+			SCRIPT_ERROR("Callback function argument missing")
+		else {
+			lua_pushvalue(pState, ++__args);
+			int reference = luaL_ref(pState, LUA_REGISTRYINDEX);
+			// called immediately if cached, otherwise later by the server thread
+			invoker.resolver.resolve(host, [pState, reference](const Exception& ex, const HostEntry& entry) {
+				SCRIPT_BEGIN(pState)
+					SCRIPT_REFERENCE_FUNCTION_BEGIN(reference)
+						lua_newtable(__pState);
+						int index(0);
+						for (const IPAddress& address : entry.addresses()) {
+							SCRIPT_WRITE_STRING(address.toString().c_str())
+							lua_rawseti(__pState, -2, ++index);
+						}
+						if (ex)
+							SCRIPT_WRITE_STRING(ex.error().c_str())
+						SCRIPT_FUNCTION_CALL
+					SCRIPT_FUNCTION_END
+					luaL_unref(__pState, LUA_REGISTRYINDEX, reference);
+				SCRIPT_END
+			});
+		}
+	SCRIPT_CALLBACK_RETURN
+}
+
 int	LUAInvoker::ToAMF0(lua_State *pState) {
 	SCRIPT_CALLBACK(Invoker,invoker)
 		AMFWriter writer(invoker.poolBuffers);
@@ -302,6 +351,29 @@ int LUAInvoker::Get(lua_State *pState) {
 			Script::Collection(pState, 1, "groups", invoker.groups.count());
 		} else if (strcmp(name, "publications") == 0) {
 			Script::Collection(pState, 1, "publications", invoker.publications.count());
+		} else if (strcmp(name, "protocols") == 0) {
+			// statistics by protocol name, cumulated since the start
+			lua_newtable(pState);
+			for (const unique_ptr<Protocol>& pProtocol : ((MonaServer&)invoker).protocols()) {
+				lua_newtable(pState);
+				const TCProtocol* pTCProtocol = dynamic_cast<const TCProtocol*>(pProtocol.get());
+				if (pTCProtocol) {
+					lua_pushnumber(pState, (lua_Number)pTCProtocol->accepted());
+					lua_setfield(pState, -2, "accepted");
+					lua_pushnumber(pState, (lua_Number)pTCProtocol->dropped());
+					lua_setfield(pState, -2, "dropped");
+				}
+				const RTMFProtocol* pRTMFProtocol = dynamic_cast<const RTMFProtocol*>(pProtocol.get());
+				if (pRTMFProtocol) {
+					lua_pushnumber(pState, (lua_Number)pRTMFProtocol->sentDatagrams());
+					lua_setfield(pState, -2, "sent");
+					lua_pushnumber(pState, (lua_Number)pRTMFProtocol->sendCalls());
+					lua_setfield(pState, -2, "sendCalls");
+					lua_pushnumber(pState, pRTMFProtocol->sentDatagrams() ? (lua_Number)(pRTMFProtocol->sendLatency() / pRTMFProtocol->sentDatagrams()) : 0);
+					lua_setfield(pState, -2, "sendLatency");
+				}
+				lua_setfield(pState, -2, pProtocol->name.c_str());
+			}
 		} else if (strcmp(name, "publish") == 0) {
 			SCRIPT_WRITE_FUNCTION(&LUAInvoker::Publish)
 		} else if (strcmp(name, "toAMF") == 0) {
@@ -330,6 +402,10 @@ int LUAInvoker::Get(lua_State *pState) {
 			SCRIPT_WRITE_FUNCTION(&LUAInvoker::CreateTCPClient)
 		} else if(strcmp(name,"createTCPServer")==0) {
 			SCRIPT_WRITE_FUNCTION(&LUAInvoker::CreateTCPServer)
+		} else if (strcmp(name, "createTimer") == 0) {
+			SCRIPT_WRITE_FUNCTION(&LUAInvoker::CreateTimer)
+		} else if (strcmp(name, "resolve") == 0) {
+			SCRIPT_WRITE_FUNCTION(&LUAInvoker::Resolve)
 		} else if(strcmp(name,"md5")==0) {
 			SCRIPT_WRITE_FUNCTION(&LUAInvoker::Md5)
 		} else if(strcmp(name,"sha256")==0) {
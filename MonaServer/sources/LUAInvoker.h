@@ -78,6 +78,8 @@ private:
 	static int  CreateUDPSocket(lua_State *pState);
 	static int	CreateTCPServer(lua_State *pState);
 	static int	CreateTCPClient(lua_State *pState);
+	static int	CreateTimer(lua_State *pState);
+	static int	Resolve(lua_State *pState);
 	static int	Publish(lua_State *pState);
 	static int	JoinGroup(lua_State *pState);
 	static int	AbsolutePath(lua_State *pState);
@@ -42,6 +42,14 @@ int LUAListener::Get(lua_State *pState) {
 			SCRIPT_ADD_OBJECT(QualityOfService, LUAQualityOfService, listener.dataQOS())
 		} else if(strcmp(name,"publication")==0) {
 			SCRIPT_ADD_OBJECT(Publication, LUAPublication<>, listener.publication);
+		} else if(strcmp(name,"droppedFrames")==0) {
+			SCRIPT_WRITE_NUMBER(listener.droppedFrames());
+		} else if(strcmp(name,"congestedFrames")==0) {
+			SCRIPT_WRITE_NUMBER(listener.congestedFrames());
+		} else if(strcmp(name,"peakQueueing")==0) {
+			SCRIPT_WRITE_NUMBER(listener.peakQueueing());
+		} else if(strcmp(name,"firstFrameTime")==0) {
+			SCRIPT_WRITE_NUMBER(listener.firstFrameTime());
 		} else if(strcmp(name,"receiveAudio")==0) {
 			SCRIPT_WRITE_BOOL(listener.receiveAudio);
 		} else if(strcmp(name,"receiveVideo")==0) {
@@ -73,6 +73,17 @@ public:
 					Script::Collection(pState, 1, "listeners", pPublication->listeners.count());
 				} else if(strcmp(name,"droppedFrames")==0) {
 					SCRIPT_WRITE_NUMBER(pPublication->droppedFrames())
+				} else if(strcmp(name,"gopCacheSize")==0) {
+					SCRIPT_WRITE_NUMBER(pPublication->gopCacheSize())
+				} else if(strcmp(name,"gopCacheDuration")==0) {
+					SCRIPT_WRITE_NUMBER(pPublication->gopCacheDuration())
+				} else if(strcmp(name,"gopCached")==0) {
+					SCRIPT_WRITE_NUMBER(pPublication->gopCached())
+				} else if(strcmp(name,"timeShiftDuration")==0) {
+					SCRIPT_WRITE_NUMBER(pPublication->timeShift().duration())
+				} else if(strcmp(name,"recording")==0) {
+					if (pPublication->recorder() && pPublication->recorder()->recording())
+						SCRIPT_WRITE_STRING(pPublication->recorder()->file().c_str())
 				} else if(strcmp(name,"audioQOS")==0) {
 					SCRIPT_ADD_OBJECT(Mona::QualityOfService, LUAQualityOfService, pPublication->audioQOS())
 				} else if(strcmp(name,"videoQOS")==0) {
@@ -96,7 +107,14 @@ public:
 
 	static int Set(lua_State *pState) {
 		SCRIPT_CALLBACK(PublicationType, publication)
-			lua_rawset(pState, 1); // consumes key and value
+			const char* name = SCRIPT_READ_STRING("");
+			Mona::Publication* pPublication = Publication(publication);
+			if (pPublication && strcmp(name, "gopCacheSize") == 0)
+				pPublication->setGOPCache(SCRIPT_READ_UINT(0), pPublication->gopCacheDuration());
+			else if (pPublication && strcmp(name, "gopCacheDuration") == 0)
+				pPublication->setGOPCache(pPublication->gopCacheSize(), SCRIPT_READ_UINT(0));
+			else
+				lua_rawset(pState, 1); // consumes key and value
 		SCRIPT_CALLBACK_RETURN
 	}
 
@@ -0,0 +1,106 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#include "LUATimer.h"
+
+using namespace std;
+using namespace Mona;
+
+
+LUATimer::LUATimer(const Timer& timer, lua_State* pState) : _timer(timer), _pState(pState), _function(luaL_ref(pState, LUA_REGISTRYINDEX)), _self(LUA_NOREF), _running(false), _raising(false), _reset(false),
+	_onTimer([this](UInt32 delay) {
+		UInt32 timeout(0);
+		_raising = true;
+		_reset = false;
+		SCRIPT_BEGIN(_pState)
+			SCRIPT_REFERENCE_FUNCTION_BEGIN(_function)
+				SCRIPT_WRITE_NUMBER(delay)
+				SCRIPT_FUNCTION_CALL
+					if (SCRIPT_CAN_READ)
+						timeout = SCRIPT_READ_UINT(0);
+			SCRIPT_FUNCTION_END
+		SCRIPT_END
+		_raising = false;
+		if (!_reset)
+			_running = timeout>0;
+		if (!_running)
+			release(); // one-shot done, can be collected now
+		return timeout;
+	}) {
+}
+
+void LUATimer::set(lua_State* pState, int index, UInt32 timeout) {
+	_timer.set(_onTimer, timeout);
+	_running = timeout>0;
+	if (_raising)
+		_reset = true;
+	if (!_running) {
+		if (!_raising) // else released at the end of the callback
+			release();
+		return;
+	}
+	if (_self != LUA_NOREF)
+		return;
+	// pins the object, a script can forget a running timer
+	lua_pushvalue(pState, index);
+	_self = luaL_ref(pState, LUA_REGISTRYINDEX);
+}
+
+void LUATimer::release() {
+	if (_self == LUA_NOREF)
+		return;
+	luaL_unref(_pState, LUA_REGISTRYINDEX, _self);
+	_self = LUA_NOREF;
+}
+
+int	LUATimer::Destroy(lua_State* pState) {
+	SCRIPT_DESTRUCTOR_CALLBACK(LUATimer,timer)
+		luaL_unref(pState, LUA_REGISTRYINDEX, timer._function);
+		delete &timer;
+	SCRIPT_CALLBACK_RETURN
+}
+
+int	LUATimer::SetTimeout(lua_State* pState) {
+	SCRIPT_CALLBACK(LUATimer,timer)
+		timer.set(pState, 1, SCRIPT_READ_UINT(0));
+	SCRIPT_CALLBACK_RETURN
+}
+
+int	LUATimer::Stop(lua_State* pState) {
+	SCRIPT_CALLBACK(LUATimer,timer)
+		timer.set(pState, 1, 0);
+	SCRIPT_CALLBACK_RETURN
+}
+
+int LUATimer::Get(lua_State* pState) {
+	SCRIPT_CALLBACK(LUATimer,timer)
+		const char* name = SCRIPT_READ_STRING("");
+		if(strcmp(name,"set")==0) {
+			SCRIPT_WRITE_FUNCTION(&LUATimer::SetTimeout)
+		} else if (strcmp(name, "stop") == 0) {
+			SCRIPT_WRITE_FUNCTION(&LUATimer::Stop)
+		} else if (strcmp(name, "running") == 0)
+			SCRIPT_WRITE_BOOL(timer._running)
+	SCRIPT_CALLBACK_RETURN
+}
+
+int LUATimer::Set(lua_State* pState) {
+	lua_rawset(pState,1); // consumes key and value
+	return 0;
+}
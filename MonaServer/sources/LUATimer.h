@@ -0,0 +1,54 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#pragma once
+
+#include "Script.h"
+#include "Mona/Timer.h"
+
+
+class LUATimer : public virtual Mona::Object {
+public:
+	// takes the callback function on the top of the stack
+	LUATimer(const Mona::Timer& timer, lua_State* pState);
+
+	// timeout in ms, 0 stops it, the object at index is kept alive while running
+	void	set(lua_State* pState, int index, Mona::UInt32 timeout);
+
+	static int Get(lua_State* pState);
+	static int Set(lua_State* pState);
+
+	static void Init(lua_State *pState, LUATimer& timer) {}
+	static int	Destroy(lua_State* pState);
+
+private:
+	void	release();
+
+	static int	SetTimeout(lua_State* pState);
+	static int	Stop(lua_State* pState);
+
+	const Mona::Timer&		_timer;
+	lua_State*				_pState;
+	int						_function;
+	int						_self;
+	bool					_running;
+	bool					_raising;
+	bool					_reset; // set or stopped by its own callback
+	Mona::Timer::OnTimer	_onTimer;
+};
@@ -35,11 +35,24 @@ using namespace std;
 using namespace Mona;
 
 
+static void ConfigAffinity(MapParameters& parameters, const char* name, vector<UInt16>& processors) {
+	string value;
+	if (!parameters.getString(name, value))
+		return;
+	Exception ex;
+	if (!Util::ParseProcessors(ex, value, processors)) {
+		WARN("Invalid ", name, " value, ", ex.error());
+		processors.clear();
+	} else if (!processors.empty() && processors.back() >= Util::ProcessorCount())
+		WARN(name, ", processor ", processors.back(), " doesn't exist");
+}
+
+
 const string MonaServer::WWWPath("./");
 const string MonaServer::DataPath("./");
 
-MonaServer::MonaServer(TerminateSignal& terminateSignal, UInt32 socketBufferSize, UInt16 threads, UInt16 serversPort, const string& serversTarget) :
-	Server(socketBufferSize, threads), servers(serversPort, sockets, serversTarget), _firstData(true),_data(this->poolBuffers),_terminateSignal(terminateSignal) {
+MonaServer::MonaServer(TerminateSignal& terminateSignal, UInt32 socketBufferSize, UInt16 threads, UInt16 reactors, UInt16 serversPort, const string& serversTarget) :
+	Server(socketBufferSize, threads, reactors), servers(serversPort, sockets, serversTarget), _firstData(true),_data(this->poolBuffers),_terminateSignal(terminateSignal) {
 
 
 	onServerConnection = [this](ServerConnection& server) {
@@ -135,6 +148,33 @@ bool MonaServer::start(MapParameters& parameters) {
 
 	ServerParams	params;
 
+	parameters.getNumber("buffersTrimDelay", params.buffersTrimDelay);
+	parameters.getNumber("buffersTrimMaximum", params.buffersTrimMaximum);
+	parameters.getNumber("dnsTTL", params.dnsTTL);
+	parameters.getNumber("dnsNegativeTTL", params.dnsNegativeTTL);
+	parameters.getString("dnsHosts", params.dnsHosts);
+	parameters.getNumber("gopCacheSize", params.gopCacheSize);
+	parameters.getNumber("gopCacheDuration", params.gopCacheDuration);
+	parameters.getNumber("timeShiftWindow", params.timeShiftWindow);
+	parameters.getNumber("timeShiftSize", params.timeShiftSize);
+	parameters.getString("timeShiftPath", params.timeShiftPath);
+	// recording writes on the disk, so it's disabled until a recordPath is configured
+	parameters.getString("recordPath", params.recordPath);
+	parameters.getNumber("recordBufferSize", params.recordBufferSize);
+	parameters.getNumber("recordQueueing", params.recordQueueing);
+	parameters.getNumber("recordSync", params.recordSync);
+	parameters.getNumber("recordFileSize", params.recordFileSize);
+	parameters.getNumber("recordFileDuration", params.recordFileDuration);
+	params.vodPath = params.recordPath.empty() ? (pathApp + "records") : params.recordPath;
+	parameters.getString("vodPath", params.vodPath);
+
+	// threads placement
+	ConfigAffinity(parameters, "affinity.server", params.serverAffinity);
+	ConfigAffinity(parameters, "affinity.reactors", params.reactorsAffinity);
+	ConfigAffinity(parameters, "affinity.workers", params.workersAffinity);
+	ConfigAffinity(parameters, "affinity.background", params.backgroundAffinity);
+	_data.setAffinity(params.backgroundAffinity);
+
 	// RTMFP
 	parameters.getNumber("RTMFP.keepAliveServer",(double&)params.RTMFP.keepAliveServer);
 	if (params.RTMFP.keepAliveServer < 5) {
@@ -149,12 +189,28 @@ bool MonaServer::start(MapParameters& parameters) {
 	CONFIG_PROTOCOL_NUMBER(RTMFP, port);
 	CONFIG_PROTOCOL_NUMBER(RTMFP, keepAliveServer);
 	CONFIG_PROTOCOL_NUMBER(RTMFP, keepAlivePeer);
+	UInt32 shards(params.RTMFP.shards);
+	parameters.getNumber("RTMFP.shards", shards);
+	if (shards > 0xFF) {
+		WARN("Value of RTMFP.shards can't be more than 255 sockets")
+		shards = 0xFF;
+	}
+	params.RTMFP.shards = (UInt8)shards;
+	parameters.setNumber("RTMFP.shards", params.RTMFP.shards);
 
 	// RTMP
 	CONFIG_PROTOCOL_NUMBER(RTMP, port);
+	CONFIG_PROTOCOL_NUMBER(RTMP, backlog);
+	CONFIG_PROTOCOL_NUMBER(RTMP, sendHighWatermark);
+	CONFIG_PROTOCOL_NUMBER(RTMP, sendLowWatermark);
 
 	// WebSocket
 	CONFIG_PROTOCOL_NUMBER(HTTP, port);
+	CONFIG_PROTOCOL_NUMBER(HTTP, backlog);
+	CONFIG_PROTOCOL_NUMBER(HTTP, sendHighWatermark);
+	CONFIG_PROTOCOL_NUMBER(HTTP, sendLowWatermark);
+	CONFIG_PROTOCOL_NUMBER(HTTP, cacheSize);
+	CONFIG_PROTOCOL_NUMBER(HTTP, cacheFileSize);
 
 	createParametersCollection("m.c", parameters);
 	createParametersCollection("m.e", Util::Environment());
@@ -610,6 +666,25 @@ bool MonaServer::onPublish(Client& client,const Publication& publication,string&
 	return result;
 }
 
+bool MonaServer::onRecord(Client& client,const Publication& publication,string& error) {
+	if (client == this->id)
+		return true;
+	bool result=true;
+	SCRIPT_BEGIN(openService(client))
+		SCRIPT_MEMBER_FUNCTION_BEGIN(Client,client,"onRecord")
+			SCRIPT_ADD_OBJECT(Publication, LUAPublication<>, publication)
+			SCRIPT_FUNCTION_CALL
+			if(SCRIPT_CAN_READ)
+				result = SCRIPT_READ_BOOL(true);
+		SCRIPT_FUNCTION_END
+		if(SCRIPT_LAST_ERROR) {
+			error = SCRIPT_LAST_ERROR;
+			result = false;
+		}
+	SCRIPT_END
+	return result;
+}
+
 void MonaServer::onUnpublish(Client& client,const Publication& publication) {
 	if(client != this->id) {
 		SCRIPT_BEGIN(openService(client))
@@ -28,7 +28,7 @@ This file is a part of Mona.
 
 class MonaServer : public Mona::Server, private ServiceHandler, private Mona::DatabaseLoader {
 public:
-	MonaServer(Mona::TerminateSignal& terminateSignal, Mona::UInt32 socketBufferSize, Mona::UInt16 threads, Mona::UInt16 serversPort, const std::string& serversTarget);
+	MonaServer(Mona::TerminateSignal& terminateSignal, Mona::UInt32 socketBufferSize, Mona::UInt16 threads, Mona::UInt16 reactors, Mona::UInt16 serversPort, const std::string& serversTarget);
 	~MonaServer();
 
 	static const std::string				WWWPath;
@@ -73,6 +73,7 @@ private:
 
 	bool					onPublish(Mona::Client& client,const Mona::Publication& publication,std::string& error);
 	void					onUnpublish(Mona::Client& client,const Mona::Publication& publication);
+	bool					onRecord(Mona::Client& client,const Mona::Publication& publication,std::string& error);
 
 	void					onAudioPacket(Mona::Client& client, const Mona::Publication& publication, Mona::UInt32 time, Mona::PacketReader& packet);
 	void					onVideoPacket(Mona::Client& client, const Mona::Publication& publication, Mona::UInt32 time, Mona::PacketReader& packet);
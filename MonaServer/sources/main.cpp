@@ -33,14 +33,15 @@ private:
 	int main(TerminateSignal& terminateSignal) {
 		
 		// starts the server
-		UInt16 threads(0),serversPort(0);
+		UInt16 threads(0),reactors(1),serversPort(0);
 		UInt32 socketBufferSize(0);
 		getNumber("socketBufferSize", socketBufferSize);
 		getNumber("threads", threads);
+		getNumber("reactors", reactors);
 		string serversTargets;
 		getNumber("servers.port", serversPort);
 		getString("servers.targets", serversTargets);
-		MonaServer server(terminateSignal, socketBufferSize, threads, serversPort, serversTargets);
+		MonaServer server(terminateSignal, socketBufferSize, threads, reactors, serversPort, serversTargets);
 		if (server.start(*this)) {
 			terminateSignal.wait();
 			// Stop the server
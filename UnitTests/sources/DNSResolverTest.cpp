@@ -0,0 +1,88 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#include "Test.h"
+#include "Mona/DNSResolver.h"
+#include "Mona/DNS.h"
+#include "Mona/FileSystem.h"
+#include <fstream>
+
+using namespace std;
+using namespace Mona;
+
+
+ADD_TEST(DNSResolverTest, Resolve) {
+	DNSResolver resolver;
+	Exception ex;
+	bool called(false);
+
+	// not started, fails immediately
+	CHECK(resolver.resolve("mona.test", [&called](const Exception& ex, const HostEntry& host) { called = true; CHECK(ex && host.addresses().empty()); }) && called);
+
+	CHECK(resolver.start(ex) && !ex);
+
+	// IP address
+	called = false;
+	CHECK(resolver.resolve("1.2.3.4", [&called](const Exception& ex, const HostEntry& host) {
+		called = true;
+		CHECK(!ex && host.addresses().size() == 1 && host.addresses().front().toString() == "1.2.3.4");
+	}) && called);
+
+	// hosts file entries, answered immediately
+	{
+		ofstream hosts("DNSResolverTest.hosts");
+		hosts << "# comment" << endl << "1.2.3.4\tmona.test alias.test # comment" << endl << "::1 mona.test" << endl;
+	}
+	CHECK(resolver.loadHosts(ex, "DNSResolverTest.hosts") && !ex);
+	CHECK(FileSystem::Remove("DNSResolverTest.hosts"));
+	called = false;
+	CHECK(resolver.resolve("Alias.Test", [&called](const Exception& ex, const HostEntry& host) {
+		called = true;
+		CHECK(!ex && host.name() == "mona.test" && host.aliases().size() == 1 && host.addresses().size() == 2);
+		CHECK(host.addresses()[0].toString() == "1.2.3.4" && host.addresses()[1] == IPAddress::Loopback(IPAddress::IPv6));
+	}) && called);
+	resolver.addHost("other.test", IPAddress::Loopback());
+	called = false;
+	CHECK(resolver.resolve("other.test", [&called](const Exception& ex, const HostEntry& host) { called = true; CHECK(!ex && host.addresses().size() == 1); }) && called);
+
+	// asynchronous resolution by the resolver thread (this host name), the second request shares the query or hits the cache
+	string name;
+	CHECK(DNS::HostName(ex, name) && !ex);
+	Signal signal(false);
+	UInt8 count(0);
+	bool success(false);
+	DNSResolver::OnResolved onResolved([&](const Exception& ex, const HostEntry& host) {
+		if (++count == 1)
+			success = !ex;
+		CHECK(success == !ex && success == !host.addresses().empty());
+		if (count == 2)
+			signal.set();
+	});
+	CHECK(!resolver.resolve(name, onResolved));
+	resolver.resolve(name, onResolved);
+	CHECK(signal.wait(30000) && count == 2);
+
+	// cached now, whatever the result
+	CHECK(resolver.cached() == 1);
+	CHECK(resolver.resolve(name, onResolved) && count == 3);
+	resolver.clearCache();
+	CHECK(resolver.cached() == 0);
+
+	resolver.stop();
+}
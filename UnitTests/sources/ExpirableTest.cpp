@@ -19,6 +19,7 @@ This file is a part of Mona.
 
 #include "Test.h"
 #include "Mona/Expirable.h"
+#include <thread>
 
 using namespace std;
 using namespace Mona;
@@ -42,14 +43,40 @@ ADD_TEST(ExpirableTest, Expire) {
 	pObject->shareThis(expirable);
 	CHECK(pObject->isOwner());
 	{
-		unique_lock<mutex> lock;
+		Expirable<ExpirableObject>::Lock lock;
 		ExpirableObject* pObject = expirable.safeThis(lock);
 		CHECK(pObject)
 	}
 	delete pObject;
 
-	unique_lock<mutex> lock;
+	Expirable<ExpirableObject>::Lock lock;
 	pObject = expirable.safeThis(lock);
 	CHECK(!pObject)
 }
 
+
+ADD_TEST(ExpirableTest, Threads) {
+	ExpirableObject* pObject = new ExpirableObject();
+	Expirable<ExpirableObject> expirable;
+	pObject->shareThis(expirable);
+
+	atomic<bool> inside(false);
+	atomic<bool> deleted(false);
+	thread reader([&]() {
+		for (;;) {
+			Expirable<ExpirableObject>::Lock lock;
+			ExpirableObject* pObject = expirable.safeThis(lock);
+			if (!pObject)
+				break;
+			inside = true;
+			// the owner can't be deleted while it's used here
+			this_thread::sleep_for(chrono::milliseconds(1));
+			CHECK(!deleted);
+		}
+	});
+	while (!inside)
+		this_thread::yield();
+	delete pObject; // waits the end of the reader
+	deleted = true;
+	reader.join();
+}
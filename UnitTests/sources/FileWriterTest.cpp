@@ -0,0 +1,83 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#include "Test.h"
+#include "Mona/FileWriter.h"
+#include "Mona/FileSystem.h"
+#include <fstream>
+
+using namespace std;
+using namespace Mona;
+
+static PoolBuffers	poolBuffers;
+
+static bool Write(FileWriter& writer, const shared_ptr<FileWriter::File>& pFile, const char* value) {
+	PoolBuffer pBuffer(poolBuffers, strlen(value));
+	memcpy(pBuffer->data(), value, pBuffer->size());
+	return writer.write(pFile, pBuffer) && pBuffer.empty();
+}
+
+static string Read(const char* path) {
+	ifstream file(path, ios::in | ios::binary);
+	return string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+}
+
+ADD_TEST(FileWriterTest, Write) {
+	Exception ex;
+	FileWriter writer(poolBuffers);
+	writer.setSync(FileWriter::SYNC_ALWAYS);
+
+	shared_ptr<FileWriter::File> pFile(writer.open(ex, "FileWriterTest.bin"));
+	CHECK(pFile && !ex);
+	CHECK(Write(writer, pFile, "Mona") && Write(writer, pFile, "Server"));
+	writer.close(pFile);
+	writer.stop(); // flush
+	CHECK(!pFile->failed() && writer.queueing() == 0 && Read("FileWriterTest.bin") == "MonaServer");
+
+	// append restarts the thread
+	pFile = writer.open(ex, "FileWriterTest.bin", true);
+	CHECK(pFile && !ex);
+	CHECK(Write(writer, pFile, "!"));
+	writer.close(pFile);
+	writer.stop();
+	CHECK(Read("FileWriterTest.bin") == "MonaServer!");
+
+	// truncate
+	pFile = writer.open(ex, "FileWriterTest.bin");
+	CHECK(Write(writer, pFile, "Mona"));
+	writer.close(pFile);
+	writer.stop();
+	CHECK(Read("FileWriterTest.bin") == "Mona");
+	CHECK(FileSystem::Remove("FileWriterTest.bin"));
+}
+
+ADD_TEST(FileWriterTest, Queueing) {
+	Exception ex;
+	FileWriter writer(poolBuffers);
+	writer.setQueueing(2);
+
+	shared_ptr<FileWriter::File> pFile(writer.open(ex, "FileWriterTest.bin"));
+	CHECK(pFile && !ex);
+	CHECK(!Write(writer, pFile, "Mona") && writer.dropped() == 1);
+	CHECK(Write(writer, pFile, "M"));
+	writer.close(pFile);
+	writer.stop();
+	CHECK(writer.dropped() == 1 && Read("FileWriterTest.bin") == "M");
+	CHECK(FileSystem::Remove("FileWriterTest.bin"));
+}
@@ -0,0 +1,77 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+
+#include "Test.h"
+#include "Mona/MPMCQueue.h"
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Mona;
+
+
+ADD_TEST(MPMCQueueTest, PushPop) {
+	MPMCQueue<UInt32> queue(3);
+	CHECK(queue.capacity == 4);
+	UInt32 value(0);
+	CHECK(queue.empty() && !queue.pop(value));
+	for (UInt32 i = 1; i <= 4; ++i)
+		CHECK(queue.push(i));
+	CHECK(!queue.push(5) && queue.size() == 4);
+	CHECK(queue.pop(value) && value == 1 && queue.push(5));
+	for (UInt32 i = 2; i <= 5; ++i)
+		CHECK(queue.pop(value) && value == i);
+	CHECK(queue.empty() && !queue.pop(value));
+}
+
+ADD_TEST(MPMCQueueTest, ProducersConsumers) {
+	MPMCQueue<UInt32> queue(64);
+	const UInt32 producers(2), consumers(2), count(100000);
+	vector<thread> threads;
+	for (UInt32 i = 0; i < producers; ++i) {
+		threads.emplace_back([&queue, i, count]() {
+			for (UInt32 j = 0; j < count; ++j) {
+				while (!queue.push(i*count + j))
+					this_thread::yield();
+			}
+		});
+	}
+	// each value must be received one time, and in order for a same producer and a same consumer
+	vector<atomic<UInt32>> received(producers*count);
+	for (UInt32 i = 0; i < consumers; ++i) {
+		threads.emplace_back([&queue, &received, producers, count]() {
+			vector<Int64> lasts(producers, -1);
+			UInt32 value;
+			for (UInt32 j = 0; j < count; ++j) {
+				while (!queue.pop(value))
+					this_thread::yield();
+				UInt32 producer(value / count);
+				CHECK(Int64(value%count) > lasts[producer]);
+				lasts[producer] = value%count;
+				++received[value];
+			}
+		});
+	}
+	for (thread& thread : threads)
+		thread.join();
+	CHECK(queue.empty());
+	for (atomic<UInt32>& value : received)
+		CHECK(value == 1);
+}
@@ -0,0 +1,96 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+
+#include "Test.h"
+#include "Mona/MPSCQueue.h"
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Mona;
+
+
+ADD_TEST(MPSCQueueTest, PushPop) {
+	MPSCQueue<UInt32> queue;
+	UInt32 value(0);
+	CHECK(queue.empty() && !queue.pop(value));
+	UInt32 previousSize(1);
+	CHECK(queue.push(1, &previousSize) && previousSize == 0);
+	CHECK(queue.push(2, &previousSize) && previousSize == 1);
+	CHECK(queue.push(3) && queue.size() == 3);
+	CHECK(queue.pop(value) && value == 1);
+	CHECK(queue.pop(value) && value == 2);
+	CHECK(queue.pop(value) && value == 3);
+	CHECK(queue.empty() && !queue.pop(value));
+}
+
+ADD_TEST(MPSCQueueTest, Capacity) {
+	MPSCQueue<shared_ptr<UInt32>> queue(2);
+	shared_ptr<UInt32> pValue(new UInt32(7));
+	CHECK(queue.push(pValue) && queue.push(pValue));
+	CHECK(!queue.push(pValue) && queue.size() == 2);
+	CHECK(pValue.use_count() == 3);
+	CHECK(queue.pop(pValue) && *pValue == 7 && queue.push(pValue));
+	queue.clear();
+	CHECK(queue.empty() && pValue.use_count() == 1);
+}
+
+ADD_TEST(MPSCQueueTest, Producers) {
+	MPSCQueue<UInt32> queue;
+	const UInt32 producers(4), count(100000);
+	vector<thread> threads;
+	for (UInt32 i = 0; i < producers; ++i) {
+		threads.emplace_back([&queue, i, count]() {
+			for (UInt32 j = 0; j < count; ++j)
+				queue.push(i*count + j);
+		});
+	}
+	// order must be kept for each producer
+	vector<UInt32> nexts(producers, 0);
+	UInt32 value, received(0);
+	while (received < producers*count) {
+		if (!queue.pop(value))
+			continue;
+		UInt32 producer(value / count);
+		CHECK(value%count == nexts[producer]++);
+		++received;
+	}
+	for (thread& thread : threads)
+		thread.join();
+	CHECK(queue.empty());
+}
+
+ADD_TEST(MPSCQueueTest, Recycling) {
+	// more elements than the nodes cache, the nodes recycled must be relinked cleanly
+	MPSCQueue<shared_ptr<UInt32>> queue;
+	shared_ptr<UInt32> pValue(new UInt32(0));
+	for (UInt32 round = 0; round < 3; ++round) {
+		for (UInt32 i = 0; i < MPSCQueue<shared_ptr<UInt32>>::NODES_CACHE + 10; ++i)
+			CHECK(queue.push(pValue));
+		CHECK(pValue.use_count() == MPSCQueue<shared_ptr<UInt32>>::NODES_CACHE + 11);
+		shared_ptr<UInt32> pPopped;
+		UInt32 count(0);
+		while (queue.pop(pPopped))
+			++count;
+		CHECK(count == MPSCQueue<shared_ptr<UInt32>>::NODES_CACHE + 10);
+		pPopped.reset();
+		CHECK(queue.empty() && pValue.use_count() == 1);
+	}
+}
@@ -0,0 +1,58 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#include "Test.h"
+#include "Mona/MappedFile.h"
+#include "Mona/FileSystem.h"
+#include "Mona/String.h"
+#include <fstream>
+
+using namespace std;
+using namespace Mona;
+
+
+ADD_TEST(MappedFileTest, ReadWrite) {
+	Exception ex;
+	MappedFile file;
+
+	CHECK(!file.open(ex, "MappedFileTest.unknown") && ex && !file.opened());
+	ex.set(Exception::NIL);
+
+	// written through the memory
+	CHECK(file.open(ex, "MappedFileTest.bin", 8192) && !ex);
+	CHECK(file.opened() && file.writable() && file.size() == 8192);
+	CHECK(FileSystem::GetSize(ex, "MappedFileTest.bin") == 8192 && !ex);
+	memset(file.data(), 'a', file.size());
+	memcpy(file.data() + 4096, EXPAND_DATA_SIZE("Mona"));
+	file.close();
+	CHECK(!file.opened() && file.size() == 0);
+
+	// read-only
+	CHECK(file.open(ex, "MappedFileTest.bin") && !ex);
+	CHECK(!file.writable() && file.size() == 8192);
+	CHECK(file.data()[0] == 'a' && file.data()[8191] == 'a' && memcmp(file.data() + 4096, EXPAND_DATA_SIZE("Mona")) == 0);
+	file.close();
+
+	// empty file can't be mapped
+	{
+		ofstream empty("MappedFileTest.bin", ios::trunc);
+	}
+	CHECK(!file.open(ex, "MappedFileTest.bin") && ex && !file.opened());
+	CHECK(FileSystem::Remove("MappedFileTest.bin"));
+}
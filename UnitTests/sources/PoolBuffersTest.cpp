@@ -0,0 +1,126 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+
+#include "Test.h"
+#include "Mona/PoolBuffer.h"
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Mona;
+
+
+ADD_TEST(PoolBuffersTest, Classes) {
+	PoolBuffers poolBuffers;
+	Buffer* pBuffer(NULL);
+	{
+		PoolBuffer buffer(poolBuffers, 100);
+		CHECK(buffer->size() == 100 && buffer->capacity() == 256);
+		pBuffer = &*buffer;
+	}
+	CHECK(poolBuffers.available() == 1);
+	{
+		// reused, with the capacity of its class
+		PoolBuffer buffer(poolBuffers);
+		CHECK(&*buffer == pBuffer && buffer->size() == 0 && buffer->capacity() == 256);
+		PoolBuffer buffer2(poolBuffers, 1500);
+		CHECK(buffer2->capacity() == 1536);
+		// grown buffer goes in the class of its new capacity
+		buffer->resize(5000);
+		CHECK(buffer->capacity() == 8192);
+	}
+	CHECK(poolBuffers.available() == 2);
+	{
+		PoolBuffer buffer(poolBuffers, 4000);
+		CHECK(&*buffer == pBuffer && buffer->capacity() == 8192);
+		// too big for the pool
+		PoolBuffer buffer2(poolBuffers, 100000);
+		CHECK(buffer2->capacity() == 100000);
+	}
+	CHECK(poolBuffers.available() == 2);
+	poolBuffers.clear();
+	CHECK(poolBuffers.available() == 0);
+}
+
+ADD_TEST(PoolBuffersTest, Trimming) {
+	PoolBuffers poolBuffers;
+	poolBuffers.setTrimming(0, 32);
+	{
+		vector<PoolBuffer*> buffers;
+		for (UInt32 i = 0; i < 200; ++i) {
+			buffers.emplace_back(new PoolBuffer(poolBuffers));
+			(*buffers.back())->resize(10);
+		}
+		for (PoolBuffer* pBuffer : buffers)
+			delete pBuffer;
+	}
+	// 40 in the magazines of this thread (200-32*5), and just one full magazine kept in the depot
+	CHECK(poolBuffers.available() == 72);
+}
+
+ADD_TEST(PoolBuffersTest, Threads) {
+	PoolBuffers poolBuffers;
+	vector<thread> threads;
+	for (UInt32 i = 0; i < 4; ++i) {
+		threads.emplace_back([&poolBuffers]() {
+			for (UInt32 j = 0; j < 10000; ++j) {
+				PoolBuffer buffer(poolBuffers, j % 5000);
+				CHECK(buffer->size() == j % 5000);
+				buffer->data()[0] = 1;
+			}
+		});
+	}
+	for (thread& thread : threads)
+		thread.join();
+	CHECK(poolBuffers.available() > 0);
+}
+
+ADD_TEST(PoolBuffersTest, DepotTrimming) {
+	PoolBuffers poolBuffers;
+	poolBuffers.setTrimming(1);
+	{
+		vector<PoolBuffer*> buffers;
+		for (UInt32 i = 0; i < 200; ++i) {
+			buffers.emplace_back(new PoolBuffer(poolBuffers));
+			(*buffers.back())->resize(10);
+		}
+		for (PoolBuffer* pBuffer : buffers)
+			delete pBuffer;
+	}
+	// peak of 200 buffers, 5 full magazines in the depot
+	CHECK(poolBuffers.available() == 200);
+	this_thread::sleep_for(chrono::milliseconds(5));
+	poolBuffers.trim(); // starts a period
+	CHECK(poolBuffers.available() == 200);
+	{
+		// uses one magazine of the depot meanwhile
+		vector<PoolBuffer*> buffers;
+		for (UInt32 i = 0; i < 50; ++i) {
+			buffers.emplace_back(new PoolBuffer(poolBuffers));
+			(*buffers.back())->resize(10);
+		}
+		for (PoolBuffer* pBuffer : buffers)
+			delete pBuffer;
+	}
+	this_thread::sleep_for(chrono::milliseconds(5));
+	poolBuffers.trim();
+	// 4 magazines never used during the period are freed, the one reloaded is kept
+	CHECK(poolBuffers.available() == 72);
+}
@@ -0,0 +1,91 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#include "Test.h"
+#include "Mona/PoolObjects.h"
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Mona;
+
+namespace PoolObjectsTest {
+
+class Pooled : public PoolObject<Pooled>, virtual Object {
+public:
+	Pooled(UInt32 value=0) : value(value) {}
+	UInt32 value;
+};
+
+class Derived : public Pooled, virtual Object {
+public:
+	char more[64];
+};
+
+}
+using namespace PoolObjectsTest;
+
+
+ADD_TEST(PoolObjectsTest, New) {
+	Pooled* pObject(new Pooled(1));
+	delete pObject;
+	UInt64 recyclings(PoolObjects::Recyclings());
+	// same memory block recycled
+	Pooled* pObject2(new Pooled(2));
+	CHECK(pObject2 == pObject && pObject2->value == 2 && PoolObjects::Recyclings() == recyclings + 1);
+	delete pObject2;
+
+	// derived class has not the size of the pool, allocated as usual
+	UInt64 allocations(PoolObjects::Allocations());
+	Pooled* pDerived(new Derived());
+	CHECK(pDerived != pObject && PoolObjects::Allocations() == allocations + 1);
+	delete pDerived;
+}
+
+ADD_TEST(PoolObjectsTest, Shared) {
+	const void* pBlock(NULL);
+	{
+		shared_ptr<Pooled> pObject(PoolObjects::New<Pooled>(3));
+		CHECK(pObject->value == 3);
+		pBlock = pObject.get();
+	}
+	UInt64 allocations(PoolObjects::Allocations());
+	shared_ptr<Pooled> pObject(PoolObjects::New<Pooled>(4));
+	CHECK(pObject.get() == pBlock && pObject->value == 4 && PoolObjects::Allocations() == allocations);
+}
+
+ADD_TEST(PoolObjectsTest, Threads) {
+	// allocated by a thread, released by an other one
+	vector<Pooled*> objects;
+	for (UInt32 i = 0; i < 2000; ++i)
+		objects.emplace_back(new Pooled(i));
+	thread releaser([&objects]() {
+		for (Pooled* pObject : objects)
+			delete pObject;
+	});
+	releaser.join();
+	UInt64 allocations(PoolObjects::Allocations());
+	objects.clear();
+	for (UInt32 i = 0; i < PoolObjects::CAPACITY; ++i)
+		objects.emplace_back(new Pooled(i));
+	// the pool keeps until CAPACITY blocks
+	CHECK(PoolObjects::Allocations() == allocations);
+	for (Pooled* pObject : objects)
+		delete pObject;
+}
@@ -0,0 +1,101 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+
+#include "Test.h"
+#include "Mona/PoolThreads.h"
+#include "Mona/Signal.h"
+#include "Mona/Util.h"
+#include <thread>
+#include <vector>
+#include <functional>
+
+using namespace std;
+using namespace Mona;
+
+class Work : public WorkThread, virtual Object {
+public:
+	Work(const function<void()>& onRun) : WorkThread("Work"), _onRun(onRun) {}
+private:
+	bool run(Exception& ex) { _onRun(); return true; }
+	function<void()> _onRun;
+};
+
+static bool Wait(const function<bool()>& condition) {
+	for (UInt32 i = 0; i < 1000; ++i) {
+		if (condition())
+			return true;
+		this_thread::sleep_for(chrono::milliseconds(5));
+	}
+	return false;
+}
+
+
+ADD_TEST(PoolThreadsTest, Order) {
+	PoolThreads poolThreads(4);
+	Exception ex;
+	PoolThreads::Queue queue;
+	vector<UInt32> values;
+	atomic<UInt32> count(0);
+	for (UInt32 i = 0; i < 1000; ++i) {
+		CHECK(poolThreads.enqueue(ex, make_shared<Work>([&values, i]() { values.emplace_back(i); }), &queue) && !ex);
+		// unordered works meanwhile, to keep busy the other threads
+		CHECK(poolThreads.enqueue(ex, make_shared<Work>([&count]() { ++count; })) && !ex);
+	}
+	CHECK(Wait([&]() { return queue.size() == 0 && count == 1000; }));
+	CHECK(values.size() == 1000);
+	for (UInt32 i = 0; i < values.size(); ++i)
+		CHECK(values[i] == i);
+	poolThreads.join();
+	CHECK(poolThreads.executed() == 2000 && poolThreads.queueing() == 0);
+}
+
+ADD_TEST(PoolThreadsTest, Steal) {
+	PoolThreads poolThreads(2);
+	Exception ex;
+	Signal blocker;
+	atomic<UInt32> count(0);
+	// first thread blocked, its next work has to be stolen by the second thread
+	CHECK(poolThreads.enqueue(ex, make_shared<Work>([&blocker]() { blocker.wait(); })) && !ex);
+	CHECK(poolThreads.enqueue(ex, make_shared<Work>([&count]() { ++count; })) && !ex);
+	CHECK(poolThreads.enqueue(ex, make_shared<Work>([&count]() { ++count; })) && !ex);
+	CHECK(Wait([&count]() { return count == 2; }));
+	CHECK(poolThreads.stolen() >= 1);
+	blocker.set();
+	poolThreads.join();
+	CHECK(poolThreads.executed() == 3);
+}
+
+ADD_TEST(PoolThreadsTest, Affinity) {
+	PoolThreads poolThreads(2);
+	Exception ex;
+	UInt16 last(Util::ProcessorCount() - 1);
+	poolThreads.setAffinity(vector<UInt16>(1, last));
+	atomic<UInt32> count(0);
+	for (UInt8 i = 0; i < 10; ++i) {
+		CHECK(poolThreads.enqueue(ex, make_shared<Work>([&count, last]() {
+#if defined(__linux__)
+			CHECK(sched_getcpu() == last);
+#endif
+			++count;
+		})) && !ex);
+	}
+	CHECK(Wait([&count]() { return count == 10; }));
+	poolThreads.join();
+}
@@ -0,0 +1,81 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+#include "Test.h"
+#include "Mona/SharedBuffer.h"
+#include "Mona/MappedFile.h"
+#include "Mona/FileSystem.h"
+
+using namespace std;
+using namespace Mona;
+
+
+ADD_TEST(SharedBufferTest, Slices) {
+	PoolBuffers poolBuffers;
+	SharedBuffer nullBuffer;
+	CHECK(!nullBuffer && nullBuffer.empty() && !nullBuffer.data());
+
+	SharedBuffer buffer(poolBuffers, (const UInt8*)"0123456789", 10);
+	CHECK(buffer && buffer.size() == 10 && memcmp(buffer.data(), "0123456789", 10) == 0);
+
+	SharedBuffer slice(buffer.slice(2, 5));
+	CHECK(slice.size() == 5 && slice.data() == buffer.data() + 2);
+	slice = slice.slice(3);
+	CHECK(slice.size() == 2 && memcmp(slice.data(), "56", 2) == 0);
+	CHECK(buffer.slice(20).empty());
+}
+
+ADD_TEST(SharedBufferTest, Release) {
+	PoolBuffers poolBuffers;
+	{
+		PoolBuffer content(poolBuffers, 100);
+		const UInt8* data(content->data());
+		SharedBuffer buffer(content);
+		// content taken without copy
+		CHECK(content.empty() && buffer.data() == data && buffer.size() == 100);
+		SharedBuffer copy(buffer);
+		{
+			SharedBuffer slice(copy.slice(50));
+			buffer = SharedBuffer();
+			copy = SharedBuffer();
+			// the slice keeps the memory
+			CHECK(poolBuffers.available() == 0 && slice.data() == data + 50);
+		}
+		// the last reference gives back the memory to the pool
+		CHECK(poolBuffers.available() == 1);
+	}
+	CHECK(poolBuffers.available() == 1);
+}
+
+ADD_TEST(SharedBufferTest, Owner) {
+	Exception ex;
+	weak_ptr<MappedFile> pWeak;
+	{
+		shared_ptr<MappedFile> pFile(new MappedFile());
+		CHECK(pFile->open(ex, "SharedBufferTest.bin", 100) && !ex);
+		memcpy(pFile->data(), "0123456789", 10);
+		SharedBuffer slice(pFile, pFile->data() + 2, 5);
+		pWeak = pFile;
+		pFile.reset();
+		// the slice keeps the file mapped, without copy
+		CHECK(!pWeak.expired() && slice && slice.size() == 5 && memcmp(slice.data(), "23456", 5) == 0);
+	}
+	CHECK(pWeak.expired());
+	CHECK(FileSystem::Remove("SharedBufferTest.bin"));
+}
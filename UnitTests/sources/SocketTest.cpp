@@ -21,8 +21,12 @@ This file is a part of Mona.
 #include "Mona/TCPClient.h"
 #include "Mona/TCPServer.h"
 #include "Mona/UDPSocket.h"
+#include "Mona/TCPSender.h"
+#include "Mona/FileSystem.h"
 #include "Mona/Logs.h"
+#include <fstream>
 #include <list>
+#include <thread>
 
 using namespace std;
 using namespace Mona;
@@ -38,6 +42,14 @@ private:
 	std::mutex	_mutex;
 };
 
+class TCPFileSender : public TCPSender {
+public:
+	TCPFileSender(const string& path, UInt64 offset, UInt64 size) : TCPSender("TCPFileSender") {
+		Exception ex;
+		CHECK(shareFile(ex, path, offset, size) && !ex);
+	}
+};
+
 class TCPEchoClient : public TCPClient {
 public:
 	TCPEchoClient(const SocketManager& manager,bool parallel) : testDisconnection(false),TCPClient(manager),_mutex(!parallel),parallel(parallel) {}
@@ -59,8 +71,11 @@ public:
 		}
 		while(_event.wait(20000)) {
 			lock_guard<Mutex> lock(_mutex);
-			if (testDisconnection)
-				return !connected();
+			if (testDisconnection) {
+				if (connected())
+					continue; // event of a previous reception
+				return true;
+			}
 			if (_datas.empty())
 				return true;
 		}
@@ -76,6 +91,15 @@ public:
 		return send(ex, data, size);
 	}
 
+	bool echoFile(Exception& ex, const string& path, const UInt8* data, UInt32 offset, UInt32 size) {
+		{
+			lock_guard<Mutex> lock(_mutex);
+			_datas.emplace_back(size);
+			memcpy(_datas.back().data(), data + offset, size);
+		}
+		return send(ex, make_shared<TCPFileSender>(path, offset, size));
+	}
+
 private:
 	UInt32 onReception(PoolBuffer& pBuffer) {
 		lock_guard<Mutex> lock(_mutex);
@@ -95,7 +119,7 @@ private:
 	}
 	
 	deque<vector<UInt8>> _datas;
-	Event				_event;
+	Signal				_event;
 	Mutex				_mutex;
 };
 
@@ -190,7 +214,7 @@ private:
 
 	Mutex						_mutex;
 	std::deque<vector<UInt8>>   _datas;
-	Event					    _event;
+	Signal					    _event;
 	SocketAddress				_address;
 };
 
@@ -198,7 +222,7 @@ private:
 
 class UDPEchoServer : public UDPSocket {
 public:
-	UDPEchoServer(const SocketManager& manager) : UDPSocket(manager) {}
+	UDPEchoServer(const SocketManager& manager, UInt16 batch=0) : UDPSocket(manager) { setBatchReception(batch); setBatchSending(batch>0); }
 
 private:
 	
@@ -210,11 +234,19 @@ private:
 		Exception ex;
 		CHECK(send(ex,pBuffer->data(), pBuffer->size(), address) && !ex);
 	}
+
+	void onReception(Packets& packets) {
+		CHECK(!packets.empty() && packets.size() <= 8);
+		for (Packet* pPacket : packets) {
+			Exception ex;
+			CHECK(send(ex,pPacket->pBuffer->data(), pPacket->pBuffer->size(), pPacket->address) && !ex);
+		}
+	}
 };
 
 
 
-static Event TaskEvent;
+static Signal TaskEvent;
 class TaskHandlerSockets : public TaskHandler {
 public:
 	TaskHandlerSockets() {
@@ -247,6 +279,7 @@ static string					Long0Data(9999999, '\0');
 static PoolThreads				Threads;
 static PoolBuffers				Buffers;
 static SocketManager			ParallelSockets(Buffers,Threads);
+static SocketManager			ReactorsSockets(Buffers,Threads,0,"ReactorsSockets",4);
 static TaskHandlerSockets		TaskSockets;
 static SocketManager			Sockets(TaskSockets,Buffers,Threads);
 
@@ -254,19 +287,38 @@ static SocketManager			Sockets(TaskSockets,Buffers,Threads);
 void TCPTest(SocketManager& sockets) {
 	Exception ex;
 
+	string filePath("SocketTest.tmp");
+	string fileData(3000000, '\0');
+	for (UInt32 i = 0; i < fileData.size(); ++i)
+		fileData[i] = i % 251;
+	ofstream(filePath, ios::binary).write(fileData.data(), fileData.size());
+
 	SocketAddress host(IPAddress::Wildcard(),62435);
 	TCPEchoServer server(sockets);
 	CHECK(server.start(ex, host) && !ex);
 	server.stop();
 	CHECK(server.start(ex, host) && !ex);
 
-	TCPEchoClient client(sockets, &sockets == &ParallelSockets);
+	TCPEchoClient client(sockets, &sockets != &Sockets);
 	SocketAddress target(IPAddress::Loopback(),host.port());
 	CHECK(client.connect(ex, target) && !ex && client.connected());
+	// the long data can exceed it meanwhile
+	client.setWatermarks(1000000, 100000);
 
 	CHECK(client.echo(ex,EXPAND_DATA_SIZE("hi mathieu and thomas")) && !ex);
 	CHECK(client.echo(ex,(const UInt8*)Long0Data.c_str(),Long0Data.size()) && !ex);
+	// queued behind the long data, these ones are gathered in one writing
+	for (UInt8 i = 0; i < 20; ++i)
+		CHECK(client.echo(ex,(const UInt8*)Short0Data.c_str(),100+i) && !ex);
+	// file sent from the disk, between memory data
+	CHECK(client.echoFile(ex, filePath, (const UInt8*)fileData.data(), 7, fileData.size() - 7) && !ex);
+	CHECK(client.echo(ex,EXPAND_DATA_SIZE("after file")) && !ex);
 	CHECK(TaskSockets.join(client));
+	CHECK(FileSystem::Remove(filePath));
+	// everything echoed, so the send queue is drained
+	CHECK(client.queueing() == 0 && !client.congested());
+
+	CHECK(server.accepted() == 1 && server.dropped() == 0);
 
 	client.testDisconnection = true;
 
@@ -291,28 +343,49 @@ void TCPTest(SocketManager& sockets) {
 	CHECK(!client.connected());
 }
 
-void UDPTest(SocketManager& sockets) {
+void UDPTest(SocketManager& sockets, UInt16 batch=0) {
 	Exception ex;
 
 	SocketAddress	 host(IPAddress::Wildcard(),62435);
-	UDPEchoServer    server(sockets);
+	UDPEchoServer    server(sockets, batch);
 	CHECK(server.bind(ex, host) && !ex);
 	server.close();
 	CHECK(server.bind(ex, host) && !ex);
 
-	UDPEchoClient    client(sockets,&sockets==&ParallelSockets);
+	UDPEchoClient    client(sockets,&sockets!=&Sockets);
+	client.setBatchReception(batch); // default batch reception, packet by packet
 	SocketAddress	 target(IPAddress::Loopback(),host.port());
 	CHECK(client.connect(ex, target) && !ex);
 
 	CHECK(client.echo(ex,EXPAND_DATA_SIZE("hi mathieu and thomas")) && !ex);
 	CHECK(client.echo(ex,(const UInt8*)Short0Data.c_str(),Short0Data.size()) && !ex);
+	if (batch) {
+		// same sizes first to allow UDP segmentation offload on echo
+		for (UInt8 i = 0; i < 50; ++i)
+			CHECK(client.echo(ex,(const UInt8*)Short0Data.c_str(),i<25 ? 100 : i) && !ex);
+	}
 	CHECK(TaskSockets.join(client));
+
+	if (!batch)
+		return;
+	// statistics are updated after the sending system call, so can be late regarding the reception
+	UInt64 datagrams(0), calls(0);
+	for (UInt8 i = 0; i < 100 && datagrams < 52; ++i) {
+		UInt64 moreDatagrams, moreCalls, moreLatency;
+		server.batchSendingStats(moreDatagrams, moreCalls, moreLatency);
+		datagrams += moreDatagrams;
+		calls += moreCalls;
+		if (datagrams < 52)
+			this_thread::sleep_for(chrono::milliseconds(10));
+	}
+	CHECK(datagrams == 52 && calls>0 && calls <= datagrams);
 }
 
 ADD_TEST(SocketTest, StartSockets) {
 	Exception ex;
 	CHECK(Sockets.start(ex) && !ex && Sockets.running());
 	CHECK(ParallelSockets.start(ex) && !ex && ParallelSockets.running());
+	CHECK(ReactorsSockets.start(ex) && !ex && ReactorsSockets.running() && ReactorsSockets.reactors()==4);
 }
 
 ADD_TEST(SocketTest, TCPSocket) {
@@ -331,10 +404,62 @@ ADD_TEST(SocketTest, UDPParallelSocket) {
 	UDPTest(ParallelSockets);
 }
 
+ADD_TEST(SocketTest, TCPReactorsSocket) {
+	TCPTest(ReactorsSockets);
+}
+
+ADD_TEST(SocketTest, UDPReactorsSocket) {
+	UDPTest(ReactorsSockets);
+}
+
+ADD_TEST(SocketTest, UDPBatchSocket) {
+	UDPTest(Sockets, 8);
+	UDPTest(ParallelSockets, 8);
+}
+
+ADD_TEST(SocketTest, TCPAcceptBudget) {
+	// more connections than TCPServer::ACCEPT_BUDGET in one burst, accepted over several reading events
+	class Server : public TCPServer {
+	public:
+		Server(const SocketManager& manager) : TCPServer(manager), parallel(false), expected(0) {}
+		const bool	parallel;
+		UInt32		expected;
+		bool join() { return accepted() == expected; }
+	private:
+		void onError(const Exception& ex) { FATAL_ERROR("TCPServer, ", ex.error()); }
+		void onConnection(Exception& ex, const SocketAddress& address, SocketFile& file) { CHECK(address && file); }
+	};
+	class Client : public TCPClient {
+	public:
+		Client(const SocketManager& manager) : TCPClient(manager) {}
+	private:
+		UInt32 onReception(PoolBuffer& pBuffer) { return 0; }
+		void onError(const Exception& ex) {}
+	};
+
+	Exception ex;
+	Server server(Sockets);
+	SocketAddress host(IPAddress::Wildcard(), 62436);
+	CHECK(server.start(ex, host, 256) && !ex);
+	SocketAddress target(IPAddress::Loopback(), host.port());
+	list<Client> clients;
+	for (server.expected = 0; server.expected < 200; ++server.expected) {
+		clients.emplace_back(Sockets);
+		CHECK(clients.back().connect(ex, target) && !ex);
+	}
+	CHECK(TaskSockets.join(server));
+	clients.clear();
+	server.stop();
+	// cumulated, not reset by the stop
+	CHECK(server.accepted() == 200 && server.dropped() == 0);
+}
+
 ADD_TEST(SocketTest, StopSockets) {
 	TaskSockets.stop();
 	Sockets.stop();
 	CHECK(!Sockets.running());
 	ParallelSockets.stop();
 	CHECK(!ParallelSockets.running());
+	ReactorsSockets.stop();
+	CHECK(!ReactorsSockets.running());
 }
\ No newline at end of file
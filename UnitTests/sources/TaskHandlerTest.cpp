@@ -0,0 +1,72 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+
+#include "Test.h"
+#include "Mona/TaskHandler.h"
+#include <vector>
+
+using namespace std;
+using namespace Mona;
+
+class TaskHandlerQueue : public TaskHandler {
+public:
+	TaskHandlerQueue(UInt32 capacity) : TaskHandler(capacity), requests(0) { start(); }
+	~TaskHandlerQueue() { stop(); }
+
+	void handle() { Exception ex; giveHandle(ex); CHECK(!ex); }
+
+	UInt32	requests;
+private:
+	void requestHandle() { ++requests; }
+};
+
+class OrderedTask : public Task {
+public:
+	OrderedTask(TaskHandler& handler, vector<UInt32>& handled, UInt32 index) : Task(handler), _handled(handled), _index(index) {}
+private:
+	void handle(Exception& ex) { _handled.emplace_back(_index); }
+	vector<UInt32>&	_handled;
+	UInt32			_index;
+};
+
+
+ADD_TEST(TaskHandlerTest, Deferral) {
+	TaskHandlerQueue handler(2);
+	vector<UInt32> handled;
+	Exception ex;
+	CHECK(handler.postHandle(ex, make_shared<OrderedTask>(handler, handled, 0)) && !ex && handler.requests == 1);
+	CHECK(handler.postHandle(ex, make_shared<OrderedTask>(handler, handled, 1)) && !ex);
+	// full
+	CHECK(!handler.postHandle(ex, make_shared<OrderedTask>(handler, handled, 9)) && !ex);
+	CHECK(handler.postHandle(ex, make_shared<OrderedTask>(handler, handled, 2), true) && !ex);
+	CHECK(handler.deferrals() == 1 && handler.queueSize() == 3 && handler.requests == 2);
+	// stays full for the others until the deferred task is handled, to keep the order
+	CHECK(!handler.postHandle(ex, make_shared<OrderedTask>(handler, handled, 9)) && !ex);
+	CHECK(handler.postHandle(ex, make_shared<OrderedTask>(handler, handled, 3), true) && !ex);
+	CHECK(handler.deferrals() == 2 && handler.queueSize() == 4);
+
+	handler.handle();
+	CHECK(handled.size() == 2 && handled[0] == 0 && handled[1] == 1); // batch limited to the capacity
+	handler.handle();
+	CHECK(handled.size() == 4 && handled[2] == 2 && handled[3] == 3 && handler.queueSize() == 0);
+	CHECK(handler.postHandle(ex, make_shared<OrderedTask>(handler, handled, 4)) && !ex);
+	handler.handle();
+	CHECK(handled.size() == 5 && handled[4] == 4 && handler.deferrals() == 2);
+}
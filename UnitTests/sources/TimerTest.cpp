@@ -0,0 +1,87 @@
+/*
+Copyright 2014 Mona
+mathieu.poux[a]gmail.com
+jammetthomas[a]gmail.com
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or
+(at your option) any later version.
+
+This program is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License received along this program for more
+details (or else see http://www.gnu.org/licenses/).
+
+This file is a part of Mona.
+*/
+
+
+#include "Test.h"
+#include "Mona/Timer.h"
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace Mona;
+
+static void Wait(Timer& timer, UInt32 maxCount = 0) {
+	// raises until the end of timers (or until maxCount timers are running)
+	UInt32 timeout;
+	while ((timeout = timer.raise()) && timer.count() > maxCount)
+		this_thread::sleep_for(chrono::milliseconds(timeout));
+}
+
+ADD_TEST(TimerTest, Expiration) {
+	Timer timer;
+	CHECK(timer.raise() == 0);
+
+	vector<UInt32> raised;
+	Int64 start(Timer::Now());
+	// 300ms and 20000ms are in the upper levels of the wheel, cascaded on expiration
+	Timer::OnTimer onTimer1([&](UInt32 delay) { CHECK(Timer::Now() - start >= 5); raised.emplace_back(1); return 0; });
+	Timer::OnTimer onTimer2([&](UInt32 delay) { CHECK(Timer::Now() - start >= 20); raised.emplace_back(2); return 0; });
+	Timer::OnTimer onTimer3([&](UInt32 delay) { CHECK(Timer::Now() - start >= 300); raised.emplace_back(3); return 0; });
+	Timer::OnTimer onTimer4([&](UInt32 delay) { raised.emplace_back(4); return 0; });
+	timer.set(onTimer3, 300);
+	timer.set(onTimer1, 5);
+	timer.set(onTimer2, 20);
+	timer.set(onTimer4, 20000);
+	CHECK(timer.count() == 4 && onTimer4.running());
+	UInt32 timeout(timer.raise());
+	CHECK(timeout > 0 && timeout <= 5);
+
+	Wait(timer, 1);
+	CHECK(raised.size() == 3 && raised[0] == 1 && raised[1] == 2 && raised[2] == 3);
+	CHECK(!onTimer1.running() && onTimer4.running());
+	timeout = timer.raise();
+	CHECK(timeout > 0 && timeout < 20000);
+	timer.remove(onTimer4);
+	CHECK(timer.count() == 0 && !onTimer4.running() && timer.raise() == 0);
+}
+
+ADD_TEST(TimerTest, Repeat) {
+	Timer timer;
+	UInt32 count(0);
+	Timer::OnTimer onRepeat([&count](UInt32 delay) { return ++count < 5 ? 2 : 0; });
+	timer.set(onRepeat, 2);
+	Wait(timer);
+	CHECK(count == 5 && !onRepeat.running());
+
+	// removing or deleting itself in its callback
+	Timer::OnTimer onRemove([&](UInt32 delay) { timer.remove(onRemove); return 10; });
+	Timer::OnTimer* pOnDelete(NULL);
+	pOnDelete = new Timer::OnTimer([&](UInt32 delay) { delete pOnDelete; return 10; });
+	timer.set(onRemove, 1);
+	timer.set(*pOnDelete, 1);
+	Wait(timer);
+	CHECK(!onRemove.running());
+
+	// a timer deleted before its expiration is removed
+	pOnDelete = new Timer::OnTimer([](UInt32 delay) { return 0; });
+	timer.set(*pOnDelete, 1000);
+	CHECK(timer.count() == 1);
+	delete pOnDelete;
+	CHECK(timer.count() == 0);
+}
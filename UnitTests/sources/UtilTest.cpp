@@ -115,3 +115,24 @@ ADD_TEST(UtilTest, FormatHex) {
 	CHECK(buffer.size()==32 && memcmp(buffer.data(), "\x36\x39\x3C\xB1\x42\x8E\xCC\x17\x8F\xE8\x8D\x37\x09\x4D\x0B\x3D\x34\xB9\x5C\x0E\x98\x51\x77\xE4\x53\x36\x99\x7E\xBE\xAB\x58\xCD", buffer.size()) == 0)
 }
 
+
+ADD_TEST(UtilTest, Processors) {
+	Exception ex;
+	vector<UInt16> processors;
+	CHECK(Util::ParseProcessors(ex, "8, 0-3,2", processors) && !ex);
+	CHECK(processors.size() == 5 && processors.front() == 0 && processors.back() == 8);
+	string value;
+	CHECK(Util::FormatProcessors(processors, value) == "0-3,8");
+
+	CHECK(!Util::ParseProcessors(ex, "3-1", processors) && ex);
+	ex.set(Exception::NIL);
+	CHECK(!Util::ParseProcessors(ex, "a", processors) && ex);
+	ex.set(Exception::NIL);
+
+	// every processor belongs to a NUMA node, or the topology is unknown
+	CHECK(Util::CurrentNode() < Util::NodeCount());
+	if (!Util::ProcessorNodes().empty()) {
+		CHECK(Util::ParseProcessors(ex, "node0", processors) && !ex && !processors.empty());
+	}
+	CHECK(!Util::ParseProcessors(ex, "node999", processors) && ex);
+}